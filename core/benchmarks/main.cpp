@@ -0,0 +1,361 @@
+/*-*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-   */
+/*ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab:*/
+
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+
+  (C) Copyright 2025 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+// Benchmarks of the mtsMaxonEPOS hot paths, using the simulated backend
+// in place of EposCmdLib so only the component's own cost is measured
+// (plus the simulated bus latency, 0 by default):
+//   run_cycle          cost of Run for 1 to 32 axes
+//   command_latency    servo_jp, servo_jv and move_jp, from the client
+//                      function call to the VCS_ call for the first axis
+//   state_table_read   measured_js reads per second with concurrent readers
+// Results are written as JSON, on stdout or in the file given with -o.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <json/json.h>
+
+#include <cisstCommon/cmnLogger.h>
+#include <cisstOSAbstraction/osaSleep.h>
+#include <cisstMultiTask/mtsManagerLocal.h>
+#include <cisstMultiTask/mtsInterfaceRequired.h>
+
+#include <sawMaxonEPOS/mtsMaxonEPOS.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSDriverSimulated.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSDriverTimed.h>
+
+// Gives access to the simulated driver, to timestamp the EPOS calls
+class mtsMaxonEPOSBenchmark : public mtsMaxonEPOS
+{
+public:
+    mtsMaxonEPOSBenchmark(const std::string & name, bool newThread) :
+        mtsMaxonEPOS(name, 1024, newThread)
+    {}
+
+    mtsMaxonEPOSDriverSimulated * Simulator(void) {
+        return mTimedDriver ? dynamic_cast<mtsMaxonEPOSDriverSimulated *>(mTimedDriver->Driver()) : nullptr;
+    }
+};
+
+// Client of the robot interface, commands and readers
+class BenchmarkClient : public mtsComponent
+{
+public:
+    mtsFunctionWrite servo_jp;
+    mtsFunctionWrite servo_jv;
+    mtsFunctionWrite move_jp;
+    mtsFunctionWrite state_command;
+    mtsFunctionRead operating_state;
+    mtsFunctionRead measured_js;
+
+    BenchmarkClient(const std::string & name) : mtsComponent(name)
+    {
+        mtsInterfaceRequired * required = AddInterfaceRequired("Robot");
+        if (required) {
+            required->AddFunction("servo_jp", servo_jp);
+            required->AddFunction("servo_jv", servo_jv);
+            required->AddFunction("move_jp", move_jp);
+            required->AddFunction("state_command", state_command);
+            required->AddFunction("operating_state", operating_state);
+            required->AddFunction("measured_js", measured_js);
+        }
+    }
+};
+
+static double Now(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Count, mean and percentiles, in microseconds
+static Json::Value Statistics(std::vector<double> & samples)
+{
+    Json::Value result;
+    result["count"] = static_cast<Json::UInt64>(samples.size());
+    if (samples.empty()) {
+        return result;
+    }
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        sum += samples[i];
+    }
+    result["mean_us"] = 1.0e6 * sum / static_cast<double>(samples.size());
+    result["p50_us"] = 1.0e6 * samples[samples.size() / 2];
+    result["p99_us"] = 1.0e6 * samples[(samples.size() * 99) / 100];
+    result["max_us"] = 1.0e6 * samples.back();
+    return result;
+}
+
+// Configuration file for a single gateway robot using the simulated backend
+static std::string WriteConfiguration(const std::string & directory, const std::string & name,
+                                      size_t numberOfAxes, double latency)
+{
+    Json::Value config;
+    config["name"] = "benchmark";
+    config["backend"] = "simulated";
+    config["simulated"]["latency"] = latency;
+    config["device_name"] = "EPOS4";
+    config["protocol_stack_name"] = "MAXON SERIAL V2";
+    config["interface_name"] = "USB";
+    config["port_name"] = "USB0";
+    config["timeout"] = 500;
+    config["startup"]["boot_delay"] = 0.0;
+    for (size_t axis = 0; axis < numberOfAxes; ++axis) {
+        config["axes"][static_cast<Json::ArrayIndex>(axis)]["nodeid"] = static_cast<Json::UInt>(axis + 1);
+    }
+    const std::string fileName = directory + "/sawMaxonEPOSBenchmark-" + name + ".json";
+    std::ofstream file(fileName);
+    Json::StreamWriterBuilder builder;
+    file << Json::writeString(builder, config);
+    return fileName;
+}
+
+// Run called directly, no thread nor component manager
+static Json::Value BenchmarkRunCycle(const std::string & directory, size_t numberOfAxes,
+                                     double latency, size_t cycles)
+{
+    const std::string name = "run-" + std::to_string(numberOfAxes);
+    mtsMaxonEPOSBenchmark epos("Benchmark-" + name, false);
+    epos.Configure(WriteConfiguration(directory, name, numberOfAxes, latency));
+    epos.Startup();
+    for (size_t cycle = 0; cycle < cycles / 10; ++cycle) {
+        epos.Run();
+    }
+    std::vector<double> samples(cycles);
+    for (size_t cycle = 0; cycle < cycles; ++cycle) {
+        const double start = Now();
+        epos.Run();
+        samples[cycle] = Now() - start;
+    }
+    epos.Cleanup();
+
+    Json::Value result;
+    result["axes"] = static_cast<Json::UInt>(numberOfAxes);
+    result["cycle"] = Statistics(samples);
+    result["mean_per_axis_us"] = result["cycle"]["mean_us"].asDouble() / static_cast<double>(numberOfAxes);
+    return result;
+}
+
+// Armed by the benchmark before a command, the simulated driver's hook
+// timestamps the first matching call for node 1
+struct CallProbe {
+    std::atomic<const char *> call;
+    std::atomic<double> time;
+};
+
+static Json::Value BenchmarkCommand(CallProbe & probe, const char * call,
+                                    const std::function<void (size_t)> & command, size_t samples)
+{
+    std::vector<double> latencies;
+    latencies.reserve(samples);
+    // first commands include mode changes
+    const size_t warmup = 10;
+    for (size_t sample = 0; sample < samples + warmup; ++sample) {
+        probe.call = call;
+        const double start = Now();
+        command(sample);
+        while ((probe.call.load() != nullptr) && (Now() - start < 1.0)) {
+            std::this_thread::yield();
+        }
+        if (probe.call.load() != nullptr) {
+            probe.call = nullptr;
+            std::cerr << "Benchmark: no " << call << " call received after 1s" << std::endl;
+            continue;
+        }
+        if (sample >= warmup) {
+            latencies.push_back(probe.time.load() - start);
+        }
+        // don't stay in phase with the component's cycles
+        osaSleep(0.0002 * static_cast<double>(sample % 5));
+    }
+    return Statistics(latencies);
+}
+
+int main(int argc, char ** argv)
+{
+    std::string outputFile;
+    std::string directory = ".";
+    double latency = 0.0;
+    double readDuration = 0.5;
+    size_t samples = 1000;
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        if ((option == "-o") && (i + 1 < argc)) {
+            outputFile = argv[++i];
+        } else if ((option == "-d") && (i + 1 < argc)) {
+            directory = argv[++i];
+        } else if ((option == "-l") && (i + 1 < argc)) {
+            latency = std::stod(argv[++i]);
+        } else if ((option == "-n") && (i + 1 < argc)) {
+            samples = std::stoul(argv[++i]);
+        } else if ((option == "-t") && (i + 1 < argc)) {
+            readDuration = std::stod(argv[++i]);
+        } else {
+            std::cout << "Syntax: sawMaxonEPOSBenchmarks [-o <output>] [-d <directory>] [-l <latency>] [-n <samples>] [-t <duration>]" << std::endl
+                      << "        -o <output>     JSON results file, stdout by default" << std::endl
+                      << "        -d <directory>  Directory for the generated configuration files (default .)" << std::endl
+                      << "        -l <latency>    Simulated duration of each EPOS call in seconds (default 0)" << std::endl
+                      << "        -n <samples>    Number of cycles or commands measured (default 1000)" << std::endl
+                      << "        -t <duration>   Duration of each read throughput test in seconds (default 0.5)" << std::endl;
+            return 0;
+        }
+    }
+
+    // errors only, logs would affect the timings
+    cmnLogger::SetMask(CMN_LOG_ALLOW_ERRORS);
+    cmnLogger::SetMaskFunction(CMN_LOG_ALLOW_ERRORS);
+    cmnLogger::SetMaskDefaultLog(CMN_LOG_ALLOW_ERRORS);
+
+    Json::Value results;
+    results["backend"] = "simulated";
+    results["latency_s"] = latency;
+
+    // Run cycle cost
+    const size_t axisCounts[] = { 1, 2, 4, 8, 16, 32 };
+    for (size_t i = 0; i < sizeof(axisCounts) / sizeof(axisCounts[0]); ++i) {
+        results["run_cycle"].append(BenchmarkRunCycle(directory, axisCounts[i], latency, samples));
+    }
+
+    // Commands and reads through the component manager, component running
+    // in its own thread
+    const size_t numberOfAxes = 4;
+    mtsMaxonEPOSBenchmark * epos = new mtsMaxonEPOSBenchmark("Benchmark", true);
+    epos->Configure(WriteConfiguration(directory, "commands", numberOfAxes, latency));
+    CallProbe probe;
+    probe.call = nullptr;
+    probe.time = 0.0;
+    epos->Simulator()->SetFaultHook([&probe](const char * call, unsigned short nodeId) -> unsigned int {
+        const char * armed = probe.call.load();
+        if (armed && (nodeId == 1) && (std::strcmp(call, armed) == 0)) {
+            probe.time = Now();
+            probe.call = nullptr;
+        }
+        return 0;
+    });
+
+    const size_t readerCounts[] = { 1, 2, 4, 8, 16 };
+    const size_t maxReaders = 16;
+    std::vector<BenchmarkClient *> clients;
+    mtsComponentManager * componentManager = mtsComponentManager::GetInstance();
+    componentManager->AddComponent(epos);
+    for (size_t i = 0; i < maxReaders; ++i) {
+        clients.push_back(new BenchmarkClient("BenchmarkClient" + std::to_string(i)));
+        componentManager->AddComponent(clients[i]);
+        if (!componentManager->Connect(clients[i]->GetName(), "Robot", epos->GetName(), "benchmark")) {
+            std::cerr << "Failed to connect " << clients[i]->GetName() << " to " << epos->GetName() << std::endl;
+            return -1;
+        }
+    }
+    componentManager->CreateAll();
+    componentManager->WaitForStateAll(mtsComponentState::READY, 2.0 * cmn_s);
+    componentManager->StartAll();
+    componentManager->WaitForStateAll(mtsComponentState::ACTIVE, 2.0 * cmn_s);
+
+    // Enable
+    BenchmarkClient & client = *clients[0];
+    client.state_command(std::string("enable"));
+    prmOperatingState operatingState;
+    const double enableStart = Now();
+    do {
+        osaSleep(0.001);
+        client.operating_state(operatingState);
+    } while ((operatingState.State() != prmOperatingState::ENABLED) && (Now() - enableStart < 2.0));
+    if (operatingState.State() != prmOperatingState::ENABLED) {
+        std::cerr << "Benchmark: robot not enabled after 2s" << std::endl;
+    }
+
+    // Command latency, setpoints change at each command so none is skipped
+    prmPositionJointSet position;
+    position.Goal().SetSize(numberOfAxes);
+    prmVelocityJointSet velocity;
+    velocity.SetSize(numberOfAxes);
+    results["command_latency"]["servo_jp"] = BenchmarkCommand(probe, "SetPositionMust", [&](size_t sample) {
+            position.Goal().SetAll(static_cast<double>(sample % 1000));
+            client.servo_jp(position);
+        }, samples);
+    results["command_latency"]["servo_jv"] = BenchmarkCommand(probe, "SetVelocityMust", [&](size_t sample) {
+            velocity.Goal().SetAll(static_cast<double>(sample % 1000));
+            client.servo_jv(velocity);
+        }, samples);
+    results["command_latency"]["move_jp"] = BenchmarkCommand(probe, "MoveToPosition", [&](size_t sample) {
+            position.Goal().SetAll(static_cast<double>(sample % 1000));
+            client.move_jp(position);
+        }, samples);
+    client.state_command(std::string("disable"));
+
+    // State table reads, each reader has its own connection
+    for (size_t i = 0; i < sizeof(readerCounts) / sizeof(readerCounts[0]); ++i) {
+        const size_t numberOfReaders = readerCounts[i];
+        std::atomic<bool> stop(false);
+        std::vector<unsigned long long> reads(numberOfReaders, 0);
+        std::vector<std::thread> threads;
+        for (size_t reader = 0; reader < numberOfReaders; ++reader) {
+            threads.push_back(std::thread([&, reader]() {
+                prmStateJoint measured;
+                unsigned long long count = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    clients[reader]->measured_js(measured);
+                    count++;
+                }
+                reads[reader] = count;
+            }));
+        }
+        osaSleep(readDuration);
+        stop = true;
+        unsigned long long total = 0;
+        for (size_t reader = 0; reader < numberOfReaders; ++reader) {
+            threads[reader].join();
+            total += reads[reader];
+        }
+        Json::Value result;
+        result["readers"] = static_cast<Json::UInt>(numberOfReaders);
+        result["reads_per_second"] = static_cast<double>(total) / readDuration;
+        result["reads_per_second_per_reader"] = static_cast<double>(total) / readDuration
+            / static_cast<double>(numberOfReaders);
+        results["state_table_read"].append(result);
+    }
+
+    componentManager->KillAll();
+    componentManager->WaitForStateAll(mtsComponentState::FINISHED, 2.0 * cmn_s);
+    componentManager->Cleanup();
+    cmnLogger::SetMask(CMN_LOG_ALLOW_NONE);
+
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "    ";
+    if (outputFile.empty()) {
+        std::cout << Json::writeString(builder, results) << std::endl;
+    } else {
+        std::ofstream file(outputFile);
+        file << Json::writeString(builder, results) << std::endl;
+    }
+
+    for (size_t i = 0; i < clients.size(); ++i) {
+        delete clients[i];
+    }
+    delete epos;
+    return 0;
+}
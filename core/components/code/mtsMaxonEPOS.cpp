@@ -8,72 +8,213 @@ This software is provided "as is" under an open source license, with no warranty
 --- end cisst license ---
 */
 
-#include "Definitions.h"  // EPOS Command Library
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+
 #include <cisstCommon/cmnPath.h>
 #include <cisstCommon/cmnAssert.h>
 #include <cisstCommon/cmnPortability.h>
+#include <cisstCommon/cmnTypeTraits.h>
 #include <cisstOSAbstraction/osaSleep.h>
 #include <sawMaxonEPOS/mtsMaxonEPOS.h>
-
-#if (CISST_OS == CISST_WINDOWS)
-#define DWORD_CAST(A) (reinterpret_cast<DWORD *>(A))
-#else
-#define DWORD_CAST(A) (A)
-#endif
+#include <sawMaxonEPOS/mtsMaxonEPOSDriver.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSDriverRecorder.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSDriverTimed.h>
 
 enum OP_STATES { ST_PPM, ST_PVM, ST_PM, ST_VM, ST_CM, ST_HM, ST_MEM, ST_SDM, ST_IPM };
 
+// servo_cp warm starts the inverse kinematics if the last solve is more recent (s)
+static const double IKWarmStartPeriod = 0.1;
+
+// Objects that can be mapped in the feedback TxPDO
+struct PDOSignal {
+    const char     *name;
+    unsigned short  index;
+    unsigned char   subIndex;
+    unsigned char   bits;
+};
+static const PDOSignal PDOSignals[] = {
+    { "statusword", 0x6041, 0x00, 16 },
+    { "position",   0x6064, 0x00, 32 },
+    { "current",    0x6078, 0x00, 16 }
+};
+
+// Same values as VCS_GetState (disabled, enabled, quickstop, fault)
+static unsigned short StatuswordToState(unsigned short statusword)
+{
+    if (statusword & 0x0008) {          // fault
+        return 3;
+    }
+    if (statusword & 0x0004) {          // operation enabled
+        return (statusword & 0x0020) ? 1 : 2;   // quick stop is active low
+    }
+    return 0;
+}
+
 CMN_IMPLEMENT_SERVICES_DERIVED_ONEARG(mtsMaxonEPOS, mtsTaskContinuous, mtsTaskContinuousConstructorArg);
 
 mtsMaxonEPOS::mtsMaxonEPOS(const std::string &name) :
-    mtsTaskContinuous(name, 1024, true)
+    mtsTaskContinuous(name, 1024, true),
+    mDriver(nullptr),
+    mTimedDriver(nullptr),
+    mPollingTime(0.0),
+    mPollingWaitTime(0.0)
 {}
 
 mtsMaxonEPOS::mtsMaxonEPOS(const std::string &name, unsigned int sizeStateTable, bool newThread) :
-    mtsTaskContinuous(name, sizeStateTable, newThread)
+    mtsTaskContinuous(name, sizeStateTable, newThread),
+    mDriver(nullptr),
+    mTimedDriver(nullptr),
+    mPollingTime(0.0),
+    mPollingWaitTime(0.0)
 {}
 
 mtsMaxonEPOS::mtsMaxonEPOS(const mtsTaskContinuousConstructorArg & arg) :
-    mtsTaskContinuous(arg)
+    mtsTaskContinuous(arg),
+    mDriver(nullptr),
+    mTimedDriver(nullptr),
+    mPollingTime(0.0),
+    mPollingWaitTime(0.0)
 {}
 
 mtsMaxonEPOS::~mtsMaxonEPOS()
 {
     Close();
+    for (size_t index = 0; index < mRobots.size(); ++index) {
+        delete mRobots[index];
+    }
+    delete mDriver;
 }
 
-void mtsMaxonEPOS::Cleanup(){}
+void mtsMaxonEPOS::Cleanup()
+{
+    mPoller.Stop();
+    mFlightRecorder.Stop();
+    for (size_t index = 0; index < mRobots.size(); ++index) {
+        mRobots[index]->mDataRecorder.Stop();
+    }
+}
 
-void mtsMaxonEPOS::SetupInterfaces(void)
+void mtsMaxonEPOS::SetupInterfaces(RobotData & robot)
 {
-    StateTable.AddData(mRobot.m_measured_js, "measured_js");
-    StateTable.AddData(mRobot.m_setpoint_js, "setpoint_js");
-    StateTable.AddData(mRobot.mActuatorState, "actuator_state");
-    StateTable.AddData(mRobot.mErrorCode, "error_code");
-    mRobot.m_op_state.SetValid(true);
-    StateTable.AddData(mRobot.m_op_state, "op_state");
+    StateTable.AddData(robot.m_measured_js, robot.name + "_measured_js");
+    StateTable.AddData(robot.m_setpoint_js, robot.name + "_setpoint_js");
+    if (robot.mKinematics.IsEnabled()) {
+        StateTable.AddData(robot.m_measured_cp, robot.name + "_measured_cp");
+        StateTable.AddData(robot.mIKStatistics, robot.name + "_ik_statistics");
+    }
+    StateTable.AddData(robot.mActuatorState, robot.name + "_actuator_state");
+    StateTable.AddData(robot.mErrorCode, robot.name + "_error_code");
+    robot.m_op_state.SetValid(true);
+    StateTable.AddData(robot.m_op_state, robot.name + "_op_state");
+    StateTable.AddData(robot.mFeedbackAge, robot.name + "_feedback_age");
+    StateTable.AddData(robot.mPositionTimes, robot.name + "_position_times");
+    if (robot.mAlignment != RobotData::ALIGN_NONE) {
+        StateTable.AddData(robot.m_measured_js_aligned, robot.name + "_measured_js_aligned");
+        StateTable.AddData(robot.mAlignedTime, robot.name + "_aligned_time");
+    }
+    StateTable.AddData(robot.mIpmBufferFill, robot.name + "_ipm_buffer_fill");
+    StateTable.AddData(robot.mIpmQueueCount, robot.name + "_ipm_queue_fill");
+    StateTable.AddData(robot.mIpmUnderflows, robot.name + "_ipm_underflows");
+    StateTable.AddData(robot.mPlaybackTime, robot.name + "_playback_time");
+    StateTable.AddData(robot.mServoDropped, robot.name + "_servo_dropped");
+    StateTable.AddData(robot.mServoSkipped, robot.name + "_servo_skipped");
+    StateTable.AddData(robot.mErrorCounters, robot.name + "_error_counters");
+    StateTable.AddData(robot.mProfile, robot.name + "_profile");
+    StateTable.AddData(robot.mMoveStartTimes, robot.name + "_move_start_times");
+    StateTable.AddData(robot.mMoveSkew, robot.name + "_move_skew");
     
-    mtsInterfaceProvided *prov = AddInterfaceProvided(mRobot.name);
-    mRobot.mInterface = prov;
+    mtsInterfaceProvided *prov = AddInterfaceProvided(robot.name);
+    robot.mInterface = prov;
     if (prov) {
         prov->AddMessageEvents();
-        prov->AddCommandReadState(this->StateTable, mRobot.m_measured_js, "measured_js");
-        prov->AddCommandReadState(this->StateTable, mRobot.m_setpoint_js, "setpoint_js");
-        prov->AddCommandReadState(this->StateTable, mRobot.m_op_state, "operating_state");
-        prov->AddCommandReadState(this->StateTable, mRobot.mActuatorState, "GetActuatorState");
-
-        prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::servo_jp, &mRobot, "servo_jp");
-        prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::move_jp,  &mRobot, "move_jp");
-        prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::servo_jv, &mRobot, "servo_jv");
-
-        prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::state_command, &mRobot, "state_command", std::string(""));
-        prov->AddEventWrite(mRobot.operating_state, "operating_state", prmOperatingState());
-
-        // prov->AddCommandVoid(&mtsMaxonEPOS::RobotData::EnableMotorPower,  &mRobot, "EnableMotorPower");
-        // prov->AddCommandVoid(&mtsMaxonEPOS::RobotData::DisableMotorPower, &mRobot, "DisableMotorPower");
-        prov->AddCommandVoid(&mtsMaxonEPOS::RobotData::hold,     &mRobot, "hold");
+        prov->AddCommandReadState(this->StateTable, robot.m_measured_js, "measured_js");
+        prov->AddCommandReadState(this->StateTable, robot.m_setpoint_js, "setpoint_js");
+        if (robot.mKinematics.IsEnabled()) {
+            prov->AddCommandReadState(this->StateTable, robot.m_measured_cp, "measured_cp");
+        }
+        prov->AddCommandReadState(this->StateTable, robot.m_op_state, "operating_state");
+        prov->AddCommandReadState(this->StateTable, robot.mActuatorState, "GetActuatorState");
+
+        prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::servo_jp, &robot, "servo_jp");
+        prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::move_jp,  &robot, "move_jp");
+        prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::interpolate_jp, &robot, "interpolate_jp");
+        if (robot.mKinematics.IsEnabled()) {
+            prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::servo_cp, &robot, "servo_cp");
+            prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::move_cp,  &robot, "move_cp");
+            prov->AddCommandReadState(StateTable, robot.mIKStatistics, "ik_statistics");
+            prov->AddCommandVoid(&mtsMaxonEPOS::RobotData::ResetIKStatistics, &robot, "reset_ik_statistics");
+        }
+        prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::configure_profile, &robot, "configure_profile");
+        prov->AddCommandReadState(StateTable, robot.mProfile, "profile");
+        prov->AddCommandReadState(StateTable, robot.mMoveStartTimes, "move_start_times");
+        prov->AddCommandReadState(StateTable, robot.mMoveSkew, "move_skew");
+        prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::servo_jv, &robot, "servo_jv");
+        prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::servo_jf, &robot, "servo_jf");
+        prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::ipm_add_points, &robot, "ipm_add_points");
+        prov->AddCommandVoid(&mtsMaxonEPOS::RobotData::ipm_stop, &robot, "ipm_stop");
+        prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::playback_load, &robot, "playback_load", std::string(""));
+        prov->AddCommandVoid(&mtsMaxonEPOS::RobotData::playback_play, &robot, "playback_play");
+        prov->AddCommandVoid(&mtsMaxonEPOS::RobotData::playback_pause, &robot, "playback_pause");
+        prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::playback_seek, &robot, "playback_seek", 0.0);
+        prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::playback_rate, &robot, "playback_rate", 1.0);
+        prov->AddEventWrite(robot.playback_progress, "playback_progress", 0.0);
+        prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::data_recorder_configure, &robot, "data_recorder_configure",
+                              std::string(""));
+        prov->AddCommandVoid(&mtsMaxonEPOS::RobotData::data_recorder_start, &robot, "data_recorder_start");
+        prov->AddCommandVoid(&mtsMaxonEPOS::RobotData::data_recorder_trigger, &robot, "data_recorder_trigger");
+        prov->AddCommandVoid(&mtsMaxonEPOS::RobotData::data_recorder_stop, &robot, "data_recorder_stop");
+        prov->AddCommandRead(&mtsMaxonEPOS::RobotData::GetDataRecorderData, &robot, "data_recorder_data",
+                             vctDoubleMat());
+        prov->AddCommandRead(&mtsMaxonEPOS::RobotData::GetDataRecorderColumns, &robot, "data_recorder_columns",
+                             std::vector<std::string>());
+        prov->AddCommandRead(&mtsMaxonEPOS::RobotData::GetDataRecorderState, &robot, "data_recorder_state",
+                             std::string(""));
+        prov->AddEventWrite(robot.data_recorder_uploaded, "data_recorder_uploaded", vctDoubleMat());
+
+        prov->AddCommandWrite(&mtsMaxonEPOS::RobotData::state_command, &robot, "state_command", std::string(""));
+        prov->AddEventWrite(robot.operating_state, "operating_state", prmOperatingState());
+
+        // prov->AddCommandVoid(&mtsMaxonEPOS::RobotData::EnableMotorPower,  &robot, "EnableMotorPower");
+        // prov->AddCommandVoid(&mtsMaxonEPOS::RobotData::DisableMotorPower, &robot, "DisableMotorPower");
+        prov->AddCommandVoid(&mtsMaxonEPOS::RobotData::hold,     &robot, "hold");
 
         prov->AddCommandReadState(StateTable, StateTable.PeriodStats, "period_statistics");
+        prov->AddCommandReadState(StateTable, mRealTime.JitterHistogram(), "jitter_histogram");
+        prov->AddCommandReadState(StateTable, mRealTime.Jitter(), "jitter");
+        prov->AddCommandReadState(StateTable, mRealTime.MaxJitter(), "max_jitter");
+        prov->AddCommandReadState(StateTable, mRealTime.Overruns(), "overruns");
+        prov->AddCommandVoid(&mtsMaxonEPOSRealTime::Reset, &mRealTime, "reset_jitter_statistics");
+        prov->AddCommandRead(&mtsMaxonEPOS::GetLatencyStatistics, this, "latency_statistics", vctDoubleMat());
+        prov->AddCommandRead(&mtsMaxonEPOS::GetLatencyStatisticsNames, this, "latency_statistics_names",
+                             std::vector<std::string>());
+        prov->AddCommandVoid(&mtsMaxonEPOS::ResetLatencyStatistics, this, "reset_latency_statistics");
+        prov->AddCommandReadState(StateTable, robot.mErrorCounters, "error_counters");
+        prov->AddCommandVoid(&mtsMaxonEPOS::RobotData::ResetErrorCounters, &robot, "reset_error_counters");
+        prov->AddCommandVoid(&mtsMaxonEPOS::DumpFlightRecorder, this, "dump_flight_recorder");
+        prov->AddCommandRead(&mtsMaxonEPOS::GetStartupTimes, this, "startup_times", vctDoubleVec());
+        prov->AddCommandRead(&mtsMaxonEPOS::GetStartupPhases, this, "startup_phases",
+                             std::vector<std::string>());
+        prov->AddCommandRead(&mtsMaxonEPOS::RobotData::GetStaticParameters, &robot, "static_parameters",
+                             vctDoubleMat());
+        prov->AddCommandRead(&mtsMaxonEPOS::GetStaticParameterNames, this, "static_parameter_names",
+                             std::vector<std::string>());
+        prov->AddCommandReadState(StateTable, mPollingTime, "polling_time");
+        prov->AddCommandReadState(StateTable, mPollingWaitTime, "polling_wait_time");
+        prov->AddCommandReadState(StateTable, robot.mFeedbackAge, "feedback_age");
+        prov->AddCommandReadState(StateTable, robot.mPositionTimes, "position_times");
+        if (robot.mAlignment != RobotData::ALIGN_NONE) {
+            prov->AddCommandReadState(StateTable, robot.m_measured_js_aligned, "measured_js_aligned");
+            prov->AddCommandReadState(StateTable, robot.mAlignedTime, "aligned_time");
+        }
+        prov->AddCommandReadState(StateTable, robot.mIpmBufferFill, "ipm_buffer_fill");
+        prov->AddCommandReadState(StateTable, robot.mIpmQueueCount, "ipm_queue_fill");
+        prov->AddCommandReadState(StateTable, robot.mIpmUnderflows, "ipm_underflows");
+        prov->AddCommandReadState(StateTable, robot.mPlaybackTime, "playback_time");
+        prov->AddCommandReadState(StateTable, robot.mServoDropped, "servo_dropped");
+        prov->AddCommandReadState(StateTable, robot.mServoSkipped, "servo_skipped");
         
     }
 }
@@ -107,179 +248,927 @@ void mtsMaxonEPOS::Configure(const std::string& fileName)
         exit(EXIT_FAILURE);
     }
 
-    mRobot.name = jsonConfig["name"].asString();
-    mRobot.deviceName = jsonConfig["device_name"].asString();
-    mRobot.protocolStackName = jsonConfig["protocol_stack_name"].asString();
-    mRobot.interfaceName = jsonConfig["interface_name"].asString();
-    mRobot.portName = jsonConfig["port_name"].asString();
-    mRobot.mTimeout = jsonConfig["timeout"].asUInt();
+    // EPOS driver backend ("EposCmdLib" by default, "simulated" or "replay")
+    mDriver = mtsMaxonEPOSDriver::Create(jsonConfig);
+    if (!mDriver) {
+        CMN_LOG_CLASS_INIT_ERROR << "Configure: failed to create driver backend \""
+                                 << jsonConfig.get("backend", "EposCmdLib").asString() << "\"" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    CMN_LOG_CLASS_INIT_VERBOSE << "Configure: using driver backend " << mDriver->GetBackendName() << std::endl;
+
+    // Record all driver calls, to replay them later with the "replay" backend
+    const Json::Value jsonRecord = jsonConfig["record"];
+    if (!jsonRecord.isNull()) {
+        mtsMaxonEPOSDriverRecorder * recorder = new mtsMaxonEPOSDriverRecorder(mDriver);
+        mDriver = recorder;
+        std::string error;
+        if (!jsonRecord.isString() || !recorder->Open(jsonRecord.asString(), error)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: \"record\" must be a writable file name, " << error << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        CMN_LOG_CLASS_INIT_VERBOSE << "Configure: recording driver calls to " << jsonRecord.asString() << std::endl;
+    }
+
+    // Polling of the axes in Run: "serial" (default), or concurrent with
+    // one thread per sub-device handle ("handle") or per gateway ("gateway")
+    mPollingMode = jsonConfig.get("polling", "serial").asString();
+    if ((mPollingMode != "serial") && (mPollingMode != "handle") && (mPollingMode != "gateway")) {
+        CMN_LOG_CLASS_INIT_ERROR << "Configure: invalid polling \"" << mPollingMode
+                                 << "\", must be one of serial, handle or gateway" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Gateways, defaults to a single gateway defined at the top level
+    Json::Value jsonGateways = jsonConfig["gateways"];
+    if (jsonGateways.isNull()) {
+        jsonGateways.append(jsonConfig);
+    }
+    mGateways.resize(jsonGateways.size());
+    for (Json::ArrayIndex index = 0; index < jsonGateways.size(); ++index) {
+        const Json::Value jsonGateway = jsonGateways[index];
+        GatewayData & gateway = mGateways[index];
+        gateway.name = jsonGateway.get("name", std::to_string(index)).asString();
+        gateway.deviceName = jsonGateway["device_name"].asString();
+        gateway.protocolStackName = jsonGateway["protocol_stack_name"].asString();
+        gateway.interfaceName = jsonGateway["interface_name"].asString();
+        gateway.portName = jsonGateway["port_name"].asString();
+        gateway.timeout = jsonGateway["timeout"].asUInt();
+        gateway.baudrate = 0;
+        gateway.handle = nullptr;
+        gateway.sendSync = false;
+        gateway.syncPending = false;
+        gateway.syncTime = 0.0;
+    }
+
+    // Static object dictionary parameters, read at startup
+    const Json::Value jsonObjectDictionary = jsonConfig["object_dictionary"];
+    mObjectDictionaryCacheFile = jsonObjectDictionary.get("cache_file", "").asString();
+    Json::Value jsonStaticObjects = jsonObjectDictionary["static"];
+    if (jsonStaticObjects.isNull()) {
+        // CiA 402 objects available on all EPOS
+        const char * defaults[][2] = { { "max_following_error", "0x6065" },
+                                       { "max_profile_velocity", "0x607F" },
+                                       { "motor_type", "0x6402" } };
+        for (size_t index = 0; index < sizeof(defaults) / sizeof(defaults[0]); ++index) {
+            Json::Value jsonObject;
+            jsonObject["name"] = defaults[index][0];
+            jsonObject["index"] = defaults[index][1];
+            jsonObject["size"] = (index == 2) ? 2 : 4;
+            jsonStaticObjects.append(jsonObject);
+        }
+    }
+    mStaticObjects.resize(jsonStaticObjects.size());
+    for (Json::ArrayIndex index = 0; index < jsonStaticObjects.size(); ++index) {
+        std::string error;
+        if (!mtsMaxonEPOSObjectDictionary::ObjectFromJSON(jsonStaticObjects[index], mStaticObjects[index], error)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: invalid object_dictionary static object " << index
+                                     << ", " << error << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Robots, defaults to a single robot defined at the top level.  Robot
+    // settings not defined in the robot are taken from the top level.
+    Json::Value jsonRobots = jsonConfig["robots"];
+    if (jsonRobots.isNull()) {
+        jsonRobots.append(jsonConfig);
+    }
+    size_t numberOfAxes = 0;
+    for (Json::ArrayIndex index = 0; index < jsonRobots.size(); ++index) {
+        Json::Value jsonRobot = jsonConfig;
+        jsonRobot.removeMember("robots");
+        jsonRobot.removeMember("gateways");
+        const std::vector<std::string> keys = jsonRobots[index].getMemberNames();
+        for (size_t key = 0; key < keys.size(); ++key) {
+            jsonRobot[keys[key]] = jsonRobots[index][keys[key]];
+        }
+        RobotData * robot = new RobotData;
+        mRobots.push_back(robot);
+        robot->mFirstAxis = numberOfAxes;
+        ConfigureRobot(*robot, jsonRobot);
+        for (size_t axis = 0; axis < robot->mNumAxes; ++axis) {
+            AxisReference reference;
+            reference.robot = robot;
+            reference.axis = axis;
+            mAxes.push_back(reference);
+        }
+        numberOfAxes += robot->mNumAxes;
+    }
+
+    // Latency of all calls, per axis of all robots
+    mTimedDriver = new mtsMaxonEPOSDriverTimed(mDriver, numberOfAxes);
+    mDriver = mTimedDriver;
+    for (size_t index = 0; index < mRobots.size(); ++index) {
+        mRobots[index]->mDriver = mDriver;
+    }
+    mObjectDictionary.Configure(mDriver, numberOfAxes);
+
+    // Periodic execution, only if "real_time" is defined; Run is called
+    // continuously otherwise
+    const Json::Value jsonRealTime = jsonConfig["real_time"];
+    if (!jsonRealTime.isNull()) {
+        const double rate = jsonRealTime.get("rate", 0.0).asDouble();
+        const int priority = jsonRealTime.get("priority", 0).asInt();
+        if ((rate < 0.0) || (priority < 0) || (priority > 99)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: invalid real_time, rate must be positive (Hz) and priority between 0 and 99"
+                                     << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        mRealTime.Configure((rate > 0.0) ? (1.0 / rate) : 0.0,
+                            priority,
+                            jsonRealTime.get("cpu", -1).asInt(),
+                            jsonRealTime.get("lock_memory", false).asBool(),
+                            jsonRealTime.get("jitter_bucket", 10.0e-6).asDouble(),
+                            jsonRealTime.get("jitter_buckets", 100).asUInt());
+    } else {
+        mRealTime.Configure(0.0, 0, -1, false, 10.0e-6, 100);
+    }
+
+    // Startup sequence
+    const Json::Value jsonStartup = jsonConfig["startup"];
+    mStartupResetNodes = jsonStartup.get("reset_nodes", true).asBool();
+    mStartupBootDelay = jsonStartup.get("boot_delay", 0.02).asDouble();
+    mStartupTimeout = jsonStartup.get("timeout", 2.0).asDouble();
+    mStartupPollPeriod = jsonStartup.get("poll_period", 0.005).asDouble();
+
+    // Flight recorder, only if "flight_recorder" is defined
+    const Json::Value jsonRecorder = jsonConfig["flight_recorder"];
+    if (!jsonRecorder.isNull()) {
+        const unsigned int capacity = jsonRecorder.get("capacity", 10000).asUInt();
+        const double duration = jsonRecorder.get("duration", 5.0).asDouble();
+        mFlightRecorderDirectory = jsonRecorder.get("directory", ".").asString();
+        mFlightRecorder.Configure(numberOfAxes, capacity, duration);
+        mFlightRecorderAxes.resize(numberOfAxes);
+        CMN_LOG_CLASS_INIT_VERBOSE << "Configure: flight recorder using " << capacity << " samples, saving last "
+                                   << duration << "s in " << mFlightRecorderDirectory << std::endl;
+    }
+
+    StateTable.AddData(mPollingTime, "polling_time");
+    StateTable.AddData(mPollingWaitTime, "polling_wait_time");
+    StateTable.AddData(mRealTime.JitterHistogram(), "jitter_histogram");
+    StateTable.AddData(mRealTime.Jitter(), "jitter");
+    StateTable.AddData(mRealTime.MaxJitter(), "max_jitter");
+    StateTable.AddData(mRealTime.Overruns(), "overruns");
+    for (size_t index = 0; index < mRobots.size(); ++index) {
+        SetupInterfaces(*mRobots[index]);
+    }
+}
 
-    mRobot.mParent = this;
+void mtsMaxonEPOS::ConfigureRobot(RobotData & robot, const Json::Value & jsonConfig)
+{
+    robot.name = jsonConfig["name"].asString();
+    robot.mParent = this;
     // Size of array determines number of axes
     size_t numAxes = jsonConfig["axes"].size();
-    CMN_LOG_CLASS_INIT_VERBOSE << "Configure: robot " << mRobot.name
+    CMN_LOG_CLASS_INIT_VERBOSE << "Configure: robot " << robot.name
                                 << " has " << numAxes << " axes" << std::endl;
-    mRobot.mNumAxes = static_cast<unsigned int>(numAxes);
-
-    // We have position and velocity for measured_js
-    mRobot.m_measured_js.Name().resize(numAxes);
-    mRobot.m_measured_js.Position().SetSize(numAxes);
-    mRobot.m_measured_js.Velocity().SetSize(numAxes);
-    mRobot.m_measured_js.Position().SetAll(0.0);
-    mRobot.m_measured_js.Velocity().SetAll(0.0);
+    robot.mNumAxes = static_cast<unsigned int>(numAxes);
+
+    // We have position, velocity (estimated) and effort (current) for measured_js
+    robot.m_measured_js.Name().resize(numAxes);
+    robot.m_measured_js.Position().SetSize(numAxes);
+    robot.m_measured_js.Velocity().SetSize(numAxes);
+    robot.m_measured_js.Effort().SetSize(numAxes);
+    robot.m_measured_js.Position().SetAll(0.0);
+    robot.m_measured_js.Velocity().SetAll(0.0);
+    robot.m_measured_js.Effort().SetAll(0.0);
     // We have position and effort for setpoint_js
-    mRobot.m_setpoint_js.Name().resize(numAxes);
-    mRobot.m_setpoint_js.Position().SetSize(numAxes);
-    mRobot.m_setpoint_js.Effort().SetSize(numAxes);
-    mRobot.m_setpoint_js.Position().SetAll(0.0);
-    mRobot.m_setpoint_js.Effort().SetAll(0.0);
+    robot.m_setpoint_js.Name().resize(numAxes);
+    robot.m_setpoint_js.Position().SetSize(numAxes);
+    robot.m_setpoint_js.Effort().SetSize(numAxes);
+    robot.m_setpoint_js.Position().SetAll(0.0);
+    robot.m_setpoint_js.Effort().SetAll(0.0);
+
+    robot.mActuatorState.SetSize(static_cast<prmActuatorState::size_type>(numAxes));
+    robot.mActuatorState.Position().SetAll(0.0);
+    robot.mActuatorState.Velocity().SetAll(0.0);
+    robot.mActuatorState.Effort().SetAll(0.0);
+
+    robot.mAxisToNodeIDMap.SetSize(numAxes);
+
+    robot.offset_js.SetSize(numAxes);
+    robot.offset_js.SetAll(0.0);
+
+    robot.mState.SetSize(numAxes);
+    robot.mState.SetAll(ST_PPM);
+
+    robot.mProfile.SetSize(numAxes, RobotData::NUMBER_OF_PROFILE_PARAMETERS);
+    robot.mProfile.SetAll(0.0);
+    robot.mStaticParameters.SetSize(numAxes, mStaticObjects.size());
+    robot.mStaticParameters.SetAll(cmnTypeTraits<double>::NaN());
+
+    // Interpolated position mode streaming, all parameters optional
+    const Json::Value jsonIpm = jsonConfig["ipm"];
+    const unsigned int ipmQueueSize = jsonIpm.get("queue_size", 1024).asUInt();
+    robot.mIpmStartLevel = jsonIpm.get("start_level", 4).asUInt();
+    robot.mIpmUnderflowWarningLimit = static_cast<unsigned short>(jsonIpm.get("underflow_warning", 4).asUInt());
+    if (ipmQueueSize == 0) {
+        CMN_LOG_CLASS_INIT_ERROR << "Configure: ipm queue_size must be greater than 0" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    robot.mIpmQueue.SetSize(ipmQueueSize, 1 + 2 * numAxes);
+    robot.mIpmQueueHead = 0;
+    robot.mIpmQueueCount = 0;
+    robot.mIpmMaxBufferSize = 0;
+    robot.mIpmStarted = false;
+    robot.mIpmBufferFill.SetSize(numAxes);
+    robot.mIpmBufferFill.SetAll(0);
+    robot.mIpmUnderflows.SetSize(numAxes);
+    robot.mIpmUnderflows.SetAll(0);
+
+    // Servo commands: coalescing and deadbands (quadcounts for servo_jp, rpm
+    // for servo_jv, mA for servo_jf), a negative deadband always sends the setpoints
+    const Json::Value jsonServo = jsonConfig["servo"];
+    robot.mServoCoalesce = jsonServo.get("coalesce", false).asBool();
+    robot.mServoPositionDeadband = jsonServo.get("position_deadband", 0).asInt();
+    robot.mServoVelocityDeadband = jsonServo.get("velocity_deadband", 0).asInt();
+    robot.mServoCurrentDeadband = jsonServo.get("current_deadband", 0).asInt();
+    robot.mServoPending = RobotData::SERVO_NONE;
+    robot.mServoPendingGoal.SetSize(numAxes);
+    robot.mServoSent.SetSize(numAxes);
+    robot.mServoSentValid.SetSize(numAxes);
+    robot.mServoSentValid.SetAll(false);
+    robot.mServoDropped = 0;
+    robot.mServoSkipped.SetSize(numAxes);
+    robot.mServoSkipped.SetAll(0);
+
+    // move_jp synchronization, "none" (default), "controlword" or "sync"
+    const Json::Value jsonMove = jsonConfig["move"];
+    const std::string synchronization = jsonMove.get("synchronization", "none").asString();
+    if (synchronization == "none") {
+        robot.mMoveSynchronization = RobotData::MOVE_SYNC_NONE;
+    } else if (synchronization == "controlword") {
+        robot.mMoveSynchronization = RobotData::MOVE_SYNC_CONTROLWORD;
+    } else if (synchronization == "sync") {
+        robot.mMoveSynchronization = RobotData::MOVE_SYNC_SYNC;
+    } else {
+        CMN_LOG_CLASS_INIT_ERROR << "Configure: invalid move synchronization \"" << synchronization
+                                 << "\", must be none, controlword or sync" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    robot.mMoveRxPDO = static_cast<unsigned short>(jsonMove.get("rx_pdo", 4).asUInt());
+    robot.mMoveCobId = static_cast<unsigned short>(jsonMove.get("cob_id", 0x500).asUInt());
+    if ((robot.mMoveRxPDO < 1) || (robot.mMoveRxPDO > 4)
+        || (robot.mMoveCobId < 0x200) || (robot.mMoveCobId >= 0x580)) {
+        CMN_LOG_CLASS_INIT_ERROR << "Configure: invalid move rx_pdo " << robot.mMoveRxPDO << " or cob_id "
+                                 << robot.mMoveCobId << ", must be 1 to 4 and 0x200 to 0x57F" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    robot.mMoveScaleProfiles = jsonMove.get("scale_profiles", false).asBool();
+    robot.mCountsPerTurn.SetSize(numAxes);
+    robot.mMoveProfile.SetSize(numAxes, RobotData::NUMBER_OF_PROFILE_PARAMETERS);
+    robot.mMoveStartTimes.SetSize(numAxes);
+    robot.mMoveStartTimes.SetAll(0.0);
+    robot.mMoveSkew = 0.0;
+    robot.mMoveStartPending = false;
+
+    // Errors in Run are counted and reported at most once per period (s)
+    const double errorSummaryPeriod = jsonConfig.get("error_summary_period", 0.1).asDouble();
+    robot.mErrors.Configure(numAxes, errorSummaryPeriod);
+    robot.mErrors.GetCounters(robot.mErrorCounters);
+    robot.mErrorCountersTotal = 0;
+    robot.mErrorSummary.reserve(1024);
+
+    // Velocity estimator, "filter" (default) or "kalman"
+    const Json::Value jsonEstimator = jsonConfig["velocity_estimator"];
+    const std::string estimatorType = jsonEstimator.get("type", "filter").asString();
+    mtsMaxonEPOSVelocityEstimator::Type type;
+    if (!mtsMaxonEPOSVelocityEstimator::TypeFromString(estimatorType, type)) {
+        CMN_LOG_CLASS_INIT_ERROR << "Configure: invalid velocity_estimator type \"" << estimatorType
+                                 << "\", must be filter or kalman" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    const double cutoff = jsonEstimator.get("cutoff", 20.0).asDouble();
+    const double processNoise = jsonEstimator.get("process_noise", 1.0e6).asDouble();
+    const double measurementNoise = jsonEstimator.get("measurement_noise", 1.0 / 12.0).asDouble();
+    if ((cutoff <= 0.0) || (processNoise <= 0.0) || (measurementNoise <= 0.0)) {
+        CMN_LOG_CLASS_INIT_ERROR << "Configure: velocity_estimator cutoff, process_noise and measurement_noise"
+                                 << " must be positive" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    robot.mVelocityEstimator.Configure(numAxes, type, cutoff, processNoise, measurementNoise);
+    robot.mInMotionThreshold = jsonEstimator.get("in_motion_threshold", 50.0).asDouble();
+
+    // Forward kinematics for measured_cp, only if "kinematics" is defined
+    std::string kinematicsError;
+    if (!robot.mKinematics.Configure(jsonConfig["kinematics"], numAxes, robot.name, kinematicsError)) {
+        CMN_LOG_CLASS_INIT_ERROR << "Configure: kinematics for robot " << robot.name << ", "
+                                 << kinematicsError << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    if (robot.mKinematics.IsEnabled()) {
+        robot.m_measured_cp.SetReferenceFrame(robot.mKinematics.BaseFrame());
+        robot.m_measured_cp.SetMovingFrame(robot.mKinematics.TipFrame());
+        robot.m_measured_cp.SetValid(false);
+        robot.mIKGoal.Goal().SetSize(numAxes);
+        robot.mIKLastSolve = -1.0;
+        robot.mIKResidual = 0.0;
+        robot.mIKStatistics.SetSize(RobotData::NUMBER_OF_IK_STATISTICS);
+        robot.ResetIKStatistics();
+    }
 
-    mRobot.mActuatorState.SetSize(static_cast<prmActuatorState::size_type>(numAxes));
-    mRobot.mActuatorState.Position().SetAll(0.0);
-    mRobot.mActuatorState.Velocity().SetAll(0.0);
+    // Drive data recorder, settings applied once the nodes are opened
+    robot.mDataRecorderConfig = jsonConfig["data_recorder"];
+
+    // Trajectory playback, progress event period in seconds
+    const Json::Value jsonPlayback = jsonConfig["playback"];
+    robot.mPlaybackProgressPeriod = jsonPlayback.get("progress_period", 0.1).asDouble();
+    robot.mPlaybackPlaying = false;
+    robot.mPlaybackTime = 0.0;
+    robot.mPlaybackRate = 1.0;
+    robot.mPlaybackLastUpdate = 0.0;
+    robot.mPlaybackPoint = 0;
+    robot.mPlaybackLastProgress = 0.0;
+    robot.mPlaybackSetpoint.Goal().SetSize(numAxes);
+
+    // Interpolation of sparse goals, limits are set per axis
+    robot.mInterpolation.Configure(numAxes);
+    robot.mInterpolating = false;
+    robot.mInterpolationLastUpdate = -1.0;
+    robot.mInterpolationSetpoint.Goal().SetSize(numAxes);
+
+    // Read rates, in cycles: e.g. state every 10th cycle
+    const Json::Value jsonRates = jsonConfig["read_rates"];
+    const char * signalNames[RobotData::NUMBER_OF_SIGNALS] = { "state", "position", "current" };
+    for (size_t signal = 0; signal < RobotData::NUMBER_OF_SIGNALS; signal++) {
+        const int period = jsonRates.get(signalNames[signal], 1).asInt();
+        if (period < 1) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: invalid read_rates " << signalNames[signal] << " " << period
+                                     << ", must be at least 1 (cycle)" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        robot.mReadPeriod[signal] = static_cast<unsigned int>(period);
+    }
+    robot.mCycle = 0;
+    robot.mFeedbackTime.SetSize(numAxes, RobotData::NUMBER_OF_SIGNALS);
+    robot.mFeedbackTime.SetAll(0.0);
+    robot.mFeedbackAge.SetSize(numAxes, RobotData::NUMBER_OF_SIGNALS);
+    robot.mFeedbackAge.SetAll(0.0);
+
+    // Time aligned joint state, "none" (default), "earliest" or "latest"
+    const std::string alignment = jsonConfig.get("time_alignment", "none").asString();
+    if (alignment == "none") {
+        robot.mAlignment = RobotData::ALIGN_NONE;
+    } else if (alignment == "earliest") {
+        robot.mAlignment = RobotData::ALIGN_EARLIEST;
+    } else if (alignment == "latest") {
+        robot.mAlignment = RobotData::ALIGN_LATEST;
+    } else {
+        CMN_LOG_CLASS_INIT_ERROR << "Configure: invalid time_alignment \"" << alignment
+                                 << "\", must be none, earliest or latest" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    robot.mPositionTimes.SetSize(numAxes);
+    robot.mPositionTimes.SetAll(0.0);
+    robot.mPreviousPositionTimes.SetSize(numAxes);
+    robot.mPreviousPositionTimes.SetAll(0.0);
+    robot.mRawPositions.SetSize(numAxes);
+    robot.mRawPositions.SetAll(0.0);
+    robot.mPreviousRawPositions.SetSize(numAxes);
+    robot.mPreviousRawPositions.SetAll(0.0);
+    robot.m_measured_js_aligned.Name().resize(numAxes);
+    robot.m_measured_js_aligned.Position().SetSize(numAxes);
+    robot.m_measured_js_aligned.Velocity().SetSize(numAxes);
+    robot.m_measured_js_aligned.Position().SetAll(0.0);
+    robot.m_measured_js_aligned.Velocity().SetAll(0.0);
+    robot.mAlignedTime = 0.0;
+
+    robot.mHandles.resize(numAxes);
+    robot.mFeedback.resize(numAxes);
+    robot.mPDO.resize(numAxes);
+    robot.mAxisToGateway.SetSize(numAxes);
+    for (unsigned int axis = 0; axis < numAxes; axis++){
+        const Json::Value jsonAxis = jsonConfig["axes"][axis];
+        robot.mAxisToNodeIDMap[axis] = jsonAxis["nodeid"].asInt();
+
+        // Gateway, by name or index (default first gateway)
+        const Json::Value jsonGateway = jsonAxis.get("gateway", 0);
+        size_t gateway = 0;
+        if (jsonGateway.isString()) {
+            while ((gateway < mGateways.size()) && (mGateways[gateway].name != jsonGateway.asString())) {
+                gateway++;
+            }
+        } else {
+            gateway = jsonGateway.asUInt();
+        }
+        if (gateway >= mGateways.size()) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: invalid gateway " << jsonGateway.toStyledString()
+                                     << " for axis " << axis << " of robot " << robot.name << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        robot.mAxisToGateway[axis] = static_cast<unsigned int>(gateway);
+
+        // Profile position mode parameters, written at startup
+        const Json::Value jsonProfile = jsonAxis["profile"];
+        const char * profileNames[RobotData::NUMBER_OF_PROFILE_PARAMETERS] = { "velocity", "acceleration", "deceleration" };
+        for (size_t parameter = 0; parameter < RobotData::NUMBER_OF_PROFILE_PARAMETERS; ++parameter) {
+            const double value = jsonProfile.get(profileNames[parameter], 0.0).asDouble();
+            if (value < 0.0) {
+                CMN_LOG_CLASS_INIT_ERROR << "Configure: invalid profile " << profileNames[parameter]
+                                         << " for axis " << axis << ", can't be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            robot.mProfile.Element(axis, parameter) = value;
+        }
 
-    mRobot.mAxisToNodeIDMap.SetSize(numAxes);
+        // Limits for interpolate_jp, in quadcounts
+        const Json::Value jsonTrajectory = jsonAxis["trajectory"];
+        const double trajectoryVelocity = jsonTrajectory.get("velocity", 10000.0).asDouble();
+        const double trajectoryAcceleration = jsonTrajectory.get("acceleration", 50000.0).asDouble();
+        const double trajectoryJerk = jsonTrajectory.get("jerk", 1000000.0).asDouble();
+        if ((trajectoryVelocity <= 0.0) || (trajectoryAcceleration <= 0.0) || (trajectoryJerk <= 0.0)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: invalid trajectory limits for axis " << axis
+                                     << ", velocity, acceleration and jerk must be positive" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        robot.mInterpolation.SetLimits(axis, trajectoryVelocity, trajectoryAcceleration, trajectoryJerk);
+
+        // Encoder resolution, only needed to scale the move profiles
+        robot.mCountsPerTurn[axis] = jsonAxis.get("counts_per_turn", 0.0).asDouble();
+        if (robot.mMoveScaleProfiles && (robot.mCountsPerTurn[axis] <= 0.0)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: counts_per_turn must be positive for axis " << axis
+                                     << " to scale move profiles" << std::endl;
+            exit(EXIT_FAILURE);
+        }
 
-    mRobot.offset_js.SetSize(numAxes);
-    mRobot.offset_js.SetAll(0.0);
+        // Feedback: "sdo" (default) or "pdo"
+        RobotData::AxisPDO & pdo = robot.mPDO[axis];
+        const std::string feedback = jsonAxis.get("feedback", "sdo").asString();
+        if ((feedback != "sdo") && (feedback != "pdo")) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: invalid feedback \"" << feedback << "\" for axis "
+                                     << axis << ", must be sdo or pdo" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        pdo.enabled = (feedback == "pdo");
+        const Json::Value jsonPDO = jsonAxis["tx_pdo"];
+        pdo.number = static_cast<unsigned short>(jsonPDO.get("number", 1).asUInt());
+        if ((pdo.number < 1) || (pdo.number > 4)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: invalid tx_pdo number " << pdo.number << " for axis "
+                                     << axis << ", must be between 1 and 4" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        pdo.cobId = static_cast<unsigned short>(0x180 + 0x100 * (pdo.number - 1) + robot.mAxisToNodeIDMap[axis]);
+        pdo.transmissionType = static_cast<unsigned char>(jsonPDO.get("transmission_type", 255).asUInt());
+        pdo.inhibitTime = static_cast<unsigned short>(jsonPDO.get("inhibit_time", 0).asUInt());
+        pdo.eventTimer = static_cast<unsigned short>(jsonPDO.get("event_timer", 1).asUInt());
+        pdo.timeout = jsonPDO.get("timeout", 10).asUInt();
+        pdo.mapping.clear();
+        Json::Value jsonMapping = jsonPDO["mapping"];
+        if (jsonMapping.isNull()) {
+            for (size_t i = 0; i < sizeof(PDOSignals) / sizeof(PDOSignals[0]); i++) {
+                jsonMapping.append(PDOSignals[i].name);
+            }
+        }
+        unsigned int bits = 0;
+        for (Json::ArrayIndex i = 0; i < jsonMapping.size(); i++) {
+            const std::string signal = jsonMapping[i].asString();
+            size_t s = 0;
+            while ((s < sizeof(PDOSignals) / sizeof(PDOSignals[0])) && (signal != PDOSignals[s].name)) {
+                s++;
+            }
+            if (s == sizeof(PDOSignals) / sizeof(PDOSignals[0])) {
+                CMN_LOG_CLASS_INIT_ERROR << "Configure: invalid tx_pdo signal \"" << signal << "\" for axis "
+                                         << axis << ", must be statusword, position or current" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            pdo.mapping.push_back((static_cast<unsigned int>(PDOSignals[s].index) << 16)
+                                  | (static_cast<unsigned int>(PDOSignals[s].subIndex) << 8)
+                                  | PDOSignals[s].bits);
+            bits += PDOSignals[s].bits;
+        }
+        if (bits > 64) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: tx_pdo mapping for axis " << axis
+                                     << " doesn't fit in a CAN frame (" << bits << " bits)" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        if (pdo.enabled && (pdo.transmissionType >= 1) && (pdo.transmissionType <= 240)) {
+            mGateways[gateway].sendSync = true;
+        }
+    }
+}
 
-    mRobot.mState.SetSize(numAxes);
-    mRobot.mState.SetAll(ST_PPM);
 
-    mRobot.mHandles.resize(numAxes);
-    for (unsigned int axis = 0; axis < numAxes; axis++){
-        mRobot.mAxisToNodeIDMap[axis] = jsonConfig["axes"][axis]["nodeid"].asInt();
+// Execute jobs 0 to count - 1 concurrently, one thread each
+static void ExecuteConcurrently(size_t count, const mtsMaxonEPOSPoller::JobFunction & function)
+{
+    std::vector<std::vector<size_t> > groups(count);
+    for (size_t job = 0; job < count; ++job) {
+        groups[job].push_back(job);
     }
-
-    SetupInterfaces();
+    mtsMaxonEPOSPoller poller;
+    poller.Configure(groups, function);
+    poller.Start();
+    poller.Execute();
 }
 
+bool mtsMaxonEPOS::WaitUntilReady(const std::function<bool (void)> & ready) const
+{
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now()
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(mStartupTimeout));
+    while (!ready()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        osaSleep(mStartupPollPeriod);
+    }
+    return true;
+}
 
 void mtsMaxonEPOS::Startup()//const std::string & fileName
 {
-    // Zero Error Code
-    mRobot.mErrorCode = 0;
-    
-    mRobot.mHandles[0] = VCS_OpenDevice(const_cast<char*>(mRobot.deviceName.c_str()),
-                                const_cast<char*>(mRobot.protocolStackName.c_str()),
-                                const_cast<char*>(mRobot.interfaceName.c_str()),
-                                const_cast<char*>(mRobot.portName.c_str()),
-                                DWORD_CAST(&mRobot.mErrorCode));
-
-    if (mRobot.mHandles[0] != nullptr && mRobot.mErrorCode == 0){
-        std::cout<<"Root node successfully connected"<<std::endl;
-        for (unsigned int j = 1; j < mRobot.mNumAxes; j++){
-            mRobot.mHandles[j] = VCS_OpenSubDevice(mRobot.mHandles[0],
-                                const_cast<char*>(mRobot.deviceName.c_str()),
-                                const_cast<char*>("CANopen"),
-                                DWORD_CAST(&mRobot.mErrorCode));
-            if(mRobot.mHandles[j]==0){
-                CMN_LOG_CLASS_INIT_ERROR << "Startup: VCS_OpenSubDevice " << j << " failed (errorCode = " << mRobot.mErrorCode << ")" << std::endl;
-                exit(EXIT_FAILURE);
+    // Startup is called from the component's thread
+    std::string realTimeError;
+    if (!mRealTime.SetupThread(realTimeError)) {
+        CMN_LOG_CLASS_INIT_WARNING << "Startup: real time setup incomplete, " << realTimeError << std::endl;
+    }
+
+    // Duration of each phase
+    mStartupPhases.clear();
+    std::vector<double> times;
+    std::chrono::steady_clock::time_point phaseStart = std::chrono::steady_clock::now();
+    auto endPhase = [&](const char * phase) {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        mStartupPhases.push_back(phase);
+        times.push_back(std::chrono::duration<double>(now - phaseStart).count());
+        phaseStart = now;
+    };
+
+    // Axes per gateway, the first one is the node connected to the
+    // interface, the other axes on the same bus are reached through
+    // sub-devices
+    std::vector<std::vector<size_t> > gatewayAxes(mGateways.size());
+    for (size_t index = 0; index < mAxes.size(); ++index) {
+        const RobotData & robot = *(mAxes[index].robot);
+        gatewayAxes[robot.mAxisToGateway[mAxes[index].axis]].push_back(index);
+    }
+
+    // Open all gateways, concurrently
+    std::vector<unsigned int> errorCodes(std::max(mGateways.size(), mAxes.size()), 0);
+    ExecuteConcurrently(mGateways.size(), [this, &errorCodes](size_t index) {
+        GatewayData & gateway = mGateways[index];
+        gateway.handle = mDriver->OpenDevice(gateway.deviceName,
+                                             gateway.protocolStackName,
+                                             gateway.interfaceName,
+                                             gateway.portName,
+                                             errorCodes[index]);
+    });
+    for (size_t index = 0; index < mGateways.size(); ++index) {
+        const GatewayData & gateway = mGateways[index];
+        if ((gateway.handle == nullptr) || (errorCodes[index] != 0)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Startup: VCS_OpenDevice failed for gateway " << gateway.name
+                                     << " (errorCode = " << errorCodes[index] << ")" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        std::cout << "Gateway " << gateway.name << " successfully connected" << std::endl;
+    }
+    endPhase("open_devices");
+
+    // Open sub-devices, concurrently
+    std::vector<size_t> subDevices;
+    for (size_t gateway = 0; gateway < mGateways.size(); ++gateway) {
+        for (size_t i = 0; i < gatewayAxes[gateway].size(); ++i) {
+            RobotData & robot = *(mAxes[gatewayAxes[gateway][i]].robot);
+            const size_t axis = mAxes[gatewayAxes[gateway][i]].axis;
+            if (i == 0) {
+                robot.mHandles[axis] = mGateways[gateway].handle;
+            } else {
+                subDevices.push_back(gatewayAxes[gateway][i]);
             }
         }
     }
-    else{
-        CMN_LOG_CLASS_INIT_ERROR << "Startup: VCS_OpenDevice failed (errorCode = " << mRobot.mErrorCode << ")" << std::endl;
-        exit(EXIT_FAILURE);
+    std::fill(errorCodes.begin(), errorCodes.end(), 0);
+    ExecuteConcurrently(subDevices.size(), [this, &subDevices, &errorCodes](size_t job) {
+        RobotData & robot = *(mAxes[subDevices[job]].robot);
+        const size_t axis = mAxes[subDevices[job]].axis;
+        const GatewayData & gateway = mGateways[robot.mAxisToGateway[axis]];
+        robot.mHandles[axis] = mDriver->OpenSubDevice(gateway.handle, gateway.deviceName,
+                                                      "CANopen", errorCodes[job]);
+    });
+    for (size_t job = 0; job < subDevices.size(); ++job) {
+        const RobotData & robot = *(mAxes[subDevices[job]].robot);
+        const size_t axis = mAxes[subDevices[job]].axis;
+        if (robot.mHandles[axis] == 0) {
+            CMN_LOG_CLASS_INIT_ERROR << "Startup: VCS_OpenSubDevice failed for " << robot.name << " axis " << axis
+                                     << " (errorCode = " << errorCodes[job] << ")" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (size_t index = 0; index < mAxes.size(); ++index) {
+        RobotData & robot = *(mAxes[index].robot);
+        const size_t axis = mAxes[index].axis;
+        // Zero Error Code
+        robot.mErrorCode = 0;
+        mTimedDriver->SetAxis(index, robot.mHandles[axis], robot.mAxisToNodeIDMap[axis]);
+        mObjectDictionary.SetNode(index, robot.mHandles[axis], robot.mAxisToNodeIDMap[axis]);
+    }
+    endPhase("open_sub_devices");
+
+    // Reset the nodes, or just bring them back to pre-operational if they
+    // are known to be up (no reboot)
+    unsigned int errorCode = 0;
+    const unsigned short nmtCommand = mStartupResetNodes ? 129 : 128;
+    for (size_t index = 0; index < mGateways.size(); ++index) {
+        if (!mDriver->SendNMTService(mGateways[index].handle, 0, nmtCommand, errorCode)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Startup: VCS_SendNMTService failed for gateway " << mGateways[index].name
+                                     << " (errorCode = " << errorCode << ")\n";
+            exit(EXIT_FAILURE);
+        }
     }
+    endPhase("nmt_reset");
 
-    if (!VCS_SendNMTService(mRobot.mHandles[0], 0, 129, DWORD_CAST(&mRobot.mErrorCode))) {
-        CMN_LOG_CLASS_INIT_ERROR << "Startup: VCS_SendNMTService failed (errorCode = "
-                                << mRobot.mErrorCode << ")\n";
-        exit(EXIT_FAILURE);
+    // Wait for the nodes to boot, a node is up once it answers an SDO;
+    // the boot delay avoids getting answers sent before the reset
+    if (mStartupResetNodes) {
+        osaSleep(mStartupBootDelay);
     }
-    // Wait for reset
-    osaSleep(333*cmn_ms);
-    if (!VCS_ClearFault(mRobot.mHandles[0], 0, DWORD_CAST(&mRobot.mErrorCode))) {
-        CMN_LOG_CLASS_INIT_ERROR << "Startup: VCS_ClearFault failed (errorCode = "
-                                << mRobot.mErrorCode << ")\n";
-        exit(EXIT_FAILURE);
+    std::vector<char> ready(mGateways.size(), 0);
+    ExecuteConcurrently(mGateways.size(), [this, &gatewayAxes, &ready](size_t gateway) {
+        bool allReady = true;
+        for (size_t i = 0; allReady && (i < gatewayAxes[gateway].size()); ++i) {
+            const RobotData & robot = *(mAxes[gatewayAxes[gateway][i]].robot);
+            const size_t axis = mAxes[gatewayAxes[gateway][i]].axis;
+            allReady = WaitUntilReady([this, &robot, axis]() {
+                unsigned short state;
+                unsigned int nodeErrorCode;
+                return mDriver->GetState(robot.mHandles[axis], robot.mAxisToNodeIDMap[axis], state, nodeErrorCode);
+            });
+        }
+        ready[gateway] = allReady;
+    });
+    for (size_t index = 0; index < mGateways.size(); ++index) {
+        if (!ready[index]) {
+            CMN_LOG_CLASS_INIT_ERROR << "Startup: nodes on gateway " << mGateways[index].name
+                                     << " not ready after " << mStartupTimeout << "s" << std::endl;
+            exit(EXIT_FAILURE);
+        }
     }
-    osaSleep(333*cmn_ms);
-    VCS_SendNMTService(mRobot.mHandles[0], 0, 1, DWORD_CAST(&mRobot.mErrorCode));
-    osaSleep(333*cmn_ms);
+    endPhase("boot");
 
-    unsigned int oldTimeout;
-    if (!VCS_GetProtocolStackSettings(mRobot.mHandles[0], DWORD_CAST(&mRobot.baudrate), DWORD_CAST(&oldTimeout), DWORD_CAST(&mRobot.mErrorCode))) {
-        CMN_LOG_CLASS_INIT_ERROR << "Startup: VCS_GetProtocolStackSettings failed (errorCode = "
-                                << mRobot.mErrorCode << ")\n";
-        exit(EXIT_FAILURE);
+    for (size_t index = 0; index < mGateways.size(); ++index) {
+        if (!mDriver->ClearFault(mGateways[index].handle, 0, errorCode)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Startup: VCS_ClearFault failed for gateway " << mGateways[index].name
+                                     << " (errorCode = " << errorCode << ")\n";
+            exit(EXIT_FAILURE);
+        }
     }
-    if (!VCS_SetProtocolStackSettings(mRobot.mHandles[0], mRobot.baudrate, mRobot.mTimeout, DWORD_CAST(&mRobot.mErrorCode))) {
-        CMN_LOG_CLASS_INIT_ERROR << "Startup: VCS_SetProtocolStackSettings failed (errorCode = "
-                                << mRobot.mErrorCode << ")\n";
-        exit(EXIT_FAILURE);
+    // Faults that can't be cleared are reported by Run
+    std::fill(ready.begin(), ready.end(), 0);
+    ExecuteConcurrently(mGateways.size(), [this, &gatewayAxes, &ready](size_t gateway) {
+        bool allCleared = true;
+        for (size_t i = 0; i < gatewayAxes[gateway].size(); ++i) {
+            const RobotData & robot = *(mAxes[gatewayAxes[gateway][i]].robot);
+            const size_t axis = mAxes[gatewayAxes[gateway][i]].axis;
+            allCleared = WaitUntilReady([this, &robot, axis]() {
+                bool isFault = true;
+                unsigned int nodeErrorCode;
+                return mDriver->GetFaultState(robot.mHandles[axis], robot.mAxisToNodeIDMap[axis], isFault, nodeErrorCode)
+                    && !isFault;
+            }) && allCleared;
+        }
+        ready[gateway] = allCleared;
+    });
+    for (size_t index = 0; index < mGateways.size(); ++index) {
+        if (!ready[index]) {
+            CMN_LOG_CLASS_INIT_WARNING << "Startup: fault not cleared on gateway " << mGateways[index].name
+                                       << " after " << mStartupTimeout << "s" << std::endl;
+        }
+    }
+    endPhase("clear_fault");
+
+    // Nodes may have been reset, only values from the file cache (for the
+    // same serial number) can be trusted
+    std::string cacheError;
+    const bool useCacheFile = !mObjectDictionaryCacheFile.empty()
+        && mObjectDictionary.LoadCache(mObjectDictionaryCacheFile, cacheError);
+    if (!mObjectDictionaryCacheFile.empty() && !useCacheFile) {
+        CMN_LOG_CLASS_INIT_WARNING << "Startup: ignoring object dictionary cache, " << cacheError << std::endl;
+    }
+    for (size_t index = 0; index < mAxes.size(); ++index) {
+        RobotData & robot = *(mAxes[index].robot);
+        const size_t axis = mAxes[index].axis;
+        mObjectDictionary.Invalidate(index);
+        if (useCacheFile && !mObjectDictionary.Identify(index, errorCode)) {
+            CMN_LOG_CLASS_INIT_WARNING << "Startup: failed to read serial number of " << robot.name << " axis " << axis
+                                       << " (errorCode = " << errorCode << ")" << std::endl;
+        }
+        for (size_t object = 0; object < mStaticObjects.size(); ++object) {
+            unsigned int value;
+            if (mObjectDictionary.Read(index, mStaticObjects[object], value, errorCode)) {
+                robot.mStaticParameters.Element(axis, object) = value;
+            } else {
+                CMN_LOG_CLASS_INIT_WARNING << "Startup: failed to read " << mStaticObjects[object].name
+                                           << " for " << robot.name << " axis " << axis
+                                           << " (errorCode = " << errorCode << ")" << std::endl;
+            }
+        }
+    }
+    if (useCacheFile) {
+        mObjectDictionary.UpdateCache(mStaticObjects);
+        if (!mObjectDictionary.SaveCache(mObjectDictionaryCacheFile, cacheError)) {
+            CMN_LOG_CLASS_INIT_WARNING << "Startup: failed to save object dictionary cache, " << cacheError << std::endl;
+        }
+    }
+    endPhase("object_dictionary");
+
+    // Map the feedback TxPDOs while the nodes are pre-operational, fall
+    // back to SDO reads for the axes that can't be configured
+    for (size_t index = 0; index < mAxes.size(); ++index) {
+        RobotData & robot = *(mAxes[index].robot);
+        const size_t axis = mAxes[index].axis;
+        if (robot.mPDO[axis].enabled && !robot.ConfigurePDO(axis)) {
+            CMN_LOG_CLASS_INIT_WARNING << "Startup: failed to configure TxPDO " << robot.mPDO[axis].number
+                                       << " for " << robot.name << " axis " << axis << " (errorCode = "
+                                       << robot.mErrorCode << "), using SDO feedback" << std::endl;
+            robot.mPDO[axis].enabled = false;
+        }
+        // All axes of a robot must use the RxPDO to start synchronized moves
+        if ((robot.mMoveSynchronization != RobotData::MOVE_SYNC_NONE) && !robot.ConfigureMoveRxPDO(axis)) {
+            CMN_LOG_CLASS_INIT_WARNING << "Startup: failed to configure RxPDO " << robot.mMoveRxPDO
+                                       << " for " << robot.name << " axis " << axis << " (errorCode = "
+                                       << robot.mErrorCode << "), move_jp won't be synchronized" << std::endl;
+            robot.mMoveSynchronization = RobotData::MOVE_SYNC_NONE;
+        }
+    }
+    endPhase("configure_pdo");
+
+    // Profile parameters from the configuration
+    for (size_t index = 0; index < mAxes.size(); ++index) {
+        RobotData & robot = *(mAxes[index].robot);
+        const size_t axis = mAxes[index].axis;
+        if (!robot.WriteProfile(axis, robot.mProfile)) {
+            CMN_LOG_CLASS_INIT_WARNING << "Startup: failed to write profile for " << robot.name << " axis " << axis
+                                       << " (errorCode = " << robot.mErrorCode << ")" << std::endl;
+        }
+    }
+    endPhase("configure_profile");
+
+    for (size_t index = 0; index < mGateways.size(); ++index) {
+        mDriver->SendNMTService(mGateways[index].handle, 0, 1, errorCode);
+    }
+
+    // PDOs are only received on CAN interfaces, wait for the first frame
+    // (transmission starts once the node is operational)
+    for (size_t index = 0; index < mAxes.size(); ++index) {
+        RobotData & robot = *(mAxes[index].robot);
+        const size_t axis = mAxes[index].axis;
+        RobotData::AxisPDO & pdo = robot.mPDO[axis];
+        if (!pdo.enabled) {
+            continue;
+        }
+        const GatewayData & gateway = mGateways[robot.mAxisToGateway[axis]];
+        const bool received = WaitUntilReady([this, &robot, &pdo, &gateway, axis]() {
+            unsigned char frame[8];
+            if (gateway.sendSync) {
+                mDriver->SendCANFrame(gateway.handle, 0x80, 0, frame, robot.mErrorCode);
+            }
+            return mDriver->ReadCANFrame(robot.mHandles[axis], pdo.cobId, 8, frame, pdo.timeout, robot.mErrorCode);
+        });
+        if (!received) {
+            CMN_LOG_CLASS_INIT_WARNING << "Startup: no TxPDO received for " << robot.name << " axis " << axis
+                                       << " (errorCode = " << robot.mErrorCode << "), using SDO feedback" << std::endl;
+            pdo.enabled = false;
+        } else {
+            CMN_LOG_CLASS_INIT_VERBOSE << "Startup: using TxPDO " << pdo.number << " for " << robot.name
+                                       << " axis " << axis << std::endl;
+        }
+    }
+    endPhase("nmt_start");
+
+    for (size_t index = 0; index < mGateways.size(); ++index) {
+        GatewayData & gateway = mGateways[index];
+        unsigned int oldTimeout;
+        if (!mDriver->GetProtocolStackSettings(gateway.handle, gateway.baudrate, oldTimeout, errorCode)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Startup: VCS_GetProtocolStackSettings failed for gateway " << gateway.name
+                                     << " (errorCode = " << errorCode << ")\n";
+            exit(EXIT_FAILURE);
+        }
+        if (!mDriver->SetProtocolStackSettings(gateway.handle, gateway.baudrate, gateway.timeout, errorCode)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Startup: VCS_SetProtocolStackSettings failed for gateway " << gateway.name
+                                     << " (errorCode = " << errorCode << ")\n";
+            exit(EXIT_FAILURE);
+        }
+    }
+    endPhase("protocol_settings");
+
+    SetupPolling();
+    mFlightRecorder.Start();
+    for (size_t index = 0; index < mRobots.size(); ++index) {
+        RobotData & robot = *(mRobots[index]);
+        std::vector<unsigned short> nodeIds(robot.mNumAxes);
+        for (size_t axis = 0; axis < robot.mNumAxes; ++axis) {
+            nodeIds[axis] = static_cast<unsigned short>(robot.mAxisToNodeIDMap[axis]);
+        }
+        robot.mDataRecorder.SetAxes(mDriver, robot.mHandles, nodeIds);
+        robot.mDataRecorder.Start();
+        std::string error;
+        if (!robot.mDataRecorderConfig.isNull()
+            && !robot.mDataRecorder.Configure(robot.mDataRecorderConfig, error)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Startup: invalid data_recorder for robot " << robot.name
+                                     << ": " << error << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    endPhase("polling");
+
+    mStartupTimes.SetSize(times.size());
+    double total = 0.0;
+    std::string breakdown;
+    for (size_t phase = 0; phase < times.size(); ++phase) {
+        mStartupTimes[phase] = times[phase];
+        total += times[phase];
+        breakdown += (phase ? ", " : "") + mStartupPhases[phase] + " " + std::to_string(times[phase]) + "s";
+    }
+    CMN_LOG_CLASS_INIT_VERBOSE << "Startup: completed in " << total << "s (" << breakdown << ")" << std::endl;
+
+    if (mRealTime.IsPeriodic()) {
+        CMN_LOG_CLASS_INIT_VERBOSE << "Startup: running periodically, period " << mRealTime.Period() << "s" << std::endl;
+        mRealTime.Start();
     }
 }
 
-void mtsMaxonEPOS::Run()
+void mtsMaxonEPOS::GetStartupTimes(vctDoubleVec & times) const
 {
-    uint16_t opState;
-    bool isFault = false;
-    // First axis USB, rest of the axes are CAN
-    for (size_t axis = 0; axis < mRobot.mNumAxes; ++axis) {
+    times = mStartupTimes;
+}
 
-        // Zero errorCode
-        mRobot.mErrorCode = 0;
-        if (VCS_GetState(mRobot.mHandles[axis],  mRobot.mAxisToNodeIDMap[axis], &opState,  DWORD_CAST(&mRobot.mErrorCode))) {
-            if(opState==0){ //Disable
-                mRobot.mActuatorState.MotorOff()[axis] = true;
-            }
-            if(opState==1){ //Enable
-                mRobot.mActuatorState.MotorOff()[axis] = false;
+void mtsMaxonEPOS::GetStartupPhases(std::vector<std::string> & phases) const
+{
+    phases = mStartupPhases;
+}
+
+void mtsMaxonEPOS::GetStaticParameterNames(std::vector<std::string> & names) const
+{
+    names.resize(mStaticObjects.size());
+    for (size_t index = 0; index < mStaticObjects.size(); ++index) {
+        names[index] = mStaticObjects[index].name;
+    }
+}
+
+void mtsMaxonEPOS::Run()
+{
+    // Periodic mode, start each cycle at its deadline
+    mRealTime.WaitForNextPeriod();
+
+    // Trigger synchronous TxPDOs and start the moves staged by move_jp, so
+    // there is a single SYNC per cycle
+    bool moveSync = false;
+    std::chrono::steady_clock::time_point firstSync;
+    for (size_t index = 0; index < mGateways.size(); ++index) {
+        GatewayData & gateway = mGateways[index];
+        if (gateway.sendSync || gateway.syncPending) {
+            unsigned char data[1];
+            unsigned int errorCode;
+            mDriver->SendCANFrame(gateway.handle, 0x80, 0, data, errorCode);
+            if (gateway.syncPending) {
+                const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+                if (!moveSync) {
+                    firstSync = now;
+                    moveSync = true;
+                }
+                gateway.syncTime = std::chrono::duration<double>(now - firstSync).count();
+                gateway.syncPending = false;
             }
-            if(opState==3){ //Fault
-                mRobot.mActuatorState.MotorOff()[axis] = true;
-                isFault = true;
+        }
+    }
+    if (moveSync) {
+        for (size_t index = 0; index < mRobots.size(); ++index) {
+            if (mRobots[index]->mMoveStartPending) {
+                mRobots[index]->UpdateMoveStartTimes();
             }
-        } else {
-            mRobot.mInterface->SendError(mRobot.name + ": GetFaultState failed (err=" + std::to_string(mRobot.mErrorCode) + ")");
-            break;
-        };
-
-        // Read position
-#if (CISST_OS == CISST_WINDOWS)
-        long positionCounts = 0;
-#else
-        int positionCounts = 0;
-#endif
-        if (VCS_GetPositionIs(mRobot.mHandles[axis], mRobot.mAxisToNodeIDMap[axis], &positionCounts, DWORD_CAST(&mRobot.mErrorCode))) {
-            mRobot.m_measured_js.Position()[axis] = static_cast<double>(positionCounts) - mRobot.offset_js[axis];
-            mRobot.mActuatorState.Position()[axis] = static_cast<double>(positionCounts) - mRobot.offset_js[axis];
-        } else {
-            mRobot.mInterface->SendError(mRobot.name + ": GetPositionIs failed (err=" + std::to_string(mRobot.mErrorCode) + ")");
-            break;
-        }
-
-        // Read Velocity
-#if (CISST_OS == CISST_WINDOWS)
-        long velocityCounts = 0;
-#else
-        short velocityCounts = 0;
-#endif
-        if (VCS_GetCurrentIs(mRobot.mHandles[axis], mRobot.mAxisToNodeIDMap[axis], &velocityCounts, DWORD_CAST(&mRobot.mErrorCode))) {
-            mRobot.m_measured_js.Velocity()[axis] = static_cast<double>(velocityCounts);
-            mRobot.mActuatorState.Velocity()[axis] = static_cast<double>(velocityCounts);
-            mRobot.mActuatorState.InMotion()[axis] = (velocityCounts != 0);
-        } else {
-            mRobot.mInterface->SendError(mRobot.name + ": GetVelocityIs failed (err=" + std::to_string(mRobot.mErrorCode) + ")");
-            break;
         }
     }
 
-    if(isFault){
-        mRobot.newState = prmOperatingState::FAULT;
-    }else if(mRobot.mActuatorState.MotorOff().Any()==true){
-        mRobot.newState = prmOperatingState::DISABLED;
-    }else{
-        mRobot.newState = prmOperatingState::ENABLED;
+    // Read all axes, concurrently if polling threads are used
+    for (size_t index = 0; index < mRobots.size(); ++index) {
+        mRobots[index]->ScheduleReads();
     }
+    const std::chrono::steady_clock::time_point startPolling = std::chrono::steady_clock::now();
+    mPollingWaitTime = mPoller.Execute();
+    const std::chrono::steady_clock::time_point endPolling = std::chrono::steady_clock::now();
+    mPollingTime = std::chrono::duration<double>(endPolling - startPolling).count();
+    const double now = std::chrono::duration<double>(endPolling.time_since_epoch()).count();
+
+    for (size_t index = 0; index < mRobots.size(); ++index) {
+        mRobots[index]->UpdateFeedback(now);
+    }
+
+    RecordFlightRecorder(now);
 
-    if (mRobot.newState != mRobot.m_op_state.State()) {
-        mRobot.m_op_state.SetState(mRobot.newState);
-        // Trigger event
-        mRobot.operating_state(mRobot.m_op_state);
+    bool isFault = false;
+    for (size_t index = 0; index < mRobots.size(); ++index) {
+        RobotData & robot = *mRobots[index];
+        if (robot.newState != robot.m_op_state.State()) {
+            if (robot.newState == prmOperatingState::FAULT) {
+                isFault = true;
+            }
+            robot.m_op_state.SetState(robot.newState);
+            // Trigger event
+            robot.operating_state(robot.m_op_state);
+        }
+    }
+    if (isFault) {
+        DumpFlightRecorder();
     }
 
     // Advance the state table now, so that any connected components can get
@@ -296,90 +1185,556 @@ void mtsMaxonEPOS::Run()
     catch (const std::runtime_error &e) {
         CMN_LOG_CLASS_RUN_ERROR << this->GetName() << ": ProcessQueuedCommands " << e.what() << std::endl;
     }
-}
 
-void mtsMaxonEPOS::Close()
-{
-    // 1) Close sub devices first
-    for (size_t axis = 1; axis < mRobot.mHandles.size(); ++axis) {
-        if (mRobot.mHandles[axis]) {
-            if (!VCS_CloseSubDevice(mRobot.mHandles[axis], DWORD_CAST(&mRobot.mErrorCode)) || mRobot.mErrorCode != 0) {
-                CMN_LOG_CLASS_RUN_ERROR 
-                    << mRobot.name 
-                    << "[axis " << axis 
-                    << "] CloseSubDevice failed (errorCode=" << mRobot.mErrorCode << ")\n";
-            }
-            mRobot.mHandles[axis] = nullptr;
-        }
+    // Last servo command received this cycle, if coalescing
+    for (size_t index = 0; index < mRobots.size(); ++index) {
+        mRobots[index]->SendPendingServo();
     }
-    if (!VCS_CloseDevice(mRobot.mHandles[0], DWORD_CAST(&mRobot.mErrorCode)) || mRobot.mErrorCode != 0) {
-        CMN_LOG_CLASS_RUN_ERROR 
-            << mRobot.name 
-            << "[gateway] CloseDevice failed (errorCode=" << mRobot.mErrorCode << ")\n";
-    }
-    mRobot.mHandles[0] = nullptr;
 }
 
-void mtsMaxonEPOS::RobotData::state_command(const std::string &command)
+void mtsMaxonEPOS::RobotData::UpdateFeedback(double now)
 {
-    std::string humanReadableMessage;
-    prmOperatingState::StateType newOperatingState;
-    try {
-        if (m_op_state.ValidCommand(prmOperatingState::CommandTypeFromString(command),
-                                    newOperatingState, humanReadableMessage)) {
-            if (command == "enable") {
-                EnableMotorPower();
-                return;
-            }
-            if (command == "disable") {
-                DisableMotorPower();
-                return;
-            }
-            if (command == "home") {
-                offset_js -= m_measured_js.Position();
-                return;
+    bool isFault = false;
+    mErrorCode = 0;
+    // First axis USB, rest of the axes are CAN
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        const RobotData::AxisFeedback & feedback = mFeedback[axis];
+        // Keep the first error
+        if (mErrorCode == 0) {
+            mErrorCode = feedback.errorCode;
+        }
+        for (size_t signal = 0; signal < RobotData::NUMBER_OF_SIGNALS; signal++) {
+            if (feedback.received & (1 << signal)) {
+                mFeedbackTime.Element(axis, signal) = now;
             }
-            if (command == "unhome") {
-                offset_js.SetAll(0.0);
-                return;
+            mFeedbackAge.Element(axis, signal) = now - mFeedbackTime.Element(axis, signal);
+        }
+
+        // State, keep last known state if not read this cycle
+        if (feedback.received & (1 << RobotData::SIGNAL_STATE)) {
+            if(feedback.opState==0){ //Disable
+                mActuatorState.MotorOff()[axis] = true;
             }
-            if (command == "pause") {
-                if (m_op_state.State() == prmOperatingState::ENABLED)
-                    hold();   // Stop motion
-                m_op_state.SetState(newOperatingState);
-                return;
+            if(feedback.opState==1){ //Enable
+                mActuatorState.MotorOff()[axis] = false;
             }
-            if (command == "resume") {
-                m_op_state.SetState(newOperatingState);
-                return;
+            if(feedback.opState==3){ //Fault
+                mActuatorState.MotorOff()[axis] = true;
             }
-        } else {
-            mInterface->SendWarning(name + ": " + humanReadableMessage);
         }
-    } catch (std::runtime_error &e) {
-        mInterface->SendWarning(name + ": " + command + " doesn't seem to be a valid state_command (" + e.what() + ")");
+        if (feedback.opState == 3) {
+            isFault = true;
+        }
+
+        // Position, and velocity estimated from the raw positions
+        if (feedback.received & (1 << RobotData::SIGNAL_POSITION)) {
+            m_measured_js.Position()[axis] = static_cast<double>(feedback.position) - offset_js[axis];
+            mPreviousPositionTimes[axis] = mPositionTimes[axis];
+            mPreviousRawPositions[axis] = mRawPositions[axis];
+            mPositionTimes[axis] = feedback.positionTime;
+            mRawPositions[axis] = static_cast<double>(feedback.position);
+            mActuatorState.Position()[axis] = static_cast<double>(feedback.position) - offset_js[axis];
+            const double velocity = mVelocityEstimator.Update(axis, static_cast<double>(feedback.position),
+                                                                     feedback.positionTime);
+            m_measured_js.Velocity()[axis] = velocity;
+            mActuatorState.Velocity()[axis] = velocity;
+            mActuatorState.InMotion()[axis] = (std::abs(velocity) > mInMotionThreshold);
+        }
+
+        // Current (mA)
+        if (feedback.received & (1 << RobotData::SIGNAL_CURRENT)) {
+            m_measured_js.Effort()[axis] = static_cast<double>(feedback.current);
+            mActuatorState.Effort()[axis] = static_cast<double>(feedback.current);
+        }
+
+        if (feedback.failedCall != mtsMaxonEPOSDriver::NUMBER_OF_CALLS) {
+            mErrors.Record(feedback.failedCall, axis, feedback.errorCode);
+        }
+    }
+
+    if (mAlignment != ALIGN_NONE) {
+        UpdateAlignedState();
+    }
+
+    // Tip pose, only recomputed if the joints moved more than the tolerance
+    if (mKinematics.IsEnabled()) {
+        mKinematics.Update(m_measured_js.Position(), m_measured_cp.Position());
+        m_measured_cp.SetValid(true);
+    }
+
+    // Keep the drives' IPM buffers filled
+    if ((mIpmStarted || (mIpmQueueCount > 0)) && (NumberOfAxesInIpm() == mNumAxes)) {
+        UpdateIPM();
+    }
+
+    // Trajectory playback, setpoint for this cycle
+    if (mPlaybackPlaying) {
+        UpdatePlayback(now);
+    }
+
+    // Interpolation of sparse goals, setpoint for this cycle
+    if (mInterpolating) {
+        UpdateInterpolation(now);
+    }
+
+    if(isFault){
+        newState = prmOperatingState::FAULT;
+    }else if(mActuatorState.MotorOff().Any()==true){
+        newState = prmOperatingState::DISABLED;
+    }else{
+        newState = prmOperatingState::ENABLED;
+    }
+
+    // Summary of the errors since the last one, rate limited
+    if (mErrors.Summary(now, mErrorSummary)) {
+        mInterface->SendError(name + ": " + mErrorSummary);
+    }
+    if (mErrors.Total() != mErrorCountersTotal) {
+        mErrorCountersTotal = mErrors.Total();
+        mErrors.GetCounters(mErrorCounters);
     }
+
+    UpdateDataRecorder();
 }
 
-void mtsMaxonEPOS::RobotData::EnableMotorPower(void)
+bool mtsMaxonEPOS::RobotData::WriteObject(size_t axis, unsigned short index, unsigned char subIndex,
+                                          unsigned int value, unsigned int size)
 {
-    if (!mParent) {return;}
+    mtsMaxonEPOSObjectDictionary::Object object;
+    object.index = index;
+    object.subIndex = subIndex;
+    object.size = static_cast<unsigned char>(size);
+    return mParent->mObjectDictionary.Write(mFirstAxis + axis, object, value, mErrorCode);
+}
 
-    mErrorCode = 0;
-    try {
+bool mtsMaxonEPOS::RobotData::ConfigureMoveRxPDO(size_t axis)
+{
+    const unsigned short communication = static_cast<unsigned short>(0x1400 + mMoveRxPDO - 1);
+    const unsigned short mapping = static_cast<unsigned short>(0x1600 + mMoveRxPDO - 1);
+    // One COB-ID for all nodes and asynchronous, or the node's default
+    // COB-ID for this RxPDO and applied at the next SYNC
+    unsigned int cobId = mMoveCobId;
+    unsigned int transmissionType = 255;
+    if (mMoveSynchronization == MOVE_SYNC_SYNC) {
+        cobId = 0x100 * (mMoveRxPDO + 1) + mAxisToNodeIDMap[axis];
+        transmissionType = 1;
+    }
+    // Invalidate the PDO while changing its mapping, controlword only
+    return WriteObject(axis, communication, 1, 0x80000000 | cobId, 4)
+        && WriteObject(axis, mapping, 0, 0, 1)
+        && WriteObject(axis, mapping, 1, 0x60400010, 4)
+        && WriteObject(axis, mapping, 0, 1, 1)
+        && WriteObject(axis, communication, 2, transmissionType, 1)
+        && WriteObject(axis, communication, 1, cobId, 4);
+}
 
-        for (size_t axis = 0; axis < mNumAxes; ++axis) {
+void mtsMaxonEPOS::RobotData::UpdateAlignedState(void)
+{
+    // Reference time among the axes already sampled
+    double reference = 0.0;
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        const double time = mPositionTimes[axis];
+        if (time <= 0.0) {
+            continue;
+        }
+        if ((reference <= 0.0)
+            || ((mAlignment == ALIGN_EARLIEST) && (time < reference))
+            || ((mAlignment == ALIGN_LATEST) && (time > reference))) {
+            reference = time;
+        }
+    }
+    if (reference <= 0.0) {
+        return;
+    }
+    mAlignedTime = reference;
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        const double time = mPositionTimes[axis];
+        const double previousTime = mPreviousPositionTimes[axis];
+        double position = mRawPositions[axis];
+        if ((previousTime > 0.0) && (previousTime <= reference) && (reference < time)) {
+            // Between the last two samples
+            const double ratio = (reference - previousTime) / (time - previousTime);
+            position = mPreviousRawPositions[axis] + ratio * (mRawPositions[axis] - mPreviousRawPositions[axis]);
+        } else if (time > 0.0) {
+            position += m_measured_js.Velocity()[axis] * (reference - time);
+        }
+        m_measured_js_aligned.Position()[axis] = position - offset_js[axis];
+        m_measured_js_aligned.Velocity()[axis] = m_measured_js.Velocity()[axis];
+    }
+}
+
+bool mtsMaxonEPOS::RobotData::ConfigurePDO(size_t axis)
+{
+    const AxisPDO & pdo = mPDO[axis];
+    const unsigned short communication = static_cast<unsigned short>(0x1800 + pdo.number - 1);
+    const unsigned short mapping = static_cast<unsigned short>(0x1A00 + pdo.number - 1);
+    auto write = [this, axis](unsigned short index, unsigned char subIndex, unsigned int value, unsigned int size) {
+        return WriteObject(axis, index, subIndex, value, size);
+    };
+
+    // Invalidate the PDO while changing its mapping
+    if (!write(communication, 1, 0x80000000 | pdo.cobId, 4)
+        || !write(mapping, 0, 0, 1)) {
+        return false;
+    }
+    for (size_t i = 0; i < pdo.mapping.size(); i++) {
+        if (!write(mapping, static_cast<unsigned char>(i + 1), pdo.mapping[i], 4)) {
+            return false;
+        }
+    }
+    return write(mapping, 0, static_cast<unsigned int>(pdo.mapping.size()), 1)
+        && write(communication, 2, pdo.transmissionType, 1)
+        && write(communication, 3, pdo.inhibitTime, 2)
+        && write(communication, 5, pdo.eventTimer, 2)
+        && write(communication, 1, pdo.cobId, 4);
+}
+
+void mtsMaxonEPOS::RobotData::ReadAxis(size_t axis)
+{
+    // Called from the polling threads, only uses this axis' data
+    AxisFeedback & feedback = mFeedback[axis];
+    feedback.received = 0;
+    feedback.errorCode = 0;
+    feedback.failedCall = mtsMaxonEPOSDriver::NUMBER_OF_CALLS;
+    if (feedback.requested == 0) {
+        return;
+    }
+
+    const AxisPDO & pdo = mPDO[axis];
+    if (pdo.enabled) {
+        unsigned char frame[8];
+        feedback.failedCall = mtsMaxonEPOSDriver::CALL_READ_CAN_FRAME;
+        if (!mDriver->ReadCANFrame(mHandles[axis], pdo.cobId, 8, frame, pdo.timeout, feedback.errorCode)) {
+            return;
+        }
+        const double frameTime = std::chrono::duration<double>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        // Decode the mapped objects, little endian
+        size_t offset = 0;
+        for (size_t i = 0; i < pdo.mapping.size(); i++) {
+            const unsigned int bytes = (pdo.mapping[i] & 0xFF) / 8;
+            unsigned int value = 0;
+            for (unsigned int b = 0; b < bytes; b++) {
+                value |= static_cast<unsigned int>(frame[offset + b]) << (8 * b);
+            }
+            offset += bytes;
+            switch (pdo.mapping[i] >> 16) {
+            case 0x6041:
+                feedback.opState = StatuswordToState(static_cast<unsigned short>(value));
+                feedback.received |= (1 << SIGNAL_STATE);
+                break;
+            case 0x6064:
+                feedback.position = static_cast<int>(value);
+                feedback.positionTime = frameTime;
+                feedback.received |= (1 << SIGNAL_POSITION);
+                break;
+            case 0x6078:
+                feedback.current = static_cast<short>(value);
+                feedback.received |= (1 << SIGNAL_CURRENT);
+                break;
+            }
+        }
+    }
+
+    // SDO reads for requested signals not mapped
+    const unsigned int missing = feedback.requested & ~feedback.received;
+    if (missing & (1 << SIGNAL_STATE)) {
+        feedback.failedCall = mtsMaxonEPOSDriver::CALL_GET_STATE;
+        if (!mDriver->GetState(mHandles[axis], mAxisToNodeIDMap[axis], feedback.opState, feedback.errorCode)) {
+            return;
+        }
+        feedback.received |= (1 << SIGNAL_STATE);
+    }
+    if (missing & (1 << SIGNAL_POSITION)) {
+        feedback.failedCall = mtsMaxonEPOSDriver::CALL_GET_POSITION_IS;
+        // Sampled by the drive between request and response, use the middle
+        const std::chrono::steady_clock::time_point request = std::chrono::steady_clock::now();
+        if (!mDriver->GetPositionIs(mHandles[axis], mAxisToNodeIDMap[axis], feedback.position, feedback.errorCode)) {
+            return;
+        }
+        const std::chrono::steady_clock::time_point response = std::chrono::steady_clock::now();
+        feedback.positionTime = std::chrono::duration<double>(
+            (request + (response - request) / 2).time_since_epoch()).count();
+        feedback.received |= (1 << SIGNAL_POSITION);
+    }
+    if (missing & (1 << SIGNAL_CURRENT)) {
+        feedback.failedCall = mtsMaxonEPOSDriver::CALL_GET_CURRENT_IS;
+        if (!mDriver->GetCurrentIs(mHandles[axis], mAxisToNodeIDMap[axis], feedback.current, feedback.errorCode)) {
+            return;
+        }
+        feedback.received |= (1 << SIGNAL_CURRENT);
+    }
+    feedback.failedCall = mtsMaxonEPOSDriver::NUMBER_OF_CALLS;
+}
+
+void mtsMaxonEPOS::RobotData::ScheduleReads(void)
+{
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        unsigned int requested = 0;
+        for (size_t signal = 0; signal < NUMBER_OF_SIGNALS; signal++) {
+            // Each axis gets its own phase so the reads of a slow signal
+            // are spread evenly; everything is read on the first cycle
+            const unsigned int period = mReadPeriod[signal];
+            const unsigned int phase = static_cast<unsigned int>((axis * period) / mNumAxes);
+            if ((mCycle == 0) || ((mCycle % period) == phase)) {
+                requested |= (1 << signal);
+            }
+        }
+        mFeedback[axis].requested = requested;
+    }
+    mCycle++;
+}
+
+void mtsMaxonEPOS::SetupPolling(void)
+{
+    // Group axes per polling thread
+    std::vector<std::vector<size_t> > groups;
+    std::vector<void *> keys;
+    for (size_t index = 0; index < mAxes.size(); ++index) {
+        const RobotData & robot = *(mAxes[index].robot);
+        const size_t axis = mAxes[index].axis;
+        size_t group = 0;
+        if (mPollingMode == "serial") {
+            group = 0;
+        } else {
+            // "handle": one thread per sub-device, "gateway": one thread per gateway (CAN bus)
+            void * key = (mPollingMode == "handle") ? robot.mHandles[axis]
+                : mGateways[robot.mAxisToGateway[axis]].handle;
+            group = std::find(keys.begin(), keys.end(), key) - keys.begin();
+            if (group == keys.size()) {
+                keys.push_back(key);
+            }
+        }
+        if (group >= groups.size()) {
+            groups.resize(group + 1);
+        }
+        groups[group].push_back(index);
+    }
+    mPoller.Configure(groups, [this](size_t index) { mAxes[index].robot->ReadAxis(mAxes[index].axis); });
+    mPoller.Start();
+    CMN_LOG_CLASS_INIT_VERBOSE << "SetupPolling: " << mPollingMode << " polling using "
+                               << mPoller.NumberOfGroups() << " thread(s)" << std::endl;
+}
+
+void mtsMaxonEPOS::RecordFlightRecorder(double time)
+{
+    if (!mFlightRecorder.IsEnabled()) {
+        return;
+    }
+    mtsMaxonEPOSFlightRecorder::SampleHeader header;
+    header.time = time;
+    header.cycle = static_cast<uint32_t>(mRobots[0]->mCycle);
+    // Worst state of all robots, a fault on any robot is a fault
+    header.operatingState = static_cast<uint32_t>(mRobots[0]->newState);
+    for (size_t index = 1; index < mRobots.size(); ++index) {
+        if (mRobots[index]->newState == prmOperatingState::FAULT) {
+            header.operatingState = static_cast<uint32_t>(prmOperatingState::FAULT);
+        }
+    }
+    for (size_t index = 0; index < mAxes.size(); ++index) {
+        const RobotData & robot = *(mAxes[index].robot);
+        const size_t axis = mAxes[index].axis;
+        const RobotData::AxisFeedback & feedback = robot.mFeedback[axis];
+        mtsMaxonEPOSFlightRecorder::AxisSample & sample = mFlightRecorderAxes[index];
+        sample.position = feedback.position;
+        sample.setpoint = static_cast<float>((robot.mState[axis] == ST_CM)
+                                             ? robot.m_setpoint_js.Effort()[axis]
+                                             : robot.m_setpoint_js.Position()[axis]);
+        sample.current = feedback.current;
+        sample.mode = static_cast<uint8_t>(robot.mState[axis]);
+        sample.state = static_cast<uint8_t>(feedback.opState);
+        sample.errorCode = feedback.errorCode;
+    }
+    mFlightRecorder.Record(header, mFlightRecorderAxes.data());
+}
+
+void mtsMaxonEPOS::DumpFlightRecorder(void)
+{
+    if (!mFlightRecorder.IsEnabled()) {
+        return;
+    }
+    char date[32];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y%m%d-%H%M%S", std::localtime(&now));
+    // One recorder for all robots, named after the component
+    const std::string fileName = mFlightRecorderDirectory + "/" + GetName() + "-flight-" + date + ".bin";
+    const bool saved = mFlightRecorder.Dump(fileName);
+    for (size_t index = 0; index < mRobots.size(); ++index) {
+        RobotData & robot = *mRobots[index];
+        if (saved) {
+            robot.mInterface->SendStatus(robot.name + ": saving flight recorder to " + fileName);
+        } else {
+            robot.mInterface->SendWarning(robot.name + ": flight recorder busy or empty, not saved");
+        }
+    }
+}
+
+void mtsMaxonEPOS::GetLatencyStatistics(vctDoubleMat & statistics) const
+{
+    if (!mTimedDriver) {
+        statistics.SetSize(0, 4);
+        return;
+    }
+    const mtsMaxonEPOSLatencyHistogram & histogram = mTimedDriver->Histogram();
+    statistics.SetSize(histogram.NumberOfKeys() * histogram.NumberOfColumns(), 4);
+    size_t row = 0;
+    for (size_t call = 0; call < histogram.NumberOfKeys(); ++call) {
+        for (size_t axis = 0; axis < histogram.NumberOfColumns(); ++axis, ++row) {
+            unsigned long long count;
+            double p50, p99, max;
+            histogram.GetStatistics(call, axis, count, p50, p99, max);
+            statistics.Element(row, 0) = static_cast<double>(count);
+            statistics.Element(row, 1) = p50;
+            statistics.Element(row, 2) = p99;
+            statistics.Element(row, 3) = max;
+        }
+    }
+}
+
+void mtsMaxonEPOS::GetLatencyStatisticsNames(std::vector<std::string> & names) const
+{
+    names.clear();
+    if (!mTimedDriver) {
+        return;
+    }
+    const mtsMaxonEPOSLatencyHistogram & histogram = mTimedDriver->Histogram();
+    for (size_t call = 0; call < histogram.NumberOfKeys(); ++call) {
+        const std::string callName = mtsMaxonEPOSDriver::CallName(static_cast<mtsMaxonEPOSDriver::Call>(call));
+        for (size_t axis = 0; axis < histogram.NumberOfColumns(); ++axis) {
+            if (axis < mAxes.size()) {
+                // Robot name only needed to tell axes apart
+                const RobotData & robot = *(mAxes[axis].robot);
+                names.push_back(callName + "/"
+                                + ((mRobots.size() > 1) ? (robot.name + "/") : std::string())
+                                + std::to_string(mAxes[axis].axis));
+            } else {
+                names.push_back(callName + "/bus");
+            }
+        }
+    }
+}
+
+void mtsMaxonEPOS::ResetLatencyStatistics(void)
+{
+    if (mTimedDriver) {
+        mTimedDriver->Histogram().Reset();
+    }
+}
+
+void mtsMaxonEPOS::RobotData::ResetErrorCounters(void)
+{
+    mErrors.Reset();
+    mErrors.GetCounters(mErrorCounters);
+    mErrorCountersTotal = 0;
+}
+
+void mtsMaxonEPOS::Close()
+{
+    mPoller.Stop();
+    for (size_t index = 0; index < mRobots.size(); ++index) {
+        mRobots[index]->mDataRecorder.Stop();
+    }
+
+    if (!mDriver) {
+        return;
+    }
+    unsigned int errorCode = 0;
+    // 1) Close sub devices first, gateway handles are closed below
+    for (size_t index = 0; index < mAxes.size(); ++index) {
+        RobotData & robot = *(mAxes[index].robot);
+        const size_t axis = mAxes[index].axis;
+        if (axis >= robot.mHandles.size()) {
+            continue;
+        }
+        void * handle = robot.mHandles[axis];
+        robot.mHandles[axis] = nullptr;
+        if (!handle || (handle == mGateways[robot.mAxisToGateway[axis]].handle)) {
+            continue;
+        }
+        if (!mDriver->CloseSubDevice(handle, errorCode) || errorCode != 0) {
+            CMN_LOG_CLASS_RUN_ERROR
+                << robot.name
+                << "[axis " << axis
+                << "] CloseSubDevice failed (errorCode=" << errorCode << ")\n";
+        }
+    }
+    // 2) Then gateways
+    for (size_t index = 0; index < mGateways.size(); ++index) {
+        GatewayData & gateway = mGateways[index];
+        if (gateway.handle) {
+            if (!mDriver->CloseDevice(gateway.handle, errorCode) || errorCode != 0) {
+                CMN_LOG_CLASS_RUN_ERROR
+                    << "gateway " << gateway.name
+                    << " CloseDevice failed (errorCode=" << errorCode << ")\n";
+            }
+            gateway.handle = nullptr;
+        }
+    }
+}
+
+void mtsMaxonEPOS::RobotData::state_command(const std::string &command)
+{
+    std::string humanReadableMessage;
+    prmOperatingState::StateType newOperatingState;
+    try {
+        if (m_op_state.ValidCommand(prmOperatingState::CommandTypeFromString(command),
+                                    newOperatingState, humanReadableMessage)) {
+            if (command == "enable") {
+                EnableMotorPower();
+                return;
+            }
+            if (command == "disable") {
+                DisableMotorPower();
+                return;
+            }
+            if (command == "home") {
+                offset_js -= m_measured_js.Position();
+                return;
+            }
+            if (command == "unhome") {
+                offset_js.SetAll(0.0);
+                return;
+            }
+            if (command == "pause") {
+                if (m_op_state.State() == prmOperatingState::ENABLED)
+                    hold();   // Stop motion
+                m_op_state.SetState(newOperatingState);
+                return;
+            }
+            if (command == "resume") {
+                m_op_state.SetState(newOperatingState);
+                return;
+            }
+        } else {
+            mInterface->SendWarning(name + ": " + humanReadableMessage);
+        }
+    } catch (std::runtime_error &e) {
+        mInterface->SendWarning(name + ": " + command + " doesn't seem to be a valid state_command (" + e.what() + ")");
+    }
+}
+
+void mtsMaxonEPOS::RobotData::EnableMotorPower(void)
+{
+    if (!mParent) {return;}
+
+    // Drives may have lost their setpoints, send the next ones
+    mServoSentValid.SetAll(false);
+
+    mErrorCode = 0;
+    try {
+
+        for (size_t axis = 0; axis < mNumAxes; ++axis) {
              
             // 2.1) Clear fault
-            int isFault;
-            if (!VCS_GetFaultState(mHandles[axis], mAxisToNodeIDMap[axis], &isFault, DWORD_CAST(&mErrorCode))) {
+            bool isFault;
+            if (!mDriver->GetFaultState(mHandles[axis], mAxisToNodeIDMap[axis], isFault, mErrorCode)) {
                 throw std::runtime_error(
                     "Axis " + std::to_string(axis) +
                     " GetFaultState failed (err=" + std::to_string(mErrorCode) + ")"
                 );
             }
             if (isFault) {
-                if (!VCS_ClearFault(mHandles[axis], mAxisToNodeIDMap[axis], DWORD_CAST(&mErrorCode))) {
+                if (!mDriver->ClearFault(mHandles[axis], mAxisToNodeIDMap[axis], mErrorCode)) {
                     throw std::runtime_error(
                         "Axis " + std::to_string(axis) +
                         " ClearFault failed (err=" + std::to_string(mErrorCode) + ")"
@@ -388,15 +1743,15 @@ void mtsMaxonEPOS::RobotData::EnableMotorPower(void)
             }
 
             // 2.2) Enable power
-            int isOn;
-            if (!VCS_GetEnableState(mHandles[axis], mAxisToNodeIDMap[axis], &isOn, DWORD_CAST(&mErrorCode))) {
+            bool isOn;
+            if (!mDriver->GetEnableState(mHandles[axis], mAxisToNodeIDMap[axis], isOn, mErrorCode)) {
                 throw std::runtime_error(
                     "Axis " + std::to_string(axis) +
                     " GetEnableState failed (err=" + std::to_string(mErrorCode) + ")"
                 );
             }
             if (!isOn) {
-                if (!VCS_SetEnableState(mHandles[axis], mAxisToNodeIDMap[axis], DWORD_CAST(&mErrorCode))) {
+                if (!mDriver->SetEnableState(mHandles[axis], mAxisToNodeIDMap[axis], mErrorCode)) {
                     throw std::runtime_error(
                         "Axis " + std::to_string(axis) +
                         " SetEnableState failed (err=" + std::to_string(mErrorCode) + ")"
@@ -415,12 +1770,20 @@ void mtsMaxonEPOS::RobotData::DisableMotorPower(void)
 {
     if (!mParent) {return;}
 
+    mServoPending = SERVO_NONE;
+
+    // Synchronized move not started yet, the buffered controlword would
+    // enable the drives again at the next SYNC
+    if (mMoveStartPending) {
+        CancelMove(0x0006);
+    }
+
     mErrorCode = 0;
     try {
         for (size_t axis = 0; axis < mNumAxes; ++axis) {
             // Find enable state
-            int isOn;
-            if (!VCS_GetEnableState(mHandles[axis], mAxisToNodeIDMap[axis], &isOn, DWORD_CAST(&mErrorCode))) {
+            bool isOn;
+            if (!mDriver->GetEnableState(mHandles[axis], mAxisToNodeIDMap[axis], isOn, mErrorCode)) {
                 throw std::runtime_error(
                     "Axis " + std::to_string(axis) +
                     " GetEnableState failed (err=" + std::to_string(mErrorCode) + ")"
@@ -428,7 +1791,7 @@ void mtsMaxonEPOS::RobotData::DisableMotorPower(void)
             }
             // Disable only enable state
             if (isOn) {
-                if (!VCS_SetDisableState(mHandles[axis], mAxisToNodeIDMap[axis], DWORD_CAST(&mErrorCode))) {
+                if (!mDriver->SetDisableState(mHandles[axis], mAxisToNodeIDMap[axis], mErrorCode)) {
                     throw std::runtime_error(
                         "Axis " + std::to_string(axis) +
                         " SetDisableState failed (err=" + std::to_string(mErrorCode) + ")"
@@ -450,36 +1813,56 @@ void mtsMaxonEPOS::RobotData::servo_jv(const prmVelocityJointSet & jtvel)
     if (!CheckStateEnabled("servo_jv"))
         return;
 
-    mErrorCode = 0;
-    try {
-        for (size_t axis = 0; axis < mNumAxes; ++axis) {
-            // 2.1) Active Velocity Mode.
-            if (mState[axis] != ST_VM) {
-                if (!VCS_ActivateVelocityMode(mHandles[axis], mAxisToNodeIDMap[axis], DWORD_CAST(&mErrorCode))) {
-                    throw std::runtime_error(
-                        "Axis " + std::to_string(axis) +
-                        " ActivateVelocityMode failed (err=" +
-                        std::to_string(mErrorCode) + ")"
-                    );
-                }
-                mState[axis] = ST_VM;
-            }
+    mInterpolating = false;
 
-            // 2.2) Velocity set‐point
-            if (!VCS_SetVelocityMust(mHandles[axis], mAxisToNodeIDMap[axis], jtvel.Goal()[axis], DWORD_CAST(&mErrorCode))) {
-                throw std::runtime_error(
-                    "Axis " + std::to_string(axis) +
-                    " SetVelocityMust failed (err=" +
-                    std::to_string(mErrorCode) + ")"
-                );
+    // Trajectory playback, stop sending setpoints
+    if (mPlaybackPlaying) {
+        playback_pause();
+    }
+
+    // Coalescing, only the last servo command of the cycle is sent
+    if (mServoCoalesce) {
+        if (mServoPending != SERVO_NONE) {
+            mServoDropped++;
+        }
+        mServoPending = SERVO_JV;
+        mServoPendingGoal.Assign(jtvel.Goal());
+        return;
+    }
+    SendServoJv(jtvel.Goal());
+}
+
+void mtsMaxonEPOS::RobotData::SendServoJv(const vctDoubleVec & goal)
+{
+    // Called at the servo rate, failures are counted and reported by Run
+    mErrorCode = 0;
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        // 2.1) Active Velocity Mode.
+        if (mState[axis] != ST_VM) {
+            if (!mDriver->ActivateVelocityMode(mHandles[axis], mAxisToNodeIDMap[axis], mErrorCode)) {
+                mErrors.Record(mtsMaxonEPOSDriver::CALL_ACTIVATE_VELOCITY_MODE, axis, mErrorCode);
+                return;
             }
+            mState[axis] = ST_VM;
+            mServoSentValid[axis] = false;
+            m_setpoint_js.Effort()[axis] = 0.0;
+        }
 
-            m_setpoint_js.Position()[axis] = 0.0;
+        // 2.2) Velocity set‐point, skipped if close to the last one sent
+        const int velocity = static_cast<int>(goal[axis]);
+        if (mServoSentValid[axis]
+            && (std::abs(velocity - mServoSent[axis]) <= mServoVelocityDeadband)) {
+            mServoSkipped[axis]++;
+            continue;
         }
+        if (!mDriver->SetVelocityMust(mHandles[axis], mAxisToNodeIDMap[axis], velocity, mErrorCode)) {
+            mErrors.Record(mtsMaxonEPOSDriver::CALL_SET_VELOCITY_MUST, axis, mErrorCode);
+            return;
+        }
+        mServoSent[axis] = velocity;
+        mServoSentValid[axis] = true;
 
-    }
-    catch (const std::runtime_error & e) {
-        mInterface->SendError(name + ": servo_jv (" + e.what() + ")");
+        m_setpoint_js.Position()[axis] = 0.0;
     }
 }
 
@@ -491,36 +1874,135 @@ void mtsMaxonEPOS::RobotData::servo_jp(const prmPositionJointSet & jtpos)
     if (!CheckStateEnabled("servo_jp"))
         return;
 
-    mErrorCode = 0;
+    mInterpolating = false;
 
-    try {
-        // Iterate through each axis，Position mode direct control.
-        for (size_t axis = 0; axis < mNumAxes; ++axis) {
-            // 2.1 Position Mode（CSP）
-            if(mState[axis] != ST_PM){
-                if (!VCS_ActivatePositionMode(mHandles[axis], mAxisToNodeIDMap[axis], DWORD_CAST(&mErrorCode))) {
-                    throw std::runtime_error(
-                        "ActivatePositionMode failed on axis " + std::to_string(axis) +
-                        " (err=" + std::to_string(mErrorCode) + ")"
-                    );
-                }
-                mState[axis] = ST_PM;
+    // Trajectory playback, stop sending setpoints
+    if (mPlaybackPlaying) {
+        playback_pause();
+    }
+
+    // Coalescing, only the last servo command of the cycle is sent
+    if (mServoCoalesce) {
+        if (mServoPending != SERVO_NONE) {
+            mServoDropped++;
+        }
+        mServoPending = SERVO_JP;
+        mServoPendingGoal.Assign(jtpos.Goal());
+        return;
+    }
+    SendServoJp(jtpos.Goal());
+}
+
+void mtsMaxonEPOS::RobotData::SendServoJp(const vctDoubleVec & goal)
+{
+    // Called at the servo rate, failures are counted and reported by Run
+    mErrorCode = 0;
+    // Iterate through each axis，Position mode direct control.
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        // 2.1 Position Mode（CSP）
+        if(mState[axis] != ST_PM){
+            if (!mDriver->ActivatePositionMode(mHandles[axis], mAxisToNodeIDMap[axis], mErrorCode)) {
+                mErrors.Record(mtsMaxonEPOSDriver::CALL_ACTIVATE_POSITION_MODE, axis, mErrorCode);
+                return;
             }
+            mState[axis] = ST_PM;
+            mServoSentValid[axis] = false;
+            m_setpoint_js.Effort()[axis] = 0.0;
+        }
 
-            // 2.2 Position Must
-            if (!VCS_SetPositionMust(mHandles[axis], mAxisToNodeIDMap[axis], jtpos.Goal()[axis], DWORD_CAST(&mErrorCode))) {
-                throw std::runtime_error(
-                    "SetPositionMust failed on axis " + std::to_string(axis) +
-                    " (err=" + std::to_string(mErrorCode) + ")"
-                );
+        // 2.2 Position Must, skipped if close to the last one sent
+        const int position = static_cast<int>(goal[axis]);
+        if (mServoSentValid[axis]
+            && (std::abs(position - mServoSent[axis]) <= mServoPositionDeadband)) {
+            mServoSkipped[axis]++;
+            continue;
+        }
+        if (!mDriver->SetPositionMust(mHandles[axis], mAxisToNodeIDMap[axis], position, mErrorCode)) {
+            mErrors.Record(mtsMaxonEPOSDriver::CALL_SET_POSITION_MUST, axis, mErrorCode);
+            return;
+        }
+        mServoSent[axis] = position;
+        mServoSentValid[axis] = true;
+
+        m_setpoint_js.Position()[axis] = goal[axis];
+    }
+}
+
+// CM
+void mtsMaxonEPOS::RobotData::servo_jf(const prmForceTorqueJointSet & jtf)
+{
+    if (!mParent) {return;}
+
+    if (!CheckStateEnabled("servo_jf"))
+        return;
+
+    mInterpolating = false;
+
+    // Trajectory playback, stop sending setpoints
+    if (mPlaybackPlaying) {
+        playback_pause();
+    }
+
+    // Coalescing, only the last servo command of the cycle is sent
+    if (mServoCoalesce) {
+        if (mServoPending != SERVO_NONE) {
+            mServoDropped++;
+        }
+        mServoPending = SERVO_JF;
+        mServoPendingGoal.Assign(jtf.ForceTorque());
+        return;
+    }
+    SendServoJf(jtf.ForceTorque());
+}
+
+void mtsMaxonEPOS::RobotData::SendServoJf(const vctDoubleVec & goal)
+{
+    // Called at the servo rate, failures are counted and reported by Run
+    mErrorCode = 0;
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        // Current mode is activated once, then only the setpoints are sent
+        if (mState[axis] != ST_CM) {
+            if (!mDriver->ActivateCurrentMode(mHandles[axis], mAxisToNodeIDMap[axis], mErrorCode)) {
+                mErrors.Record(mtsMaxonEPOSDriver::CALL_ACTIVATE_CURRENT_MODE, axis, mErrorCode);
+                return;
             }
+            mState[axis] = ST_CM;
+            mServoSentValid[axis] = false;
+        }
 
-            m_setpoint_js.Position()[axis] = jtpos.Goal()[axis];
+        // Current set-point (mA, saturated to the drive range), skipped if
+        // close to the last one sent
+        const short current = static_cast<short>(std::max(-32768.0, std::min(32767.0, goal[axis])));
+        if (mServoSentValid[axis]
+            && (std::abs(current - mServoSent[axis]) <= mServoCurrentDeadband)) {
+            mServoSkipped[axis]++;
+            continue;
         }
+        if (!mDriver->SetCurrentMust(mHandles[axis], mAxisToNodeIDMap[axis], current, mErrorCode)) {
+            mErrors.Record(mtsMaxonEPOSDriver::CALL_SET_CURRENT_MUST, axis, mErrorCode);
+            return;
+        }
+        mServoSent[axis] = current;
+        mServoSentValid[axis] = true;
 
+        m_setpoint_js.Effort()[axis] = current;
     }
-    catch (const std::runtime_error & e) {
-        mInterface->SendError(name + ": servo_jp (" + e.what() + ")");
+}
+
+void mtsMaxonEPOS::RobotData::SendPendingServo(void)
+{
+    const ServoCommand pending = mServoPending;
+    mServoPending = SERVO_NONE;
+    // State may have changed since the command was queued
+    if ((pending == SERVO_NONE) || (m_op_state.State() != prmOperatingState::ENABLED)) {
+        return;
+    }
+    if (pending == SERVO_JP) {
+        SendServoJp(mServoPendingGoal);
+    } else if (pending == SERVO_JV) {
+        SendServoJv(mServoPendingGoal);
+    } else {
+        SendServoJf(mServoPendingGoal);
     }
 }
 
@@ -532,12 +2014,29 @@ void mtsMaxonEPOS::RobotData::move_jp(const prmPositionJointSet & jtpos)
     if (!CheckStateEnabled("move_jp"))
         return;
 
+    mInterpolating = false;
+
+    // Trajectory playback, stop sending setpoints
+    if (mPlaybackPlaying) {
+        playback_pause();
+    }
+
+    mServoPending = SERVO_NONE;
+
     mErrorCode = 0;
     try {
+        // Profile for this move, scaled so all axes arrive at the same time
+        mMoveProfile.Assign(mProfile);
+        if (mMoveScaleProfiles && !ScaleMoveProfiles(jtpos.Goal())) {
+            throw std::runtime_error("profile read failed (err=" + std::to_string(mErrorCode) + ")");
+        }
+
+        typedef std::chrono::steady_clock clock;
+        clock::time_point first;
         for (size_t axis = 0; axis < mNumAxes; ++axis) {
             // 1) Activate Profile Position Mode
             if(mState[axis] != ST_PPM){
-                if (!VCS_ActivateProfilePositionMode(mHandles[axis], mAxisToNodeIDMap[axis], DWORD_CAST(&mErrorCode))) {
+                if (!mDriver->ActivateProfilePositionMode(mHandles[axis], mAxisToNodeIDMap[axis], mErrorCode)) {
                     throw std::runtime_error(
                         "Axis " + std::to_string(axis) +
                         " ActivateProfilePositionMode failed (err=" +
@@ -545,29 +2044,337 @@ void mtsMaxonEPOS::RobotData::move_jp(const prmPositionJointSet & jtpos)
                     );
                 }
                 mState[axis] = ST_PPM;
+                m_setpoint_js.Effort()[axis] = 0.0;
             }
-            
-            // 2) Send command
-            if (!VCS_MoveToPosition(mHandles[axis], mAxisToNodeIDMap[axis],
-                                    jtpos.Goal()[axis],
-                                    /*Absolute*/  1,
-                                    /*Immediate*/ 1,
-                                    DWORD_CAST(&mErrorCode))) {
+
+            // 2) Profile changes not written yet (e.g. failed write)
+            if (!WriteProfile(axis, mMoveProfile)) {
                 throw std::runtime_error(
                     "Axis " + std::to_string(axis) +
-                    " MoveToPosition failed (err=" +
+                    " profile write failed (err=" +
                     std::to_string(mErrorCode) + ")"
                 );
             }
 
-            m_setpoint_js.Position()[axis] = jtpos.Goal()[axis];
-        }
-    }
-    catch (const std::runtime_error & e) {
-        mInterface->SendError(name + ": move_jp (" + e.what() + ")");
-    }
-}
-
+            // 3) Send command, or stage target and clear new setpoint for
+            // the synchronized start
+            if (mMoveSynchronization == MOVE_SYNC_NONE) {
+                if (!mDriver->MoveToPosition(mHandles[axis], mAxisToNodeIDMap[axis],
+                                        jtpos.Goal()[axis],
+                                        /*Absolute*/  true,
+                                        /*Immediate*/ true,
+                                        mErrorCode)) {
+                    throw std::runtime_error(
+                        "Axis " + std::to_string(axis) +
+                        " MoveToPosition failed (err=" +
+                        std::to_string(mErrorCode) + ")"
+                    );
+                }
+                const clock::time_point now = clock::now();
+                if (axis == 0) {
+                    first = now;
+                }
+                mMoveStartTimes[axis] = std::chrono::duration<double>(now - first).count();
+            } else {
+                const int target = static_cast<int>(jtpos.Goal()[axis]);
+                const unsigned short controlword = 0x000F;
+                unsigned int written;
+                if (!mDriver->SetObject(mHandles[axis], mAxisToNodeIDMap[axis], 0x607A, 0,
+                                        &target, 4, written, mErrorCode)
+                    || !mDriver->SetObject(mHandles[axis], mAxisToNodeIDMap[axis], 0x6040, 0,
+                                           &controlword, 2, written, mErrorCode)) {
+                    throw std::runtime_error(
+                        "Axis " + std::to_string(axis) +
+                        " target write failed (err=" +
+                        std::to_string(mErrorCode) + ")"
+                    );
+                }
+            }
+
+            m_setpoint_js.Position()[axis] = jtpos.Goal()[axis];
+        }
+
+        // 4) Start all staged axes
+        if ((mMoveSynchronization != MOVE_SYNC_NONE) && !TriggerMove()) {
+            throw std::runtime_error("start frame failed (err=" + std::to_string(mErrorCode) + ")");
+        }
+        if (!mMoveStartPending) {
+            mMoveSkew = mMoveStartTimes.MaxElement() - mMoveStartTimes.MinElement();
+        }
+    }
+    catch (const std::runtime_error & e) {
+        mInterface->SendError(name + ": move_jp (" + e.what() + ")");
+    }
+}
+
+mtsMaxonEPOSKinematics::Status
+mtsMaxonEPOS::RobotData::SolveIK(const vctFrm3 & goal, bool warmStart, double budget)
+{
+    typedef std::chrono::steady_clock clock;
+    const clock::time_point start = clock::now();
+    const double startTime = std::chrono::duration<double>(start.time_since_epoch()).count();
+    // Stream of servo_cp, continue from the last solution
+    if (!warmStart || (mIKLastSolve < 0.0) || (startTime - mIKLastSolve > IKWarmStartPeriod)) {
+        mKinematics.JointsFromMotors(m_measured_js.Position(), mIKJoints);
+    }
+    unsigned int iterations;
+    const mtsMaxonEPOSKinematics::Status status =
+        mKinematics.InverseKinematics(goal, mIKJoints, iterations, mIKResidual, budget);
+    const clock::time_point end = clock::now();
+    mIKLastSolve = std::chrono::duration<double>(end.time_since_epoch()).count();
+
+    // Axes not used by the kinematics stay at their measured position
+    mIKGoal.Goal().Assign(m_measured_js.Position());
+    mKinematics.MotorsFromJoints(mIKJoints, mIKGoal.Goal());
+    mIKGoal.Goal() += offset_js;
+
+    const double time = std::chrono::duration<double>(end - start).count();
+    const double solves = mIKStatistics[IK_SOLVES] + 1.0;
+    mIKStatistics[IK_SOLVES] = solves;
+    mIKStatistics[IK_CONVERGED + status] += 1.0;
+    mIKStatistics[IK_LAST_ITERATIONS] = iterations;
+    mIKStatistics[IK_MEAN_ITERATIONS] += (iterations - mIKStatistics[IK_MEAN_ITERATIONS]) / solves;
+    mIKStatistics[IK_MAX_ITERATIONS] = std::max(mIKStatistics[IK_MAX_ITERATIONS], static_cast<double>(iterations));
+    mIKStatistics[IK_LAST_TIME] = time;
+    mIKStatistics[IK_MEAN_TIME] += (time - mIKStatistics[IK_MEAN_TIME]) / solves;
+    mIKStatistics[IK_MAX_TIME] = std::max(mIKStatistics[IK_MAX_TIME], time);
+    return status;
+}
+
+void mtsMaxonEPOS::RobotData::ResetIKStatistics(void)
+{
+    mIKStatistics.SetAll(0.0);
+}
+
+void mtsMaxonEPOS::RobotData::servo_cp(const prmPositionCartesianSet & cppos)
+{
+    if (!mParent) {return;}
+
+    if (!CheckStateEnabled("servo_cp"))
+        return;
+
+    // Best solution within the time budget, even if not converged, the
+    // next servo_cp continues from it
+    SolveIK(cppos.Goal(), true, -1.0);
+    servo_jp(mIKGoal);
+}
+
+void mtsMaxonEPOS::RobotData::move_cp(const prmPositionCartesianSet & cppos)
+{
+    if (!mParent) {return;}
+
+    if (!CheckStateEnabled("move_cp"))
+        return;
+
+    // Not in the servo loop, only bounded by the number of iterations
+    const mtsMaxonEPOSKinematics::Status status = SolveIK(cppos.Goal(), false, 0.0);
+    if ((status == mtsMaxonEPOSKinematics::ITERATIONS) || (status == mtsMaxonEPOSKinematics::BUDGET)) {
+        mInterface->SendError(name + ": move_cp, inverse kinematics didn't converge (residual="
+                              + std::to_string(mIKResidual) + ")");
+        return;
+    }
+    if (status == mtsMaxonEPOSKinematics::STALLED) {
+        mInterface->SendWarning(name + ": move_cp, goal not reachable, moving to closest pose (residual="
+                                + std::to_string(mIKResidual) + ")");
+    }
+    move_jp(mIKGoal);
+}
+
+// Duration of a trapezoidal profile (s), distance in turns, velocity in rpm
+// and accelerations in rpm/s; triangular if the velocity isn't reached
+static double ProfileDuration(double distance, double velocity, double acceleration, double deceleration)
+{
+    const double v = velocity / 60.0;
+    const double a = acceleration / 60.0;
+    const double d = deceleration / 60.0;
+    if (distance >= v * v / (2.0 * a) + v * v / (2.0 * d)) {
+        return distance / v + v / (2.0 * a) + v / (2.0 * d);
+    }
+    const double peak = std::sqrt(2.0 * distance * a * d / (a + d));
+    return peak / a + peak / d;
+}
+
+bool mtsMaxonEPOS::RobotData::ScaleMoveProfiles(const vctDoubleVec & goal)
+{
+    // Profile parameters left to the drive are read once and kept, so the
+    // unscaled values can be restored by the next moves
+    static const unsigned short indices[NUMBER_OF_PROFILE_PARAMETERS] = { 0x6081, 0x6083, 0x6084 };
+    mtsMaxonEPOSObjectDictionary::Object object;
+    object.subIndex = 0;
+    object.size = 4;
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        for (size_t parameter = 0; parameter < NUMBER_OF_PROFILE_PARAMETERS; ++parameter) {
+            if (mProfile.Element(axis, parameter) > 0.0) {
+                continue;
+            }
+            object.index = indices[parameter];
+            unsigned int value;
+            if (!mParent->mObjectDictionary.Read(mFirstAxis + axis, object, value, mErrorCode)) {
+                return false;
+            }
+            mProfile.Element(axis, parameter) = std::max(1u, value);
+        }
+    }
+    mMoveProfile.Assign(mProfile);
+
+    // Slower axes keep their profile, faster ones are slowed down: scaling
+    // the velocity by k and the accelerations by k^2 divides the duration by k
+    std::vector<double> durations(mNumAxes);
+    double longest = 0.0;
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        const double current = m_measured_js.Position()[axis] + offset_js[axis];
+        const double distance = std::abs(goal[axis] - current) / mCountsPerTurn[axis];
+        durations[axis] = ProfileDuration(distance,
+                                          mProfile.Element(axis, PROFILE_VELOCITY),
+                                          mProfile.Element(axis, PROFILE_ACCELERATION),
+                                          mProfile.Element(axis, PROFILE_DECELERATION));
+        longest = std::max(longest, durations[axis]);
+    }
+    if (longest <= 0.0) {
+        return true;
+    }
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        const double k = durations[axis] / longest;
+        if (k <= 0.0) {
+            continue;
+        }
+        mMoveProfile.Element(axis, PROFILE_VELOCITY) = std::max(1.0, std::round(k * mProfile.Element(axis, PROFILE_VELOCITY)));
+        mMoveProfile.Element(axis, PROFILE_ACCELERATION) = std::max(1.0, std::round(k * k * mProfile.Element(axis, PROFILE_ACCELERATION)));
+        mMoveProfile.Element(axis, PROFILE_DECELERATION) = std::max(1.0, std::round(k * k * mProfile.Element(axis, PROFILE_DECELERATION)));
+    }
+    return true;
+}
+
+bool mtsMaxonEPOS::RobotData::TriggerMove(void)
+{
+    typedef std::chrono::steady_clock clock;
+    // Controlword with new setpoint and change set immediately, absolute
+    const unsigned char start[2] = { 0x3F, 0x00 };
+    // Time each gateway's start frame (controlword or SYNC) was sent
+    const size_t numberOfGateways = mParent->mGateways.size();
+    std::vector<double> gatewayTimes(numberOfGateways, -1.0);
+    const clock::time_point first = clock::now();
+    if (mMoveSynchronization == MOVE_SYNC_SYNC) {
+        // One synchronous RxPDO per node, buffered by the nodes until the
+        // SYNC sent at the start of the next Run.  A SYNC sent now would
+        // also trigger the synchronous TxPDOs in the middle of the cycle.
+        for (size_t axis = 0; axis < mNumAxes; ++axis) {
+            const unsigned short cobId = static_cast<unsigned short>(0x100 * (mMoveRxPDO + 1) + mAxisToNodeIDMap[axis]);
+            if (!mDriver->SendCANFrame(mParent->mGateways[mAxisToGateway[axis]].handle, cobId, 2, start, mErrorCode)) {
+                return false;
+            }
+        }
+        for (size_t axis = 0; axis < mNumAxes; ++axis) {
+            mParent->mGateways[mAxisToGateway[axis]].syncPending = true;
+        }
+        mMoveStartPending = true;
+        return true;
+    }
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        const size_t gateway = mAxisToGateway[axis];
+        if (gatewayTimes[gateway] < 0.0) {
+            if (!mDriver->SendCANFrame(mParent->mGateways[gateway].handle, mMoveCobId, 2, start, mErrorCode)) {
+                return false;
+            }
+            gatewayTimes[gateway] = std::chrono::duration<double>(clock::now() - first).count();
+        }
+    }
+    // Relative to the first start frame
+    const double earliest = gatewayTimes[mAxisToGateway[0]];
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        mMoveStartTimes[axis] = gatewayTimes[mAxisToGateway[axis]] - earliest;
+    }
+    return true;
+}
+
+void mtsMaxonEPOS::RobotData::UpdateMoveStartTimes(void)
+{
+    mMoveStartPending = false;
+    const double earliest = mParent->mGateways[mAxisToGateway[0]].syncTime;
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        mMoveStartTimes[axis] = mParent->mGateways[mAxisToGateway[axis]].syncTime - earliest;
+    }
+    mMoveSkew = mMoveStartTimes.MaxElement() - mMoveStartTimes.MinElement();
+}
+
+void mtsMaxonEPOS::RobotData::CancelMove(unsigned short controlword)
+{
+    // Controlword without new setpoint, replaces the start buffered by the nodes
+    const unsigned char keep[2] = { static_cast<unsigned char>(controlword & 0xFF),
+                                    static_cast<unsigned char>(controlword >> 8) };
+    mMoveStartPending = false;
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        const unsigned short cobId = static_cast<unsigned short>(0x100 * (mMoveRxPDO + 1) + mAxisToNodeIDMap[axis]);
+        if (!mDriver->SendCANFrame(mParent->mGateways[mAxisToGateway[axis]].handle, cobId, 2, keep, mErrorCode)) {
+            mInterface->SendWarning(name + ": " +
+                " axis " + std::to_string(axis) +
+                " failed to cancel synchronized move (err=" + std::to_string(mErrorCode) + ")");
+        }
+    }
+}
+
+void mtsMaxonEPOS::RobotData::interpolate_jp(const prmPositionJointSet & jtpos)
+{
+    if (!mParent) {return;}
+
+    if (!CheckStateEnabled("interpolate_jp"))
+        return;
+
+    if (jtpos.Goal().size() != mNumAxes) {
+        mInterface->SendError(name + ": interpolate_jp: expected " + std::to_string(mNumAxes) + " positions");
+        return;
+    }
+
+    mServoPending = SERVO_NONE;
+    if (mPlaybackPlaying) {
+        playback_pause();
+    }
+
+    // Start from the last setpoint sent in position mode, or the measured
+    // position; when already interpolating, continue from the current state
+    if (!mInterpolating) {
+        for (size_t axis = 0; axis < mNumAxes; ++axis) {
+            const double start = ((mState[axis] == ST_PM) && mServoSentValid[axis])
+                ? static_cast<double>(mServoSent[axis])
+                : m_measured_js.Position()[axis] + offset_js[axis];
+            mInterpolation.Reset(axis, start);
+        }
+        mInterpolationLastUpdate = -1.0;
+        mInterpolating = true;
+    }
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        mInterpolation.SetGoal(axis, jtpos.Goal()[axis]);
+    }
+}
+
+void mtsMaxonEPOS::RobotData::UpdateInterpolation(double now)
+{
+    if (m_op_state.State() != prmOperatingState::ENABLED) {
+        mInterface->SendWarning(name + ": interpolate_jp stopped, robot not enabled");
+        mInterpolating = false;
+        return;
+    }
+
+    // First cycle sends the starting point
+    const double dt = (mInterpolationLastUpdate >= 0.0) ? (now - mInterpolationLastUpdate) : 0.0;
+    mInterpolationLastUpdate = now;
+    const bool atGoal = mInterpolation.Update(dt);
+
+    vctDoubleVec & goal = mInterpolationSetpoint.Goal();
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        goal[axis] = std::round(mInterpolation.Position(axis));
+    }
+    SendServoJp(goal);
+    if (mErrorCode != 0) {
+        mInterface->SendWarning(name + ": interpolate_jp stopped after setpoint error");
+        mInterpolating = false;
+        return;
+    }
+    if (atGoal) {
+        mInterpolating = false;
+    }
+}
+
 void mtsMaxonEPOS::RobotData::hold(void)
 {
     if (!mParent) {return;}
@@ -575,6 +2382,47 @@ void mtsMaxonEPOS::RobotData::hold(void)
     if (!CheckStateEnabled("hold"))
         return;
 
+    mInterpolating = false;
+
+    // Drop servo command not sent yet
+    mServoPending = SERVO_NONE;
+
+    // Trajectory playback, stop sending setpoints
+    if (mPlaybackPlaying) {
+        playback_pause();
+    }
+
+    // Interpolated position mode, stop trajectory and drop queued points;
+    // other axes are halted below if the activation failed part way
+    const size_t axesInIpm = NumberOfAxesInIpm();
+    if (axesInIpm > 0) {
+        ipm_stop();
+        if (axesInIpm == mNumAxes) {
+            return;
+        }
+    }
+
+    // Current mode, remove the current even if the axes are not moving
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        if ((mState[axis] != ST_CM) || mActuatorState.MotorOff()[axis]) {
+            continue;
+        }
+        if (!mDriver->SetCurrentMust(mHandles[axis], mAxisToNodeIDMap[axis], 0, mErrorCode)) {
+            mInterface->SendWarning(name + ": " +
+                " axis " + std::to_string(axis) +
+                " SetCurrentMust(0) failed (err=" + std::to_string(mErrorCode) + ")");
+            continue;
+        }
+        mServoSent[axis] = 0;
+        mServoSentValid[axis] = true;
+        m_setpoint_js.Effort()[axis] = 0.0;
+    }
+
+    // Synchronized move not started yet
+    if (mMoveStartPending) {
+        CancelMove(0x000F);
+    }
+
     // Return if all stop
     if (!mActuatorState.InMotion().Any()) {
         return;
@@ -587,7 +2435,7 @@ void mtsMaxonEPOS::RobotData::hold(void)
         switch (mState[axis]) {
             case ST_PVM:
                 // Velocity Profile mode
-                if (!VCS_HaltVelocityMovement(mHandles[axis], mAxisToNodeIDMap[axis], DWORD_CAST(&mErrorCode))) {
+                if (!mDriver->HaltVelocityMovement(mHandles[axis], mAxisToNodeIDMap[axis], mErrorCode)) {
                     mInterface->SendWarning(name + ": " +
                         " axis " + std::to_string(axis) +
                         " HaltVelocityMovement failed (err=" + std::to_string(mErrorCode) + ")");
@@ -596,7 +2444,7 @@ void mtsMaxonEPOS::RobotData::hold(void)
 
             case ST_PPM:
                 // Position Profile Mode
-                if (!VCS_HaltPositionMovement(mHandles[axis], mAxisToNodeIDMap[axis], DWORD_CAST(&mErrorCode))) {
+                if (!mDriver->HaltPositionMovement(mHandles[axis], mAxisToNodeIDMap[axis], mErrorCode)) {
                     mInterface->SendWarning(name + ": " +
                         " axis " + std::to_string(axis) +
                         " HaltPositionMovement(default) failed (err=" + std::to_string(mErrorCode) + ")");
@@ -605,11 +2453,16 @@ void mtsMaxonEPOS::RobotData::hold(void)
 
             case ST_VM:
                 // Velocity mode
-                if (!VCS_SetVelocityMust(mHandles[axis], mAxisToNodeIDMap[axis], 0, DWORD_CAST(&mErrorCode))) {
+                if (!mDriver->SetVelocityMust(mHandles[axis], mAxisToNodeIDMap[axis], 0, mErrorCode)) {
                     mInterface->SendWarning(name + ": " +
                         " axis " + std::to_string(axis) +
                         " HaltVelocity(default) failed (err=" + std::to_string(mErrorCode) + ")");
+                    mServoSentValid[axis] = false;
+                    break;
                 }
+                // Next servo_jv is compared to the 0 sent
+                mServoSent[axis] = 0;
+                mServoSentValid[axis] = true;
                 break;
         }
     }
@@ -619,28 +2472,514 @@ void mtsMaxonEPOS::RobotData::SetPositionProfile(
     const vctDoubleVec & profileVelocity,
     const vctDoubleVec & profileAcceleration,
     const vctDoubleVec & profileDeceleration)
+{
+    vctDoubleMat profile;
+    profile.SetSize(mNumAxes, NUMBER_OF_PROFILE_PARAMETERS);
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        profile.Element(axis, PROFILE_VELOCITY) = profileVelocity[axis];
+        profile.Element(axis, PROFILE_ACCELERATION) = profileAcceleration[axis];
+        profile.Element(axis, PROFILE_DECELERATION) = profileDeceleration[axis];
+    }
+    configure_profile(profile);
+}
+
+void mtsMaxonEPOS::RobotData::configure_profile(const vctDoubleMat & profile)
 {
     if (!mParent) {return;}
 
+    if ((profile.rows() != mNumAxes) || (profile.cols() != NUMBER_OF_PROFILE_PARAMETERS)) {
+        mInterface->SendError(name + ": configure_profile, expected " + std::to_string(mNumAxes)
+                              + " rows (one per axis) of velocity, acceleration and deceleration");
+        return;
+    }
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        for (size_t parameter = 0; parameter < NUMBER_OF_PROFILE_PARAMETERS; ++parameter) {
+            if (profile.Element(axis, parameter) < 0.0) {
+                mInterface->SendError(name + ": configure_profile, values can't be negative");
+                return;
+            }
+        }
+    }
+
+    // Requested values are kept even if the write fails, move_jp retries
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        for (size_t parameter = 0; parameter < NUMBER_OF_PROFILE_PARAMETERS; ++parameter) {
+            if (profile.Element(axis, parameter) > 0.0) {
+                mProfile.Element(axis, parameter) = profile.Element(axis, parameter);
+            }
+        }
+    }
+
     mErrorCode = 0;
     try {
         for (size_t axis = 0; axis < mNumAxes; ++axis) {
-            if (mActuatorState.MotorOff()[axis]) {
-                continue;
+            if (!WriteProfile(axis, mProfile)) {
+                throw std::runtime_error(
+                    "Axis " + std::to_string(axis) +
+                    " profile write failed (err=" +
+                    std::to_string(mErrorCode) + ")"
+                );
+            }
+        }
+    }
+    catch (const std::runtime_error & e) {
+        mInterface->SendError(name + ": configure_profile (" + e.what() + ")");
+    }
+}
+
+bool mtsMaxonEPOS::RobotData::WriteProfile(size_t axis, const vctDoubleMat & profile)
+{
+    // Profile velocity, acceleration and deceleration objects (UNSIGNED32),
+    // the object dictionary only writes values that changed
+    static const unsigned short indices[NUMBER_OF_PROFILE_PARAMETERS] = { 0x6081, 0x6083, 0x6084 };
+    mtsMaxonEPOSObjectDictionary::Object object;
+    object.subIndex = 0;
+    object.size = 4;
+    for (size_t parameter = 0; parameter < NUMBER_OF_PROFILE_PARAMETERS; ++parameter) {
+        const double value = profile.Element(axis, parameter);
+        if (value <= 0.0) {
+            continue;
+        }
+        object.index = indices[parameter];
+        if (!mParent->mObjectDictionary.Write(mFirstAxis + axis, object, static_cast<unsigned int>(value), mErrorCode)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void mtsMaxonEPOS::RobotData::GetStaticParameters(vctDoubleMat & parameters) const
+{
+    parameters = mStaticParameters;
+}
+
+// IPM
+void mtsMaxonEPOS::RobotData::ipm_add_points(const vctDoubleMat & points)
+{
+    if (!mParent) {return;}
+
+    if (!CheckStateEnabled("ipm_add_points"))
+        return;
+
+    mInterpolating = false;
+
+    if (points.cols() != mIpmQueue.cols()) {
+        mInterface->SendError(name + ": ipm_add_points: expected " + std::to_string(mIpmQueue.cols())
+                              + " columns (time, positions, velocities), got " + std::to_string(points.cols()));
+        return;
+    }
+    for (size_t row = 0; row < points.rows(); ++row) {
+        const double time = points.Element(row, 0);
+        if ((time < 0.0) || (time > 255.0)) {
+            mInterface->SendError(name + ": ipm_add_points: time must be between 0 and 255 ms, got "
+                                  + std::to_string(time) + " for point " + std::to_string(row));
+            return;
+        }
+    }
+
+    // Trajectory playback, stop sending setpoints
+    if (mPlaybackPlaying) {
+        playback_pause();
+    }
+
+    mErrorCode = 0;
+    try {
+        // Switch all axes to interpolated position mode, again if a
+        // previous activation failed part way
+        if (NumberOfAxesInIpm() != mNumAxes) {
+            for (size_t axis = 0; axis < mNumAxes; ++axis) {
+                unsigned short underflowWarningLimit, overflowWarningLimit;
+                if (!mDriver->ActivateInterpolatedPositionMode(mHandles[axis], mAxisToNodeIDMap[axis], mErrorCode)
+                    || !mDriver->GetIpmBufferParameter(mHandles[axis], mAxisToNodeIDMap[axis], underflowWarningLimit,
+                                                       overflowWarningLimit, mIpmMaxBufferSize, mErrorCode)
+                    || !mDriver->SetIpmBufferParameter(mHandles[axis], mAxisToNodeIDMap[axis], mIpmUnderflowWarningLimit,
+                                                       static_cast<unsigned short>(mIpmMaxBufferSize), mErrorCode)
+                    || !mDriver->ClearIpmBuffer(mHandles[axis], mAxisToNodeIDMap[axis], mErrorCode)) {
+                    throw std::runtime_error(
+                        "Axis " + std::to_string(axis) +
+                        " failed to activate interpolated position mode (err=" +
+                        std::to_string(mErrorCode) + ")"
+                    );
+                }
+                mState[axis] = ST_IPM;
+                m_setpoint_js.Effort()[axis] = 0.0;
+            }
+            mIpmQueueHead = 0;
+            mIpmQueueCount = 0;
+            mIpmStarted = false;
+            mIpmBufferFill.SetAll(0);
+        }
+    }
+    catch (const std::runtime_error & e) {
+        mInterface->SendError(name + ": ipm_add_points (" + e.what() + ")");
+        return;
+    }
+
+    // Queue on host, Run transfers points to the drives
+    size_t row = 0;
+    for (; (row < points.rows()) && (mIpmQueueCount < mIpmQueue.rows()); ++row) {
+        const size_t slot = (mIpmQueueHead + mIpmQueueCount) % mIpmQueue.rows();
+        for (size_t col = 0; col < mIpmQueue.cols(); ++col) {
+            mIpmQueue.Element(slot, col) = points.Element(row, col);
+        }
+        mIpmQueueCount++;
+    }
+    if (row < points.rows()) {
+        mInterface->SendWarning(name + ": ipm_add_points: queue full, dropped "
+                                + std::to_string(points.rows() - row) + " point(s)");
+    }
+}
+
+void mtsMaxonEPOS::RobotData::ipm_stop(void)
+{
+    if (!mParent) {return;}
+
+    mIpmQueueHead = 0;
+    mIpmQueueCount = 0;
+    mIpmStarted = false;
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        if (mState[axis] != ST_IPM) {
+            continue;
+        }
+        if (!mDriver->StopIpmTrajectory(mHandles[axis], mAxisToNodeIDMap[axis], mErrorCode)
+            || !mDriver->ClearIpmBuffer(mHandles[axis], mAxisToNodeIDMap[axis], mErrorCode)) {
+            mInterface->SendWarning(name + ": " +
+                " axis " + std::to_string(axis) +
+                " StopIpmTrajectory failed (err=" + std::to_string(mErrorCode) + ")");
+        }
+        mIpmBufferFill[axis] = 0;
+    }
+}
+
+size_t mtsMaxonEPOS::RobotData::NumberOfAxesInIpm(void) const
+{
+    size_t count = 0;
+    for (size_t axis = 0; axis < mNumAxes; ++axis) {
+        if (mState[axis] == ST_IPM) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void mtsMaxonEPOS::RobotData::UpdateIPM(void)
+{
+    mErrorCode = 0;
+    try {
+        // Room left in all drive buffers
+        unsigned int free = mIpmMaxBufferSize;
+        for (size_t axis = 0; axis < mNumAxes; ++axis) {
+            unsigned int axisFree;
+            if (!mDriver->GetFreeIpmBufferSize(mHandles[axis], mAxisToNodeIDMap[axis], axisFree, mErrorCode)) {
+                throw std::runtime_error(
+                    "Axis " + std::to_string(axis) +
+                    " GetFreeIpmBufferSize failed (err=" + std::to_string(mErrorCode) + ")"
+                );
+            }
+            mIpmBufferFill[axis] = mIpmMaxBufferSize - axisFree;
+            free = std::min(free, axisFree);
+        }
+
+        // Transfer queued points, same number on all axes
+        const unsigned int count = std::min(free, mIpmQueueCount);
+        for (unsigned int i = 0; i < count; ++i) {
+            const size_t slot = mIpmQueueHead;
+            const unsigned char time = static_cast<unsigned char>(mIpmQueue.Element(slot, 0));
+            for (size_t axis = 0; axis < mNumAxes; ++axis) {
+                const int position = static_cast<int>(mIpmQueue.Element(slot, 1 + axis));
+                const int velocity = static_cast<int>(mIpmQueue.Element(slot, 1 + mNumAxes + axis));
+                if (!mDriver->AddPvtValueToIpmBuffer(mHandles[axis], mAxisToNodeIDMap[axis],
+                                                     position, velocity, time, mErrorCode)) {
+                    throw std::runtime_error(
+                        "Axis " + std::to_string(axis) +
+                        " AddPvtValueToIpmBuffer failed (err=" + std::to_string(mErrorCode) + ")"
+                    );
+                }
+                mIpmBufferFill[axis]++;
+                m_setpoint_js.Position()[axis] = position;
+            }
+            mIpmQueueHead = (mIpmQueueHead + 1) % mIpmQueue.rows();
+            mIpmQueueCount--;
+        }
+
+        if (!mIpmStarted) {
+            // Start once enough points are buffered, or all points have been transferred
+            const unsigned int fill = mIpmBufferFill.MinElement();
+            if ((fill > 0) && ((fill >= mIpmStartLevel) || (mIpmQueueCount == 0))) {
+                for (size_t axis = 0; axis < mNumAxes; ++axis) {
+                    if (!mDriver->StartIpmTrajectory(mHandles[axis], mAxisToNodeIDMap[axis], mErrorCode)) {
+                        throw std::runtime_error(
+                            "Axis " + std::to_string(axis) +
+                            " StartIpmTrajectory failed (err=" + std::to_string(mErrorCode) + ")"
+                        );
+                    }
+                }
+                mIpmStarted = true;
             }
+            return;
+        }
 
-            if (!VCS_SetPositionProfile(mHandles[axis], mAxisToNodeIDMap[axis], profileVelocity[axis], profileAcceleration[axis],
-                                        profileDeceleration[axis], DWORD_CAST(&mErrorCode))) {
+        // Check for underflows and end of trajectory
+        bool running = false;
+        bool underflow = false;
+        for (size_t axis = 0; axis < mNumAxes; ++axis) {
+            mtsMaxonEPOSDriver::IpmStatus status;
+            if (!mDriver->GetIpmStatus(mHandles[axis], mAxisToNodeIDMap[axis], status, mErrorCode)) {
                 throw std::runtime_error(
                     "Axis " + std::to_string(axis) +
-                    " SetPositionProfile failed (err=" +
-                    std::to_string(mErrorCode) + ")"
+                    " GetIpmStatus failed (err=" + std::to_string(mErrorCode) + ")"
                 );
             }
+            running = running || status.trajectoryRunning;
+            if (status.underflowError) {
+                mIpmUnderflows[axis]++;
+                underflow = true;
+            }
+        }
+        if (underflow) {
+            mInterface->SendWarning(name + ": IPM buffer underflow, trajectory stopped");
+            ipm_stop();
+        } else if (!running) {
+            // Trajectory completed (or interrupted, e.g. disabled)
+            if ((mIpmQueueCount > 0) || (mIpmBufferFill.MaxElement() > 0)) {
+                mInterface->SendWarning(name + ": IPM trajectory stopped, dropping remaining points");
+                ipm_stop();
+            }
+            mIpmStarted = false;
         }
     }
     catch (const std::runtime_error & e) {
-        mInterface->SendError(name + ": SetPositionProfile (" + e.what() + ")");
+        mInterface->SendError(name + ": IPM (" + e.what() + ")");
+        ipm_stop();
+    }
+}
+
+// Data recorder
+void mtsMaxonEPOS::RobotData::data_recorder_configure(const std::string & settings)
+{
+    if (!mParent) {return;}
+
+    Json::Value jsonSettings;
+    Json::Reader jsonReader;
+    std::string error;
+    if (!jsonReader.parse(settings, jsonSettings)) {
+        mInterface->SendError(name + ": data_recorder_configure: failed to parse settings: "
+                              + jsonReader.getFormattedErrorMessages());
+        return;
+    }
+    if (!mDataRecorder.Configure(jsonSettings, error)) {
+        mInterface->SendError(name + ": data_recorder_configure: " + error);
+    }
+}
+
+void mtsMaxonEPOS::RobotData::data_recorder_start(void)
+{
+    if (!mParent) {return;}
+
+    std::string error;
+    if (!mDataRecorder.Capture(error)) {
+        mInterface->SendError(name + ": data_recorder_start: " + error);
+    }
+}
+
+void mtsMaxonEPOS::RobotData::data_recorder_trigger(void)
+{
+    if (!mParent) {return;}
+
+    std::string error;
+    if (!mDataRecorder.Trigger(error)) {
+        mInterface->SendWarning(name + ": data_recorder_trigger: " + error);
+    }
+}
+
+void mtsMaxonEPOS::RobotData::data_recorder_stop(void)
+{
+    if (!mParent) {return;}
+
+    std::string error;
+    if (!mDataRecorder.Finish(error)) {
+        mInterface->SendWarning(name + ": data_recorder_stop: " + error);
+    }
+}
+
+void mtsMaxonEPOS::RobotData::GetDataRecorderData(vctDoubleMat & data) const
+{
+    mDataRecorder.GetData(data);
+}
+
+void mtsMaxonEPOS::RobotData::GetDataRecorderColumns(std::vector<std::string> & names) const
+{
+    mDataRecorder.GetColumnNames(names);
+}
+
+void mtsMaxonEPOS::RobotData::GetDataRecorderState(std::string & state) const
+{
+    state = mtsMaxonEPOSDataRecorder::StateName(mDataRecorder.GetState());
+}
+
+void mtsMaxonEPOS::RobotData::UpdateDataRecorder(void)
+{
+    std::string message;
+    switch (mDataRecorder.Poll(message)) {
+    case mtsMaxonEPOSDataRecorder::EVENT_UPLOADED:
+        mDataRecorder.GetData(mDataRecorderData);
+        data_recorder_uploaded(mDataRecorderData);
+        mInterface->SendStatus(name + ": data_recorder: " + message);
+        break;
+    case mtsMaxonEPOSDataRecorder::EVENT_FAILED:
+        mInterface->SendError(name + ": data_recorder: " + message);
+        break;
+    default:
+        break;
+    }
+}
+
+// Trajectory playback
+void mtsMaxonEPOS::RobotData::playback_load(const std::string & fileName)
+{
+    if (!mParent) {return;}
+
+    mPlaybackPlaying = false;
+    std::string error;
+    const std::string fullName = mParent->mConfigPath.Find(fileName);
+    if (!mPlayback.Open(fullName.empty() ? fileName : fullName, error)) {
+        mInterface->SendError(name + ": playback_load: " + error);
+        return;
+    }
+    if (mPlayback.NumberOfAxes() != mNumAxes) {
+        mInterface->SendError(name + ": playback_load: " + fileName + " has "
+                              + std::to_string(mPlayback.NumberOfAxes()) + " axes, expected "
+                              + std::to_string(mNumAxes));
+        mPlayback.Close();
+        return;
+    }
+    mPlaybackTime = 0.0;
+    mPlaybackPoint = 0;
+    mInterface->SendStatus(name + ": playback_load: " + fileName + ", "
+                           + std::to_string(mPlayback.NumberOfPoints()) + " points, "
+                           + std::to_string(mPlayback.EndTime() - mPlayback.StartTime()) + "s");
+}
+
+void mtsMaxonEPOS::RobotData::playback_play(void)
+{
+    if (!mParent) {return;}
+
+    if (!CheckStateEnabled("playback_play"))
+        return;
+
+    mInterpolating = false;
+
+    if (!mPlayback.IsOpen()) {
+        mInterface->SendWarning(name + ": playback_play: no trajectory loaded");
+        return;
+    }
+    // Restart from the beginning if at the end
+    if (mPlaybackTime >= mPlayback.EndTime() - mPlayback.StartTime()) {
+        playback_seek(0.0);
+    }
+    // Trajectory time starts advancing at the next Run
+    mPlaybackLastUpdate = -1.0;
+    mPlaybackPlaying = true;
+}
+
+void mtsMaxonEPOS::RobotData::playback_pause(void)
+{
+    if (!mParent) {return;}
+
+    if (mPlaybackPlaying) {
+        mPlaybackPlaying = false;
+        playback_progress(mPlaybackTime);
+    }
+}
+
+void mtsMaxonEPOS::RobotData::playback_seek(const double & time)
+{
+    if (!mParent) {return;}
+
+    if (!mPlayback.IsOpen()) {
+        mInterface->SendWarning(name + ": playback_seek: no trajectory loaded");
+        return;
+    }
+    const double duration = mPlayback.EndTime() - mPlayback.StartTime();
+    mPlaybackTime = std::max(0.0, std::min(time, duration));
+    mPlaybackPoint = mPlayback.Find(mPlayback.StartTime() + mPlaybackTime);
+    mPlayback.Prefetch(mPlaybackPoint);
+    playback_progress(mPlaybackTime);
+}
+
+void mtsMaxonEPOS::RobotData::playback_rate(const double & rate)
+{
+    if (!mParent) {return;}
+
+    if (rate <= 0.0) {
+        mInterface->SendWarning(name + ": playback_rate: rate must be positive, use playback_pause to stop");
+        return;
+    }
+    mPlaybackRate = rate;
+}
+
+void mtsMaxonEPOS::RobotData::UpdatePlayback(double now)
+{
+    if (m_op_state.State() != prmOperatingState::ENABLED) {
+        mInterface->SendWarning(name + ": playback paused, robot not enabled");
+        playback_pause();
+        return;
+    }
+
+    // Advance trajectory time, first cycle after play sends the current point
+    if (mPlaybackLastUpdate >= 0.0) {
+        mPlaybackTime += (now - mPlaybackLastUpdate) * mPlaybackRate;
+    }
+    mPlaybackLastUpdate = now;
+    const double duration = mPlayback.EndTime() - mPlayback.StartTime();
+    const bool finished = (mPlaybackTime >= duration);
+    if (finished) {
+        mPlaybackTime = duration;
+    }
+
+    // Find the segment, usually the same or next one
+    const double time = mPlayback.StartTime() + mPlaybackTime;
+    const size_t last = mPlayback.NumberOfPoints() - 1;
+    size_t steps = 0;
+    while ((mPlaybackPoint < last) && (mPlayback.Time(mPlaybackPoint + 1) <= time) && (steps < 16)) {
+        mPlaybackPoint++;
+        steps++;
+    }
+    if ((steps == 16) && (mPlaybackPoint < last) && (mPlayback.Time(mPlaybackPoint + 1) <= time)) {
+        mPlaybackPoint = mPlayback.Find(time);
+    }
+    mPlayback.Prefetch(mPlaybackPoint);
+
+    // Linear interpolation between points
+    const double * start = mPlayback.Positions(mPlaybackPoint);
+    vctDoubleVec & goal = mPlaybackSetpoint.Goal();
+    if (mPlaybackPoint < last) {
+        const double * end = mPlayback.Positions(mPlaybackPoint + 1);
+        const double t0 = mPlayback.Time(mPlaybackPoint);
+        const double t1 = mPlayback.Time(mPlaybackPoint + 1);
+        const double ratio = (t1 > t0) ? std::max(0.0, std::min(1.0, (time - t0) / (t1 - t0))) : 1.0;
+        for (size_t axis = 0; axis < mNumAxes; ++axis) {
+            goal[axis] = start[axis] + ratio * (end[axis] - start[axis]);
+        }
+    } else {
+        for (size_t axis = 0; axis < mNumAxes; ++axis) {
+            goal[axis] = start[axis];
+        }
+    }
+    SendServoJp(mPlaybackSetpoint.Goal());
+    if (mErrorCode != 0) {
+        mInterface->SendWarning(name + ": playback paused after setpoint error");
+        playback_pause();
+        return;
+    }
+
+    if (finished) {
+        mPlaybackPlaying = false;
+        playback_progress(mPlaybackTime);
+        mInterface->SendStatus(name + ": playback finished");
+    } else if (now - mPlaybackLastProgress >= mPlaybackProgressPeriod) {
+        mPlaybackLastProgress = now;
+        playback_progress(mPlaybackTime);
     }
 }
 
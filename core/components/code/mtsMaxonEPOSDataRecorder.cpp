@@ -0,0 +1,559 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+  (C) Copyright 2024-2025 Johns Hopkins University (JHU)
+
+--- begin cisst license - do not edit ---
+This software is provided "as is" under an open source license, with no warranty.
+--- end cisst license ---
+*/
+
+#include <cstdio>
+#include <fstream>
+
+#include <cisstCommon/cmnTypeTraits.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSDataRecorder.h>
+
+static const double DefaultPollPeriod = 0.05;
+
+mtsMaxonEPOSDataRecorder::mtsMaxonEPOSDataRecorder() :
+    mDriver(nullptr),
+    mState(IDLE),
+    mStopRequested(false),
+    mConfigured(false),
+    mPollPeriod(DefaultPollPeriod),
+    mEvent(EVENT_NONE)
+{}
+
+mtsMaxonEPOSDataRecorder::~mtsMaxonEPOSDataRecorder()
+{
+    Stop();
+}
+
+void mtsMaxonEPOSDataRecorder::SetAxes(mtsMaxonEPOSDriver * driver, const std::vector<void *> & handles,
+                                       const std::vector<unsigned short> & nodeIds)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mDriver = driver;
+    mHandles = handles;
+    mNodeIds = nodeIds;
+    AxisSettings disabled;
+    disabled.enabled = false;
+    disabled.samplingPeriod = 1;
+    disabled.precedingSamples = 0;
+    disabled.triggers = 0;
+    mPendingSettings.assign(handles.size(), disabled);
+    mSettings = mPendingSettings;
+}
+
+void mtsMaxonEPOSDataRecorder::Start(void)
+{
+    if (mThread.joinable()) {
+        return;
+    }
+    mStopRequested = false;
+    mThread = std::thread(&mtsMaxonEPOSDataRecorder::Worker, this);
+}
+
+void mtsMaxonEPOSDataRecorder::Stop(void)
+{
+    if (!mThread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopRequested = true;
+    }
+    mCondition.notify_one();
+    mThread.join();
+}
+
+bool mtsMaxonEPOSDataRecorder::Configure(const Json::Value & jsonConfig, std::string & error)
+{
+    if (!jsonConfig.isObject()) {
+        error = "settings must be a JSON object";
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mMutex);
+    if ((mState == CONFIGURING) || (mState == CAPTURING) || (mState == UPLOADING)) {
+        error = std::string("data recorder is busy (") + StateName(mState) + ")";
+        return false;
+    }
+    const size_t numberOfAxes = mPendingSettings.size();
+
+    // axes to configure, all by default
+    std::vector<size_t> axes;
+    const Json::Value & jsonAxes = jsonConfig["axes"];
+    if (jsonAxes.isNull()) {
+        for (size_t axis = 0; axis < numberOfAxes; ++axis) {
+            axes.push_back(axis);
+        }
+    } else {
+        for (Json::ArrayIndex index = 0; index < jsonAxes.size(); ++index) {
+            if (!jsonAxes[index].isUInt() || (jsonAxes[index].asUInt() >= numberOfAxes)) {
+                error = "invalid axis index in \"axes\"";
+                return false;
+            }
+            axes.push_back(jsonAxes[index].asUInt());
+        }
+    }
+
+    AxisSettings settings;
+    settings.enabled = jsonConfig.get("enabled", true).asBool();
+    const Json::Value samplingPeriod = jsonConfig.get("sampling_period", 1);
+    if (!samplingPeriod.isUInt() || (samplingPeriod.asUInt() < 1) || (samplingPeriod.asUInt() > 0xFFFF)) {
+        error = "invalid \"sampling_period\", must be between 1 and 65535";
+        return false;
+    }
+    settings.samplingPeriod = static_cast<unsigned short>(samplingPeriod.asUInt());
+    const Json::Value precedingSamples = jsonConfig.get("preceding_samples", 0);
+    if (!precedingSamples.isUInt() || (precedingSamples.asUInt() > 0xFFFF)) {
+        error = "invalid \"preceding_samples\"";
+        return false;
+    }
+    settings.precedingSamples = static_cast<unsigned short>(precedingSamples.asUInt());
+
+    settings.triggers = 0;
+    const Json::Value & jsonTriggers = jsonConfig["trigger"];
+    for (Json::ArrayIndex index = 0; index < jsonTriggers.size(); ++index) {
+        const std::string trigger = jsonTriggers[index].asString();
+        if (trigger == "movement_start") {
+            settings.triggers |= mtsMaxonEPOSDriver::TRIGGER_MOVEMENT_START;
+        } else if (trigger == "movement_end") {
+            settings.triggers |= mtsMaxonEPOSDriver::TRIGGER_MOVEMENT_END;
+        } else if (trigger == "error") {
+            settings.triggers |= mtsMaxonEPOSDriver::TRIGGER_ERROR;
+        } else if (trigger == "digital_input") {
+            settings.triggers |= mtsMaxonEPOSDriver::TRIGGER_DIGITAL_INPUT;
+        } else {
+            error = "invalid trigger \"" + trigger + "\", must be movement_start, movement_end, error or digital_input";
+            return false;
+        }
+    }
+
+    const Json::Value & jsonChannels = jsonConfig["channels"];
+    if (settings.enabled && ((jsonChannels.size() < 1) || (jsonChannels.size() > MAXIMUM_CHANNELS))) {
+        error = "\"channels\" must have 1 to " + std::to_string(MAXIMUM_CHANNELS) + " objects";
+        return false;
+    }
+    for (Json::ArrayIndex index = 0; index < jsonChannels.size(); ++index) {
+        Channel channel;
+        std::string channelError;
+        if (!mtsMaxonEPOSObjectDictionary::ObjectFromJSON(jsonChannels[index], channel.object, channelError)) {
+            error = "channel " + std::to_string(index) + ": " + channelError;
+            return false;
+        }
+        if (channel.object.size == 3) {
+            error = "channel " + std::to_string(index) + ": size must be 1, 2 or 4 bytes";
+            return false;
+        }
+        channel.isSigned = jsonChannels[index].get("signed", true).asBool();
+        settings.channels.push_back(channel);
+    }
+
+    const double pollPeriod = jsonConfig.get("poll_period", mPollPeriod.count()).asDouble();
+    if (pollPeriod <= 0.0) {
+        error = "\"poll_period\" must be positive";
+        return false;
+    }
+
+    for (size_t index = 0; index < axes.size(); ++index) {
+        mPendingSettings[axes[index]] = settings;
+    }
+    mPollPeriod = std::chrono::duration<double>(pollPeriod);
+    mFileName = jsonConfig.get("file", mFileName).asString();
+    mRequests.push_back(REQUEST_CONFIGURE);
+    mState = CONFIGURING;
+    mCondition.notify_one();
+    return true;
+}
+
+bool mtsMaxonEPOSDataRecorder::Capture(std::string & error)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mConfigured || (mState == CONFIGURING) || (mState == CAPTURING) || (mState == UPLOADING)) {
+        error = std::string("can't start a capture, data recorder is ") + StateName(mState);
+        return false;
+    }
+    mRequests.push_back(REQUEST_CAPTURE);
+    mState = CAPTURING;
+    mCondition.notify_one();
+    return true;
+}
+
+bool mtsMaxonEPOSDataRecorder::Trigger(std::string & error)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mState != CAPTURING) {
+        error = std::string("no capture in progress, data recorder is ") + StateName(mState);
+        return false;
+    }
+    mRequests.push_back(REQUEST_TRIGGER);
+    mCondition.notify_one();
+    return true;
+}
+
+bool mtsMaxonEPOSDataRecorder::Finish(std::string & error)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mState != CAPTURING) {
+        error = std::string("no capture in progress, data recorder is ") + StateName(mState);
+        return false;
+    }
+    mRequests.push_back(REQUEST_FINISH);
+    mCondition.notify_one();
+    return true;
+}
+
+mtsMaxonEPOSDataRecorder::Event mtsMaxonEPOSDataRecorder::Poll(std::string & message)
+{
+    // don't wait for the worker, the event will be picked up next time
+    std::unique_lock<std::mutex> lock(mMutex, std::try_to_lock);
+    if (!lock.owns_lock() || (mEvent == EVENT_NONE)) {
+        return EVENT_NONE;
+    }
+    const Event event = mEvent;
+    mEvent = EVENT_NONE;
+    message = mEventMessage;
+    return event;
+}
+
+mtsMaxonEPOSDataRecorder::State mtsMaxonEPOSDataRecorder::GetState(void) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mState;
+}
+
+const char * mtsMaxonEPOSDataRecorder::StateName(State state)
+{
+    switch (state) {
+    case IDLE:        return "idle";
+    case CONFIGURING: return "configuring";
+    case CONFIGURED:  return "configured";
+    case CAPTURING:   return "capturing";
+    case UPLOADING:   return "uploading";
+    case READY:       return "ready";
+    case FAILED:      return "failed";
+    }
+    return "unknown";
+}
+
+void mtsMaxonEPOSDataRecorder::GetData(vctDoubleMat & data) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    data.SetSize(mData.rows(), mData.cols());
+    data.Assign(mData);
+}
+
+void mtsMaxonEPOSDataRecorder::GetColumnNames(std::vector<std::string> & names) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    names = mColumnNames;
+}
+
+void mtsMaxonEPOSDataRecorder::Worker(void)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        const auto wake = [this] { return mStopRequested || !mRequests.empty(); };
+        if (mState == CAPTURING) {
+            // poll the recorders until they stop
+            mCondition.wait_for(lock, mPollPeriod, wake);
+        } else {
+            mCondition.wait(lock, wake);
+        }
+        if (mStopRequested) {
+            return;
+        }
+        Request request = REQUEST_NONE;
+        std::vector<AxisSettings> settings;
+        if (!mRequests.empty()) {
+            request = mRequests.front();
+            mRequests.pop_front();
+            if (request == REQUEST_CONFIGURE) {
+                settings = mPendingSettings;
+            }
+        } else if (mState != CAPTURING) {
+            continue;
+        }
+        const std::string fileName = mFileName;
+        lock.unlock();
+
+        std::string error;
+        bool ok = true;
+        bool upload = false;
+        switch (request) {
+        case REQUEST_CONFIGURE:
+            ok = ExecuteConfigure(settings, error);
+            break;
+        case REQUEST_CAPTURE:
+            ok = ExecuteCapture(error);
+            break;
+        case REQUEST_TRIGGER:
+            ok = ExecuteTrigger(error);
+            break;
+        case REQUEST_FINISH:
+            ok = ExecuteFinish(error);
+            upload = ok;
+            break;
+        case REQUEST_NONE:
+            ok = IsCaptureDone(upload, error);
+            break;
+        }
+        size_t numberOfSamples = 0;
+        if (ok && upload) {
+            {
+                std::lock_guard<std::mutex> uploadLock(mMutex);
+                mState = UPLOADING;
+            }
+            ok = Upload(numberOfSamples, error);
+            if (ok && !fileName.empty()) {
+                ok = WriteFile(fileName, error);
+            }
+        }
+
+        lock.lock();
+        if (!ok) {
+            if (request == REQUEST_CONFIGURE) {
+                mConfigured = false;
+            }
+            // drop the requests made for the failed operation
+            mRequests.clear();
+            mState = FAILED;
+            mEvent = EVENT_FAILED;
+            mEventMessage = error;
+        } else if (request == REQUEST_CONFIGURE) {
+            mConfigured = true;
+            mState = CONFIGURED;
+        } else if (upload) {
+            mState = READY;
+            mEvent = EVENT_UPLOADED;
+            mEventMessage = std::to_string(numberOfSamples) + " samples uploaded";
+            if (!fileName.empty()) {
+                mEventMessage += ", saved to " + fileName;
+            }
+        }
+    }
+}
+
+std::string mtsMaxonEPOSDataRecorder::CallError(size_t axis, mtsMaxonEPOSDriver::Call call, unsigned int errorCode) const
+{
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer), "axis %u: %s failed (0x%08X %s)", static_cast<unsigned int>(axis),
+                  mtsMaxonEPOSDriver::CallName(call), errorCode, mtsMaxonEPOSDriver::ErrorDescription(errorCode));
+    return buffer;
+}
+
+bool mtsMaxonEPOSDataRecorder::ExecuteConfigure(const std::vector<AxisSettings> & settings, std::string & error)
+{
+    unsigned int errorCode = 0;
+    for (size_t axis = 0; axis < settings.size(); ++axis) {
+        const AxisSettings & axisSettings = settings[axis];
+        if (!axisSettings.enabled) {
+            continue;
+        }
+        void * handle = mHandles[axis];
+        const unsigned short nodeId = mNodeIds[axis];
+        if (!mDriver->DeactivateAllChannels(handle, nodeId, errorCode)) {
+            error = CallError(axis, mtsMaxonEPOSDriver::CALL_DEACTIVATE_ALL_CHANNELS, errorCode);
+            return false;
+        }
+        if (!mDriver->DisableAllTriggers(handle, nodeId, errorCode)) {
+            error = CallError(axis, mtsMaxonEPOSDriver::CALL_DISABLE_ALL_TRIGGERS, errorCode);
+            return false;
+        }
+        if (!mDriver->SetRecorderParameter(handle, nodeId, axisSettings.samplingPeriod,
+                                           axisSettings.precedingSamples, errorCode)) {
+            error = CallError(axis, mtsMaxonEPOSDriver::CALL_SET_RECORDER_PARAMETER, errorCode);
+            return false;
+        }
+        for (size_t index = 0; index < axisSettings.channels.size(); ++index) {
+            const mtsMaxonEPOSObjectDictionary::Object & object = axisSettings.channels[index].object;
+            if (!mDriver->ActivateChannel(handle, nodeId, static_cast<unsigned char>(index + 1),
+                                          object.index, object.subIndex, object.size, errorCode)) {
+                error = CallError(axis, mtsMaxonEPOSDriver::CALL_ACTIVATE_CHANNEL, errorCode)
+                    + " for " + object.name;
+                return false;
+            }
+        }
+        if ((axisSettings.triggers != 0)
+            && !mDriver->EnableTrigger(handle, nodeId, axisSettings.triggers, errorCode)) {
+            error = CallError(axis, mtsMaxonEPOSDriver::CALL_ENABLE_TRIGGER, errorCode);
+            return false;
+        }
+    }
+    mSettings = settings;
+    return true;
+}
+
+bool mtsMaxonEPOSDataRecorder::ExecuteCapture(std::string & error)
+{
+    unsigned int errorCode = 0;
+    bool any = false;
+    for (size_t axis = 0; axis < mSettings.size(); ++axis) {
+        if (!mSettings[axis].enabled) {
+            continue;
+        }
+        any = true;
+        if (!mDriver->StartRecorder(mHandles[axis], mNodeIds[axis], errorCode)) {
+            error = CallError(axis, mtsMaxonEPOSDriver::CALL_START_RECORDER, errorCode);
+            return false;
+        }
+    }
+    if (!any) {
+        error = "no axis configured";
+        return false;
+    }
+    // recorders without trigger start now
+    for (size_t axis = 0; axis < mSettings.size(); ++axis) {
+        if (mSettings[axis].enabled && (mSettings[axis].triggers == 0)
+            && !mDriver->ForceTrigger(mHandles[axis], mNodeIds[axis], errorCode)) {
+            error = CallError(axis, mtsMaxonEPOSDriver::CALL_FORCE_TRIGGER, errorCode);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool mtsMaxonEPOSDataRecorder::ExecuteTrigger(std::string & error)
+{
+    unsigned int errorCode = 0;
+    for (size_t axis = 0; axis < mSettings.size(); ++axis) {
+        if (mSettings[axis].enabled
+            && !mDriver->ForceTrigger(mHandles[axis], mNodeIds[axis], errorCode)) {
+            error = CallError(axis, mtsMaxonEPOSDriver::CALL_FORCE_TRIGGER, errorCode);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool mtsMaxonEPOSDataRecorder::ExecuteFinish(std::string & error)
+{
+    unsigned int errorCode = 0;
+    for (size_t axis = 0; axis < mSettings.size(); ++axis) {
+        if (mSettings[axis].enabled
+            && !mDriver->StopRecorder(mHandles[axis], mNodeIds[axis], errorCode)) {
+            error = CallError(axis, mtsMaxonEPOSDriver::CALL_STOP_RECORDER, errorCode);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool mtsMaxonEPOSDataRecorder::IsCaptureDone(bool & done, std::string & error)
+{
+    unsigned int errorCode = 0;
+    done = true;
+    for (size_t axis = 0; axis < mSettings.size(); ++axis) {
+        if (!mSettings[axis].enabled) {
+            continue;
+        }
+        bool running;
+        if (!mDriver->IsRecorderRunning(mHandles[axis], mNodeIds[axis], running, errorCode)) {
+            error = CallError(axis, mtsMaxonEPOSDriver::CALL_IS_RECORDER_RUNNING, errorCode);
+            return false;
+        }
+        if (running) {
+            done = false;
+            return true;
+        }
+    }
+    return true;
+}
+
+bool mtsMaxonEPOSDataRecorder::Upload(size_t & numberOfSamples, std::string & error)
+{
+    unsigned int errorCode = 0;
+    // one column of raw values per axis and channel
+    std::vector<std::vector<double> > columns;
+    std::vector<std::string> names;
+    std::vector<unsigned char> buffer;
+    numberOfSamples = 0;
+    for (size_t axis = 0; axis < mSettings.size(); ++axis) {
+        const AxisSettings & axisSettings = mSettings[axis];
+        if (!axisSettings.enabled) {
+            continue;
+        }
+        unsigned int vectorSize = 0;
+        if (!mDriver->ReadChannelVectorSize(mHandles[axis], mNodeIds[axis], vectorSize, errorCode)) {
+            error = CallError(axis, mtsMaxonEPOSDriver::CALL_READ_CHANNEL_VECTOR_SIZE, errorCode);
+            return false;
+        }
+        if (vectorSize > numberOfSamples) {
+            numberOfSamples = vectorSize;
+        }
+        for (size_t index = 0; index < axisSettings.channels.size(); ++index) {
+            const Channel & channel = axisSettings.channels[index];
+            const size_t size = channel.object.size;
+            columns.push_back(std::vector<double>(vectorSize));
+            names.push_back("axis" + std::to_string(axis) + "/" + channel.object.name);
+            if (vectorSize == 0) {
+                continue;
+            }
+            buffer.resize(vectorSize * size);
+            if (!mDriver->ReadChannelDataVector(mHandles[axis], mNodeIds[axis], static_cast<unsigned char>(index + 1),
+                                                buffer.data(), static_cast<unsigned int>(buffer.size()), errorCode)) {
+                error = CallError(axis, mtsMaxonEPOSDriver::CALL_READ_CHANNEL_DATA_VECTOR, errorCode)
+                    + " for " + channel.object.name;
+                return false;
+            }
+            // little endian, sign extended if needed
+            std::vector<double> & column = columns.back();
+            for (size_t sample = 0; sample < vectorSize; ++sample) {
+                unsigned int value = 0;
+                for (size_t byte = 0; byte < size; ++byte) {
+                    value |= static_cast<unsigned int>(buffer[sample * size + byte]) << (8 * byte);
+                }
+                if (channel.isSigned && (size < 4) && (value & (1u << (8 * size - 1)))) {
+                    value |= ~0u << (8 * size);
+                }
+                column[sample] = channel.isSigned ? static_cast<double>(static_cast<int>(value))
+                                                  : static_cast<double>(value);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mData.SetSize(numberOfSamples, columns.size());
+    mData.SetAll(cmnTypeTraits<double>::NaN());
+    for (size_t column = 0; column < columns.size(); ++column) {
+        for (size_t sample = 0; sample < columns[column].size(); ++sample) {
+            mData.Element(sample, column) = columns[column][sample];
+        }
+    }
+    mColumnNames.swap(names);
+    return true;
+}
+
+bool mtsMaxonEPOSDataRecorder::WriteFile(const std::string & fileName, std::string & error) const
+{
+    std::ofstream file(fileName.c_str());
+    if (!file) {
+        error = "failed to create \"" + fileName + "\"";
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (size_t column = 0; column < mColumnNames.size(); ++column) {
+        file << (column > 0 ? "," : "") << mColumnNames[column];
+    }
+    file << '\n';
+    // NaN past the end of shorter captures are left empty
+    for (size_t row = 0; row < mData.rows(); ++row) {
+        for (size_t column = 0; column < mData.cols(); ++column) {
+            const double value = mData.Element(row, column);
+            if (column > 0) {
+                file << ',';
+            }
+            if (value == value) {
+                file << value;
+            }
+        }
+        file << '\n';
+    }
+    if (!file) {
+        error = "failed to write \"" + fileName + "\"";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,224 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+  (C) Copyright 2024-2025 Johns Hopkins University (JHU)
+
+--- begin cisst license - do not edit ---
+This software is provided "as is" under an open source license, with no warranty.
+--- end cisst license ---
+*/
+
+#include <algorithm>
+
+#include <cisstCommon/cmnLogger.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSDriver.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSDriverReplay.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSDriverSimulated.h>
+#if sawMaxonEPOS_HAS_EposCmdLib
+#include <sawMaxonEPOS/mtsMaxonEPOSDriverEposCmd.h>
+#endif
+
+const char * mtsMaxonEPOSDriver::CallName(Call call)
+{
+    static const char * names[NUMBER_OF_CALLS] = {
+        "OpenDevice",
+        "OpenSubDevice",
+        "CloseSubDevice",
+        "CloseDevice",
+        "GetProtocolStackSettings",
+        "SetProtocolStackSettings",
+        "SendNMTService",
+        "ClearFault",
+        "GetFaultState",
+        "GetEnableState",
+        "SetEnableState",
+        "SetDisableState",
+        "GetState",
+        "GetPositionIs",
+        "GetCurrentIs",
+        "ActivateProfilePositionMode",
+        "ActivatePositionMode",
+        "ActivateVelocityMode",
+        "ActivateCurrentMode",
+        "ActivateInterpolatedPositionMode",
+        "SetPositionProfile",
+        "MoveToPosition",
+        "HaltPositionMovement",
+        "HaltVelocityMovement",
+        "SetPositionMust",
+        "SetVelocityMust",
+        "SetCurrentMust",
+        "SetIpmBufferParameter",
+        "GetIpmBufferParameter",
+        "ClearIpmBuffer",
+        "GetFreeIpmBufferSize",
+        "AddPvtValueToIpmBuffer",
+        "StartIpmTrajectory",
+        "StopIpmTrajectory",
+        "GetIpmStatus",
+        "GetObject",
+        "SetObject",
+        "SetRecorderParameter",
+        "EnableTrigger",
+        "DisableAllTriggers",
+        "ActivateChannel",
+        "DeactivateAllChannels",
+        "StartRecorder",
+        "StopRecorder",
+        "ForceTrigger",
+        "IsRecorderRunning",
+        "ReadChannelVectorSize",
+        "ReadChannelDataVector",
+        "ReadCANFrame",
+        "SendCANFrame"
+    };
+    if ((call < 0) || (call >= NUMBER_OF_CALLS)) {
+        return "Unknown";
+    }
+    return names[call];
+}
+
+// Sorted by code for binary search
+struct ErrorCodeDescription {
+    unsigned int  code;
+    const char   *description;
+};
+static const ErrorCodeDescription ErrorCodeDescriptions[] = {
+    { 0x00000000, "No error" },
+    { 0x05030000, "Toggle bit not alternated" },
+    { 0x05040000, "SDO protocol timed out" },
+    { 0x05040001, "Client/server command specifier not valid or unknown" },
+    { 0x05040002, "Invalid block size" },
+    { 0x05040003, "Invalid sequence number" },
+    { 0x05040004, "CRC error" },
+    { 0x05040005, "Out of memory" },
+    { 0x06010000, "Unsupported access to an object" },
+    { 0x06010001, "Attempt to read a write-only object" },
+    { 0x06010002, "Attempt to write a read-only object" },
+    { 0x06020000, "Object does not exist in the object dictionary" },
+    { 0x06040041, "Object cannot be mapped to the PDO" },
+    { 0x06040042, "Number and length of objects to be mapped would exceed PDO length" },
+    { 0x06040043, "General parameter incompatibility" },
+    { 0x06040047, "General internal incompatibility in the device" },
+    { 0x06060000, "Access failed due to a hardware error" },
+    { 0x06070010, "Data type does not match, length of service parameter does not match" },
+    { 0x06070012, "Data type does not match, length of service parameter too high" },
+    { 0x06070013, "Data type does not match, length of service parameter too low" },
+    { 0x06090011, "Subindex does not exist" },
+    { 0x06090030, "Value range of parameter exceeded" },
+    { 0x06090031, "Value of parameter written too high" },
+    { 0x06090032, "Value of parameter written too low" },
+    { 0x06090036, "Maximum value is less than minimum value" },
+    { 0x08000000, "General error" },
+    { 0x08000020, "Data cannot be transferred or stored" },
+    { 0x08000021, "Data cannot be transferred or stored because of local control" },
+    { 0x08000022, "Data cannot be transferred or stored because of present device state" },
+    { 0x0F00FFB9, "Wrong node id" },
+    { 0x0F00FFBC, "Device is not in service mode" },
+    { 0x0F00FFBE, "Password incorrect" },
+    { 0x0F00FFBF, "Illegal command" },
+    { 0x0F00FFC0, "Device is in wrong NMT state" },
+    { 0x10000001, "Internal error" },
+    { 0x10000002, "Null pointer passed to function" },
+    { 0x10000003, "Handle passed to function is not valid" },
+    { 0x10000004, "Virtual device name is not valid" },
+    { 0x10000005, "Device name is not valid" },
+    { 0x10000006, "Protocol stack name is not valid" },
+    { 0x10000007, "Interface name is not valid" },
+    { 0x10000008, "Port name is not valid" },
+    { 0x10000009, "Could not open library" },
+    { 0x1000000A, "Command failed" },
+    { 0x1000000B, "Timeout occurred during execution" },
+    { 0x1000000C, "Bad parameter passed to function" },
+    { 0x1000000D, "Command aborted by user" },
+    { 0x1000000E, "Buffer is too small" },
+    { 0x1000000F, "No communication settings found" },
+    { 0x10000010, "Function is not supported" },
+    { 0x10000011, "Parameter already used" },
+    { 0x10000013, "Bad device handle" },
+    { 0x10000014, "Bad protocol stack handle" },
+    { 0x10000015, "Bad interface handle" },
+    { 0x10000016, "Bad port handle" },
+    { 0x10000017, "Address parameters are not correct" },
+    { 0x10000020, "Bad device state" },
+    { 0x10000021, "Bad file content" },
+    { 0x10000022, "System cannot find specified path" },
+    { 0x10000024, "Cross thread error" },
+    { 0x10000026, "Gateway support error" },
+    { 0x10000027, "Serial number update error" },
+    { 0x10000028, "Communication interface error" },
+    { 0x10000029, "Communication settings not supported" },
+    { 0x1000002A, "Parameter not supported" },
+    { 0x20000001, "Error opening interface" },
+    { 0x20000002, "Error closing interface" },
+    { 0x20000003, "Interface is not open" },
+    { 0x20000004, "Error opening port" },
+    { 0x20000005, "Error closing port" },
+    { 0x20000006, "Port is not open" },
+    { 0x20000007, "Error resetting port" },
+    { 0x20000008, "Error configuring port settings" },
+    { 0x20000009, "Error configuring port mode" },
+    { 0x21000001, "RS232 write data error" },
+    { 0x21000002, "RS232 read data error" },
+    { 0x22000001, "CAN receive frame error" },
+    { 0x22000002, "CAN transmit frame error" },
+    { 0x23000001, "USB write data error" },
+    { 0x23000002, "USB read data error" },
+    { 0x24000001, "HID write data error" },
+    { 0x24000002, "HID read data error" },
+    { 0x31000001, "Negative acknowledge received" },
+    { 0x31000002, "Bad checksum received" },
+    { 0x31000003, "Bad data size received" },
+    { 0x32000001, "CANopen SDO response not received" },
+    { 0x32000002, "CANopen requested CAN frame not received" },
+    { 0x32000003, "CANopen CAN frame not received" },
+    { 0x34000001, "USB stuffing error" },
+    { 0x34000002, "USB bad CRC received" },
+    { 0x34000003, "USB bad data size received" },
+    { 0x34000004, "USB bad data size written" },
+    { 0x34000005, "USB write data error" },
+    { 0x34000006, "USB read data error" }
+};
+
+const char * mtsMaxonEPOSDriver::ErrorDescription(unsigned int errorCode)
+{
+    const size_t size = sizeof(ErrorCodeDescriptions) / sizeof(ErrorCodeDescriptions[0]);
+    const ErrorCodeDescription * end = ErrorCodeDescriptions + size;
+    const ErrorCodeDescription * found =
+        std::lower_bound(ErrorCodeDescriptions, end, errorCode,
+                         [](const ErrorCodeDescription & entry, unsigned int code) { return entry.code < code; });
+    if ((found == end) || (found->code != errorCode)) {
+        return "Unknown error";
+    }
+    return found->description;
+}
+
+mtsMaxonEPOSDriver * mtsMaxonEPOSDriver::Create(const Json::Value & jsonConfig)
+{
+    const std::string backend = jsonConfig.get("backend", "EposCmdLib").asString();
+    mtsMaxonEPOSDriver * driver = nullptr;
+    if (backend == "simulated") {
+        driver = new mtsMaxonEPOSDriverSimulated;
+    }
+    else if (backend == "replay") {
+        driver = new mtsMaxonEPOSDriverReplay;
+    }
+#if sawMaxonEPOS_HAS_EposCmdLib
+    else if (backend == "EposCmdLib") {
+        driver = new mtsMaxonEPOSDriverEposCmd;
+    }
+#endif
+    else {
+        CMN_LOG_INIT_ERROR << "mtsMaxonEPOSDriver::Create: backend \"" << backend
+                           << "\" is not supported by this build" << std::endl;
+        return nullptr;
+    }
+
+    if (!driver->Configure(jsonConfig)) {
+        CMN_LOG_INIT_ERROR << "mtsMaxonEPOSDriver::Create: failed to configure backend \""
+                           << backend << "\"" << std::endl;
+        delete driver;
+        return nullptr;
+    }
+    return driver;
+}
@@ -0,0 +1,337 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+  (C) Copyright 2024-2025 Johns Hopkins University (JHU)
+
+--- begin cisst license - do not edit ---
+This software is provided "as is" under an open source license, with no warranty.
+--- end cisst license ---
+*/
+
+#include "Definitions.h"  // EPOS Command Library
+#include <cisstCommon/cmnPortability.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSDriverEposCmd.h>
+
+#if (CISST_OS == CISST_WINDOWS)
+#define DWORD_CAST(A) (reinterpret_cast<DWORD *>(A))
+#else
+#define DWORD_CAST(A) (A)
+#endif
+
+void * mtsMaxonEPOSDriverEposCmd::OpenDevice(const std::string & deviceName, const std::string & protocolStackName,
+                                            const std::string & interfaceName, const std::string & portName,
+                                            unsigned int & errorCode)
+{
+    return VCS_OpenDevice(const_cast<char*>(deviceName.c_str()),
+                          const_cast<char*>(protocolStackName.c_str()),
+                          const_cast<char*>(interfaceName.c_str()),
+                          const_cast<char*>(portName.c_str()),
+                          DWORD_CAST(&errorCode));
+}
+
+void * mtsMaxonEPOSDriverEposCmd::OpenSubDevice(void * deviceHandle, const std::string & deviceName,
+                                               const std::string & protocolStackName, unsigned int & errorCode)
+{
+    return VCS_OpenSubDevice(deviceHandle,
+                             const_cast<char*>(deviceName.c_str()),
+                             const_cast<char*>(protocolStackName.c_str()),
+                             DWORD_CAST(&errorCode));
+}
+
+bool mtsMaxonEPOSDriverEposCmd::CloseSubDevice(void * handle, unsigned int & errorCode)
+{
+    return VCS_CloseSubDevice(handle, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::CloseDevice(void * handle, unsigned int & errorCode)
+{
+    return VCS_CloseDevice(handle, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::GetProtocolStackSettings(void * handle, unsigned int & baudrate, unsigned int & timeout,
+                                                         unsigned int & errorCode)
+{
+    return VCS_GetProtocolStackSettings(handle, DWORD_CAST(&baudrate), DWORD_CAST(&timeout), DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::SetProtocolStackSettings(void * handle, unsigned int baudrate, unsigned int timeout,
+                                                         unsigned int & errorCode)
+{
+    return VCS_SetProtocolStackSettings(handle, baudrate, timeout, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::SendNMTService(void * handle, unsigned short nodeId, unsigned short commandSpecifier,
+                                               unsigned int & errorCode)
+{
+    return VCS_SendNMTService(handle, nodeId, commandSpecifier, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::ClearFault(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_ClearFault(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::GetFaultState(void * handle, unsigned short nodeId, bool & isFault, unsigned int & errorCode)
+{
+    int fault = 0;
+    bool ok = (VCS_GetFaultState(handle, nodeId, &fault, DWORD_CAST(&errorCode)) != 0);
+    isFault = (fault != 0);
+    return ok;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::GetEnableState(void * handle, unsigned short nodeId, bool & isEnabled, unsigned int & errorCode)
+{
+    int enabled = 0;
+    bool ok = (VCS_GetEnableState(handle, nodeId, &enabled, DWORD_CAST(&errorCode)) != 0);
+    isEnabled = (enabled != 0);
+    return ok;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::SetEnableState(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_SetEnableState(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::SetDisableState(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_SetDisableState(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::GetState(void * handle, unsigned short nodeId, unsigned short & state, unsigned int & errorCode)
+{
+    return VCS_GetState(handle, nodeId, &state, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::GetPositionIs(void * handle, unsigned short nodeId, int & position, unsigned int & errorCode)
+{
+#if (CISST_OS == CISST_WINDOWS)
+    long positionCounts = 0;
+#else
+    int positionCounts = 0;
+#endif
+    bool ok = (VCS_GetPositionIs(handle, nodeId, &positionCounts, DWORD_CAST(&errorCode)) != 0);
+    position = static_cast<int>(positionCounts);
+    return ok;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::GetCurrentIs(void * handle, unsigned short nodeId, short & current, unsigned int & errorCode)
+{
+    return VCS_GetCurrentIs(handle, nodeId, &current, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::ActivateProfilePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_ActivateProfilePositionMode(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::ActivatePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_ActivatePositionMode(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::ActivateVelocityMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_ActivateVelocityMode(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::ActivateCurrentMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_ActivateCurrentMode(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::ActivateInterpolatedPositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_ActivateInterpolatedPositionMode(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::SetPositionProfile(void * handle, unsigned short nodeId, unsigned int profileVelocity,
+                                                   unsigned int profileAcceleration, unsigned int profileDeceleration,
+                                                   unsigned int & errorCode)
+{
+    return VCS_SetPositionProfile(handle, nodeId, profileVelocity, profileAcceleration, profileDeceleration,
+                                  DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::MoveToPosition(void * handle, unsigned short nodeId, int targetPosition,
+                                               bool absolute, bool immediately, unsigned int & errorCode)
+{
+    return VCS_MoveToPosition(handle, nodeId, targetPosition, absolute ? 1 : 0, immediately ? 1 : 0,
+                              DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::HaltPositionMovement(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_HaltPositionMovement(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::HaltVelocityMovement(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_HaltVelocityMovement(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::SetPositionMust(void * handle, unsigned short nodeId, int position, unsigned int & errorCode)
+{
+    return VCS_SetPositionMust(handle, nodeId, position, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::SetVelocityMust(void * handle, unsigned short nodeId, int velocity, unsigned int & errorCode)
+{
+    return VCS_SetVelocityMust(handle, nodeId, velocity, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::SetCurrentMust(void * handle, unsigned short nodeId, short current, unsigned int & errorCode)
+{
+    return VCS_SetCurrentMust(handle, nodeId, current, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::SetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short underflowWarningLimit,
+                                                      unsigned short overflowWarningLimit, unsigned int & errorCode)
+{
+    return VCS_SetIpmBufferParameter(handle, nodeId, underflowWarningLimit, overflowWarningLimit,
+                                     DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::GetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short & underflowWarningLimit,
+                                                      unsigned short & overflowWarningLimit, unsigned int & maxBufferSize,
+                                                      unsigned int & errorCode)
+{
+    return VCS_GetIpmBufferParameter(handle, nodeId, &underflowWarningLimit, &overflowWarningLimit,
+                                     DWORD_CAST(&maxBufferSize), DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::ClearIpmBuffer(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_ClearIpmBuffer(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::GetFreeIpmBufferSize(void * handle, unsigned short nodeId, unsigned int & bufferSize,
+                                                     unsigned int & errorCode)
+{
+    return VCS_GetFreeIpmBufferSize(handle, nodeId, DWORD_CAST(&bufferSize), DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::AddPvtValueToIpmBuffer(void * handle, unsigned short nodeId, int position, int velocity,
+                                                       unsigned char time, unsigned int & errorCode)
+{
+    return VCS_AddPvtValueToIpmBuffer(handle, nodeId, position, velocity, time, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::StartIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_StartIpmTrajectory(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::StopIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_StopIpmTrajectory(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::GetIpmStatus(void * handle, unsigned short nodeId, IpmStatus & status, unsigned int & errorCode)
+{
+    int flags[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+    bool ok = (VCS_GetIpmStatus(handle, nodeId, &flags[0], &flags[1], &flags[2], &flags[3], &flags[4],
+                                &flags[5], &flags[6], &flags[7], &flags[8], DWORD_CAST(&errorCode)) != 0);
+    status.trajectoryRunning   = (flags[0] != 0);
+    status.underflowWarning    = (flags[1] != 0);
+    status.overflowWarning     = (flags[2] != 0);
+    status.velocityWarning     = (flags[3] != 0);
+    status.accelerationWarning = (flags[4] != 0);
+    status.underflowError      = (flags[5] != 0);
+    status.overflowError       = (flags[6] != 0);
+    status.velocityError       = (flags[7] != 0);
+    status.accelerationError   = (flags[8] != 0);
+    return ok;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::GetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                                          void * data, unsigned int numberOfBytesToRead, unsigned int & numberOfBytesRead,
+                                          unsigned int & errorCode)
+{
+    return VCS_GetObject(handle, nodeId, objectIndex, objectSubIndex, data, numberOfBytesToRead,
+                         DWORD_CAST(&numberOfBytesRead), DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::SetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                                          const void * data, unsigned int numberOfBytesToWrite, unsigned int & numberOfBytesWritten,
+                                          unsigned int & errorCode)
+{
+    return VCS_SetObject(handle, nodeId, objectIndex, objectSubIndex, const_cast<void *>(data), numberOfBytesToWrite,
+                         DWORD_CAST(&numberOfBytesWritten), DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::SetRecorderParameter(void * handle, unsigned short nodeId, unsigned short samplingPeriod,
+                                                     unsigned short numberOfPrecedingSamples, unsigned int & errorCode)
+{
+    return VCS_SetRecorderParameter(handle, nodeId, samplingPeriod, numberOfPrecedingSamples, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::EnableTrigger(void * handle, unsigned short nodeId, unsigned char triggerType, unsigned int & errorCode)
+{
+    return VCS_EnableTrigger(handle, nodeId, triggerType, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::DisableAllTriggers(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_DisableAllTriggers(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::ActivateChannel(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                                                unsigned short objectIndex, unsigned char objectSubIndex, unsigned char objectSize,
+                                                unsigned int & errorCode)
+{
+    return VCS_ActivateChannel(handle, nodeId, channelNumber, objectIndex, objectSubIndex, objectSize,
+                               DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::DeactivateAllChannels(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_DeactivateAllChannels(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::StartRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_StartRecorder(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::StopRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_StopRecorder(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::ForceTrigger(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    return VCS_ForceTrigger(handle, nodeId, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::IsRecorderRunning(void * handle, unsigned short nodeId, bool & isRunning, unsigned int & errorCode)
+{
+    int running = 0;
+    const bool ok = (VCS_IsRecorderRunning(handle, nodeId, &running, DWORD_CAST(&errorCode)) != 0);
+    isRunning = (running != 0);
+    return ok;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::ReadChannelVectorSize(void * handle, unsigned short nodeId, unsigned int & vectorSize,
+                                                      unsigned int & errorCode)
+{
+    return VCS_ReadChannelVectorSize(handle, nodeId, DWORD_CAST(&vectorSize), DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::ReadChannelDataVector(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                                                      void * data, unsigned int bufferSize, unsigned int & errorCode)
+{
+    return VCS_ReadChannelDataVector(handle, nodeId, channelNumber, static_cast<unsigned char *>(data), bufferSize,
+                                     DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::ReadCANFrame(void * handle, unsigned short cobId, unsigned short length, void * data,
+                                             unsigned int timeout, unsigned int & errorCode)
+{
+    return VCS_ReadCANFrame(handle, cobId, length, data, timeout, DWORD_CAST(&errorCode)) != 0;
+}
+
+bool mtsMaxonEPOSDriverEposCmd::SendCANFrame(void * handle, unsigned short cobId, unsigned short length, const void * data,
+                                             unsigned int & errorCode)
+{
+    return VCS_SendCANFrame(handle, cobId, length, const_cast<void *>(data), DWORD_CAST(&errorCode)) != 0;
+}
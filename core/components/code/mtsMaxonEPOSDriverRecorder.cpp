@@ -0,0 +1,603 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+  (C) Copyright 2024-2025 Johns Hopkins University (JHU)
+
+--- begin cisst license - do not edit ---
+This software is provided "as is" under an open source license, with no warranty.
+--- end cisst license ---
+*/
+
+#include <cerrno>
+#include <cstring>
+
+#include <sawMaxonEPOS/mtsMaxonEPOSDriverRecorder.h>
+
+const char mtsMaxonEPOSDriverRecorder::FileHeader[8] = {'E', 'P', 'O', 'S', 'R', 'C', '0', '1'};
+
+mtsMaxonEPOSDriverRecorder::Record::Record(mtsMaxonEPOSDriverRecorder & recorder, Call call,
+                                           void * handle, unsigned short address) :
+    mRecorder(recorder),
+    mCall(call),
+    mAddress(address),
+    mBus(recorder.Bus(handle)),
+    mStart(std::chrono::steady_clock::now()),
+    mResult(false),
+    mErrorCode(0),
+    mInputSize(0),
+    mOutputSize(0)
+{}
+
+mtsMaxonEPOSDriverRecorder::Record::~Record()
+{
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    const double time = std::chrono::duration<double>(mStart - mRecorder.mStart).count();
+    const float duration = std::chrono::duration<float>(end - mStart).count();
+    const uint32_t errorCode = mErrorCode;
+    const uint16_t address = mAddress;
+    const uint8_t call = static_cast<uint8_t>(mCall);
+    const uint8_t result = mResult ? 1 : 0;
+    const uint16_t inputSize = static_cast<uint16_t>(mInputSize);
+    const uint16_t outputSize = static_cast<uint16_t>(mOutputSize);
+
+    uint8_t header[RecordHeaderSize];
+    uint8_t * position = header;
+    std::memcpy(position, &time, sizeof(time));             position += sizeof(time);
+    std::memcpy(position, &duration, sizeof(duration));     position += sizeof(duration);
+    std::memcpy(position, &errorCode, sizeof(errorCode));   position += sizeof(errorCode);
+    std::memcpy(position, &address, sizeof(address));       position += sizeof(address);
+    std::memcpy(position, &mBus, sizeof(mBus));             position += sizeof(mBus);
+    std::memcpy(position, &call, sizeof(call));             position += sizeof(call);
+    std::memcpy(position, &result, sizeof(result));         position += sizeof(result);
+    std::memcpy(position, &inputSize, sizeof(inputSize));   position += sizeof(inputSize);
+    std::memcpy(position, &outputSize, sizeof(outputSize));
+    mRecorder.Write(header, mInputs, mInputSize, mOutputs, mOutputSize);
+}
+
+void mtsMaxonEPOSDriverRecorder::Record::Append(uint8_t * buffer, size_t & size, const void * data, size_t dataSize)
+{
+    if (size + dataSize > MaximumDataSize) {
+        dataSize = MaximumDataSize - size;
+    }
+    std::memcpy(buffer + size, data, dataSize);
+    size += dataSize;
+}
+
+void mtsMaxonEPOSDriverRecorder::Record::AppendBuffer(uint8_t * buffer, size_t & size, const void * data, size_t dataSize)
+{
+    if (size + sizeof(uint16_t) + dataSize > MaximumDataSize) {
+        if (size + sizeof(uint16_t) > MaximumDataSize) {
+            return;
+        }
+        dataSize = MaximumDataSize - size - sizeof(uint16_t);
+    }
+    const uint16_t length = static_cast<uint16_t>(dataSize);
+    Append(buffer, size, &length, sizeof(length));
+    Append(buffer, size, data, dataSize);
+}
+
+mtsMaxonEPOSDriverRecorder::mtsMaxonEPOSDriverRecorder(mtsMaxonEPOSDriver * driver) :
+    mDriver(driver),
+    mFile(nullptr),
+    mStart(std::chrono::steady_clock::now()),
+    mNumberOfRecords(0),
+    mNumberOfBuses(0)
+{}
+
+mtsMaxonEPOSDriverRecorder::~mtsMaxonEPOSDriverRecorder()
+{
+    Close();
+    delete mDriver;
+}
+
+bool mtsMaxonEPOSDriverRecorder::Open(const std::string & fileName, std::string & error)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mFile) {
+        std::fclose(mFile);
+    }
+    mFile = std::fopen(fileName.c_str(), "wb");
+    if (!mFile) {
+        error = "failed to create \"" + fileName + "\": " + std::strerror(errno);
+        return false;
+    }
+    // large buffer, the file is only written when it's full
+    mFileBuffer.resize(1 << 20);
+    std::setvbuf(mFile, mFileBuffer.data(), _IOFBF, mFileBuffer.size());
+    if (std::fwrite(FileHeader, sizeof(FileHeader), 1, mFile) != 1) {
+        error = "failed to write header to \"" + fileName + "\"";
+        std::fclose(mFile);
+        mFile = nullptr;
+        return false;
+    }
+    mStart = std::chrono::steady_clock::now();
+    mNumberOfRecords = 0;
+    return true;
+}
+
+void mtsMaxonEPOSDriverRecorder::Close(void)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mFile) {
+        std::fclose(mFile);
+        mFile = nullptr;
+    }
+}
+
+void mtsMaxonEPOSDriverRecorder::Write(const uint8_t * header, const uint8_t * inputs, size_t inputSize,
+                                       const uint8_t * outputs, size_t outputSize)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mFile) {
+        return;
+    }
+    std::fwrite(header, RecordHeaderSize, 1, mFile);
+    std::fwrite(inputs, 1, inputSize, mFile);
+    std::fwrite(outputs, 1, outputSize, mFile);
+    ++mNumberOfRecords;
+}
+
+uint16_t mtsMaxonEPOSDriverRecorder::Bus(void * handle)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (size_t index = 0; index < mHandles.size(); ++index) {
+        if (mHandles[index].handle == handle) {
+            return mHandles[index].bus;
+        }
+    }
+    return 0;
+}
+
+uint16_t mtsMaxonEPOSDriverRecorder::AddHandle(void * handle, uint16_t bus)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (bus == 0) {
+        bus = ++mNumberOfBuses;
+    }
+    HandleBus handleBus;
+    handleBus.handle = handle;
+    handleBus.bus = bus;
+    mHandles.push_back(handleBus);
+    return bus;
+}
+
+void mtsMaxonEPOSDriverRecorder::RemoveHandle(void * handle)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (size_t index = 0; index < mHandles.size(); ++index) {
+        if (mHandles[index].handle == handle) {
+            mHandles.erase(mHandles.begin() + index);
+            return;
+        }
+    }
+}
+
+void * mtsMaxonEPOSDriverRecorder::OpenDevice(const std::string & deviceName, const std::string & protocolStackName,
+                                             const std::string & interfaceName, const std::string & portName,
+                                             unsigned int & errorCode)
+{
+    Record record(*this, CALL_OPEN_DEVICE, nullptr, 0);
+    record.Input(deviceName);
+    record.Input(protocolStackName);
+    record.Input(interfaceName);
+    record.Input(portName);
+    void * handle = mDriver->OpenDevice(deviceName, protocolStackName, interfaceName, portName, errorCode);
+    if (handle) {
+        record.SetBus(AddHandle(handle, 0));
+    }
+    record.Result(handle != nullptr, errorCode);
+    return handle;
+}
+
+void * mtsMaxonEPOSDriverRecorder::OpenSubDevice(void * deviceHandle, const std::string & deviceName,
+                                                const std::string & protocolStackName, unsigned int & errorCode)
+{
+    Record record(*this, CALL_OPEN_SUB_DEVICE, deviceHandle, 0);
+    record.Input(deviceName);
+    record.Input(protocolStackName);
+    void * handle = mDriver->OpenSubDevice(deviceHandle, deviceName, protocolStackName, errorCode);
+    if (handle) {
+        AddHandle(handle, Bus(deviceHandle));
+    }
+    record.Result(handle != nullptr, errorCode);
+    return handle;
+}
+
+bool mtsMaxonEPOSDriverRecorder::CloseSubDevice(void * handle, unsigned int & errorCode)
+{
+    Record record(*this, CALL_CLOSE_SUB_DEVICE, handle, 0);
+    const bool result = mDriver->CloseSubDevice(handle, errorCode);
+    RemoveHandle(handle);
+    return record.Result(result, errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::CloseDevice(void * handle, unsigned int & errorCode)
+{
+    Record record(*this, CALL_CLOSE_DEVICE, handle, 0);
+    const bool result = mDriver->CloseDevice(handle, errorCode);
+    RemoveHandle(handle);
+    return record.Result(result, errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::GetProtocolStackSettings(void * handle, unsigned int & baudrate, unsigned int & timeout,
+                                                          unsigned int & errorCode)
+{
+    Record record(*this, CALL_GET_PROTOCOL_STACK_SETTINGS, handle, 0);
+    const bool result = mDriver->GetProtocolStackSettings(handle, baudrate, timeout, errorCode);
+    record.Output(baudrate);
+    record.Output(timeout);
+    return record.Result(result, errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::SetProtocolStackSettings(void * handle, unsigned int baudrate, unsigned int timeout,
+                                                          unsigned int & errorCode)
+{
+    Record record(*this, CALL_SET_PROTOCOL_STACK_SETTINGS, handle, 0);
+    record.Input(baudrate);
+    record.Input(timeout);
+    return record.Result(mDriver->SetProtocolStackSettings(handle, baudrate, timeout, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::SendNMTService(void * handle, unsigned short nodeId, unsigned short commandSpecifier,
+                                                unsigned int & errorCode)
+{
+    Record record(*this, CALL_SEND_NMT_SERVICE, handle, nodeId);
+    record.Input(commandSpecifier);
+    return record.Result(mDriver->SendNMTService(handle, nodeId, commandSpecifier, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::ClearFault(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_CLEAR_FAULT, handle, nodeId);
+    return record.Result(mDriver->ClearFault(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::GetFaultState(void * handle, unsigned short nodeId, bool & isFault, unsigned int & errorCode)
+{
+    Record record(*this, CALL_GET_FAULT_STATE, handle, nodeId);
+    const bool result = mDriver->GetFaultState(handle, nodeId, isFault, errorCode);
+    record.Output(isFault);
+    return record.Result(result, errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::GetEnableState(void * handle, unsigned short nodeId, bool & isEnabled, unsigned int & errorCode)
+{
+    Record record(*this, CALL_GET_ENABLE_STATE, handle, nodeId);
+    const bool result = mDriver->GetEnableState(handle, nodeId, isEnabled, errorCode);
+    record.Output(isEnabled);
+    return record.Result(result, errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::SetEnableState(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_SET_ENABLE_STATE, handle, nodeId);
+    return record.Result(mDriver->SetEnableState(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::SetDisableState(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_SET_DISABLE_STATE, handle, nodeId);
+    return record.Result(mDriver->SetDisableState(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::GetState(void * handle, unsigned short nodeId, unsigned short & state, unsigned int & errorCode)
+{
+    Record record(*this, CALL_GET_STATE, handle, nodeId);
+    const bool result = mDriver->GetState(handle, nodeId, state, errorCode);
+    record.Output(state);
+    return record.Result(result, errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::GetPositionIs(void * handle, unsigned short nodeId, int & position, unsigned int & errorCode)
+{
+    Record record(*this, CALL_GET_POSITION_IS, handle, nodeId);
+    const bool result = mDriver->GetPositionIs(handle, nodeId, position, errorCode);
+    record.Output(position);
+    return record.Result(result, errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::GetCurrentIs(void * handle, unsigned short nodeId, short & current, unsigned int & errorCode)
+{
+    Record record(*this, CALL_GET_CURRENT_IS, handle, nodeId);
+    const bool result = mDriver->GetCurrentIs(handle, nodeId, current, errorCode);
+    record.Output(current);
+    return record.Result(result, errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::ActivateProfilePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_ACTIVATE_PROFILE_POSITION_MODE, handle, nodeId);
+    return record.Result(mDriver->ActivateProfilePositionMode(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::ActivatePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_ACTIVATE_POSITION_MODE, handle, nodeId);
+    return record.Result(mDriver->ActivatePositionMode(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::ActivateVelocityMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_ACTIVATE_VELOCITY_MODE, handle, nodeId);
+    return record.Result(mDriver->ActivateVelocityMode(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::ActivateCurrentMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_ACTIVATE_CURRENT_MODE, handle, nodeId);
+    return record.Result(mDriver->ActivateCurrentMode(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::ActivateInterpolatedPositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_ACTIVATE_INTERPOLATED_POSITION_MODE, handle, nodeId);
+    return record.Result(mDriver->ActivateInterpolatedPositionMode(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::SetPositionProfile(void * handle, unsigned short nodeId, unsigned int profileVelocity,
+                                                    unsigned int profileAcceleration, unsigned int profileDeceleration,
+                                                    unsigned int & errorCode)
+{
+    Record record(*this, CALL_SET_POSITION_PROFILE, handle, nodeId);
+    record.Input(profileVelocity);
+    record.Input(profileAcceleration);
+    record.Input(profileDeceleration);
+    return record.Result(mDriver->SetPositionProfile(handle, nodeId, profileVelocity, profileAcceleration,
+                                                     profileDeceleration, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::MoveToPosition(void * handle, unsigned short nodeId, int targetPosition,
+                                                bool absolute, bool immediately, unsigned int & errorCode)
+{
+    Record record(*this, CALL_MOVE_TO_POSITION, handle, nodeId);
+    record.Input(targetPosition);
+    record.Input(absolute);
+    record.Input(immediately);
+    return record.Result(mDriver->MoveToPosition(handle, nodeId, targetPosition, absolute, immediately, errorCode),
+                         errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::HaltPositionMovement(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_HALT_POSITION_MOVEMENT, handle, nodeId);
+    return record.Result(mDriver->HaltPositionMovement(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::HaltVelocityMovement(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_HALT_VELOCITY_MOVEMENT, handle, nodeId);
+    return record.Result(mDriver->HaltVelocityMovement(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::SetPositionMust(void * handle, unsigned short nodeId, int position, unsigned int & errorCode)
+{
+    Record record(*this, CALL_SET_POSITION_MUST, handle, nodeId);
+    record.Input(position);
+    return record.Result(mDriver->SetPositionMust(handle, nodeId, position, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::SetVelocityMust(void * handle, unsigned short nodeId, int velocity, unsigned int & errorCode)
+{
+    Record record(*this, CALL_SET_VELOCITY_MUST, handle, nodeId);
+    record.Input(velocity);
+    return record.Result(mDriver->SetVelocityMust(handle, nodeId, velocity, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::SetCurrentMust(void * handle, unsigned short nodeId, short current, unsigned int & errorCode)
+{
+    Record record(*this, CALL_SET_CURRENT_MUST, handle, nodeId);
+    record.Input(current);
+    return record.Result(mDriver->SetCurrentMust(handle, nodeId, current, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::SetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short underflowWarningLimit,
+                                                       unsigned short overflowWarningLimit, unsigned int & errorCode)
+{
+    Record record(*this, CALL_SET_IPM_BUFFER_PARAMETER, handle, nodeId);
+    record.Input(underflowWarningLimit);
+    record.Input(overflowWarningLimit);
+    return record.Result(mDriver->SetIpmBufferParameter(handle, nodeId, underflowWarningLimit, overflowWarningLimit,
+                                                        errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::GetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short & underflowWarningLimit,
+                                                       unsigned short & overflowWarningLimit, unsigned int & maxBufferSize,
+                                                       unsigned int & errorCode)
+{
+    Record record(*this, CALL_GET_IPM_BUFFER_PARAMETER, handle, nodeId);
+    const bool result = mDriver->GetIpmBufferParameter(handle, nodeId, underflowWarningLimit, overflowWarningLimit,
+                                                       maxBufferSize, errorCode);
+    record.Output(underflowWarningLimit);
+    record.Output(overflowWarningLimit);
+    record.Output(maxBufferSize);
+    return record.Result(result, errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::ClearIpmBuffer(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_CLEAR_IPM_BUFFER, handle, nodeId);
+    return record.Result(mDriver->ClearIpmBuffer(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::GetFreeIpmBufferSize(void * handle, unsigned short nodeId, unsigned int & bufferSize,
+                                                      unsigned int & errorCode)
+{
+    Record record(*this, CALL_GET_FREE_IPM_BUFFER_SIZE, handle, nodeId);
+    const bool result = mDriver->GetFreeIpmBufferSize(handle, nodeId, bufferSize, errorCode);
+    record.Output(bufferSize);
+    return record.Result(result, errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::AddPvtValueToIpmBuffer(void * handle, unsigned short nodeId, int position, int velocity,
+                                                        unsigned char time, unsigned int & errorCode)
+{
+    Record record(*this, CALL_ADD_PVT_VALUE_TO_IPM_BUFFER, handle, nodeId);
+    record.Input(position);
+    record.Input(velocity);
+    record.Input(time);
+    return record.Result(mDriver->AddPvtValueToIpmBuffer(handle, nodeId, position, velocity, time, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::StartIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_START_IPM_TRAJECTORY, handle, nodeId);
+    return record.Result(mDriver->StartIpmTrajectory(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::StopIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_STOP_IPM_TRAJECTORY, handle, nodeId);
+    return record.Result(mDriver->StopIpmTrajectory(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::GetIpmStatus(void * handle, unsigned short nodeId, IpmStatus & status, unsigned int & errorCode)
+{
+    Record record(*this, CALL_GET_IPM_STATUS, handle, nodeId);
+    const bool result = mDriver->GetIpmStatus(handle, nodeId, status, errorCode);
+    record.Output(status.trajectoryRunning);
+    record.Output(status.underflowWarning);
+    record.Output(status.overflowWarning);
+    record.Output(status.velocityWarning);
+    record.Output(status.accelerationWarning);
+    record.Output(status.underflowError);
+    record.Output(status.overflowError);
+    record.Output(status.velocityError);
+    record.Output(status.accelerationError);
+    return record.Result(result, errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::GetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                                           void * data, unsigned int numberOfBytesToRead, unsigned int & numberOfBytesRead,
+                                           unsigned int & errorCode)
+{
+    Record record(*this, CALL_GET_OBJECT, handle, nodeId);
+    record.Input(objectIndex);
+    record.Input(objectSubIndex);
+    record.Input(numberOfBytesToRead);
+    const bool result = mDriver->GetObject(handle, nodeId, objectIndex, objectSubIndex, data, numberOfBytesToRead,
+                                           numberOfBytesRead, errorCode);
+    record.OutputBuffer(data, result ? numberOfBytesRead : 0);
+    return record.Result(result, errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::SetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                                           const void * data, unsigned int numberOfBytesToWrite, unsigned int & numberOfBytesWritten,
+                                           unsigned int & errorCode)
+{
+    Record record(*this, CALL_SET_OBJECT, handle, nodeId);
+    record.Input(objectIndex);
+    record.Input(objectSubIndex);
+    record.InputBuffer(data, numberOfBytesToWrite);
+    const bool result = mDriver->SetObject(handle, nodeId, objectIndex, objectSubIndex, data, numberOfBytesToWrite,
+                                           numberOfBytesWritten, errorCode);
+    record.Output(numberOfBytesWritten);
+    return record.Result(result, errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::SetRecorderParameter(void * handle, unsigned short nodeId, unsigned short samplingPeriod,
+                                                      unsigned short numberOfPrecedingSamples, unsigned int & errorCode)
+{
+    Record record(*this, CALL_SET_RECORDER_PARAMETER, handle, nodeId);
+    record.Input(samplingPeriod);
+    record.Input(numberOfPrecedingSamples);
+    return record.Result(mDriver->SetRecorderParameter(handle, nodeId, samplingPeriod, numberOfPrecedingSamples, errorCode),
+                         errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::EnableTrigger(void * handle, unsigned short nodeId, unsigned char triggerType, unsigned int & errorCode)
+{
+    Record record(*this, CALL_ENABLE_TRIGGER, handle, nodeId);
+    record.Input(triggerType);
+    return record.Result(mDriver->EnableTrigger(handle, nodeId, triggerType, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::DisableAllTriggers(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_DISABLE_ALL_TRIGGERS, handle, nodeId);
+    return record.Result(mDriver->DisableAllTriggers(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::ActivateChannel(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                                                 unsigned short objectIndex, unsigned char objectSubIndex, unsigned char objectSize,
+                                                 unsigned int & errorCode)
+{
+    Record record(*this, CALL_ACTIVATE_CHANNEL, handle, nodeId);
+    record.Input(channelNumber);
+    record.Input(objectIndex);
+    record.Input(objectSubIndex);
+    record.Input(objectSize);
+    return record.Result(mDriver->ActivateChannel(handle, nodeId, channelNumber, objectIndex, objectSubIndex,
+                                                  objectSize, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::DeactivateAllChannels(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_DEACTIVATE_ALL_CHANNELS, handle, nodeId);
+    return record.Result(mDriver->DeactivateAllChannels(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::StartRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_START_RECORDER, handle, nodeId);
+    return record.Result(mDriver->StartRecorder(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::StopRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_STOP_RECORDER, handle, nodeId);
+    return record.Result(mDriver->StopRecorder(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::ForceTrigger(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Record record(*this, CALL_FORCE_TRIGGER, handle, nodeId);
+    return record.Result(mDriver->ForceTrigger(handle, nodeId, errorCode), errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::IsRecorderRunning(void * handle, unsigned short nodeId, bool & isRunning, unsigned int & errorCode)
+{
+    Record record(*this, CALL_IS_RECORDER_RUNNING, handle, nodeId);
+    const bool result = mDriver->IsRecorderRunning(handle, nodeId, isRunning, errorCode);
+    record.Output(isRunning);
+    return record.Result(result, errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::ReadChannelVectorSize(void * handle, unsigned short nodeId, unsigned int & vectorSize,
+                                                       unsigned int & errorCode)
+{
+    Record record(*this, CALL_READ_CHANNEL_VECTOR_SIZE, handle, nodeId);
+    const bool result = mDriver->ReadChannelVectorSize(handle, nodeId, vectorSize, errorCode);
+    record.Output(vectorSize);
+    return record.Result(result, errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::ReadChannelDataVector(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                                                       void * data, unsigned int bufferSize, unsigned int & errorCode)
+{
+    Record record(*this, CALL_READ_CHANNEL_DATA_VECTOR, handle, nodeId);
+    record.Input(channelNumber);
+    record.Input(bufferSize);
+    const bool result = mDriver->ReadChannelDataVector(handle, nodeId, channelNumber, data, bufferSize, errorCode);
+    // truncated to MaximumDataSize, replays return the beginning of the vector
+    record.OutputBuffer(data, result ? bufferSize : 0);
+    return record.Result(result, errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::ReadCANFrame(void * handle, unsigned short cobId, unsigned short length, void * data,
+                                              unsigned int timeout, unsigned int & errorCode)
+{
+    Record record(*this, CALL_READ_CAN_FRAME, handle, cobId);
+    record.Input(length);
+    record.Input(timeout);
+    const bool result = mDriver->ReadCANFrame(handle, cobId, length, data, timeout, errorCode);
+    record.OutputBuffer(data, result ? length : 0);
+    return record.Result(result, errorCode);
+}
+
+bool mtsMaxonEPOSDriverRecorder::SendCANFrame(void * handle, unsigned short cobId, unsigned short length, const void * data,
+                                              unsigned int & errorCode)
+{
+    Record record(*this, CALL_SEND_CAN_FRAME, handle, cobId);
+    record.InputBuffer(data, length);
+    return record.Result(mDriver->SendCANFrame(handle, cobId, length, data, errorCode), errorCode);
+}
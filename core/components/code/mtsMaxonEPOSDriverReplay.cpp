@@ -0,0 +1,700 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+  (C) Copyright 2024-2025 Johns Hopkins University (JHU)
+
+--- begin cisst license - do not edit ---
+This software is provided "as is" under an open source license, with no warranty.
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#include <cisstCommon/cmnLogger.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSDriverRecorder.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSDriverReplay.h>
+
+// Number of mismatches logged individually, the others are only counted
+static const unsigned long long MaximumMismatchesLogged = 10;
+
+mtsMaxonEPOSDriverReplay::Replay::Replay(mtsMaxonEPOSDriverReplay & driver, Call call,
+                                         void * handle, unsigned short address) :
+    mDriver(driver),
+    mCall(call),
+    mAddress(address),
+    mBus(mtsMaxonEPOSDriverReplay::Bus(handle)),
+    mExecuted(false),
+    mFound(false),
+    mOutputPosition(0)
+{}
+
+mtsMaxonEPOSDriverReplay::Replay::~Replay()
+{
+    Execute();
+}
+
+void mtsMaxonEPOSDriverReplay::Replay::InputBuffer(const void * data, size_t size)
+{
+    // same layout and truncation as the recorder
+    const size_t maximum = mtsMaxonEPOSDriverRecorder::MaximumDataSize;
+    if (mInputs.size() + sizeof(uint16_t) > maximum) {
+        return;
+    }
+    size = std::min(size, maximum - mInputs.size() - sizeof(uint16_t));
+    const uint16_t length = static_cast<uint16_t>(size);
+    Append(&length, sizeof(length));
+    Append(data, size);
+}
+
+void mtsMaxonEPOSDriverReplay::Replay::Append(const void * data, size_t size)
+{
+    const size_t maximum = mtsMaxonEPOSDriverRecorder::MaximumDataSize;
+    size = std::min(size, maximum - mInputs.size());
+    const uint8_t * bytes = static_cast<const uint8_t *>(data);
+    mInputs.insert(mInputs.end(), bytes, bytes + size);
+}
+
+void mtsMaxonEPOSDriverReplay::Replay::Extract(void * data, size_t size)
+{
+    Execute();
+    if (mOutputPosition + size > mRecord.outputs.size()) {
+        std::memset(data, 0, size);
+        mOutputPosition = mRecord.outputs.size();
+        return;
+    }
+    std::memcpy(data, mRecord.outputs.data() + mOutputPosition, size);
+    mOutputPosition += size;
+}
+
+size_t mtsMaxonEPOSDriverReplay::Replay::OutputBuffer(void * data, size_t size)
+{
+    uint16_t length = 0;
+    Extract(&length, sizeof(length));
+    const size_t available = std::min(static_cast<size_t>(length), mRecord.outputs.size() - mOutputPosition);
+    std::memcpy(data, mRecord.outputs.data() + mOutputPosition, std::min(size, available));
+    mOutputPosition += available;
+    return available;
+}
+
+uint16_t mtsMaxonEPOSDriverReplay::Replay::Bus(void)
+{
+    Execute();
+    return mRecord.bus;
+}
+
+bool mtsMaxonEPOSDriverReplay::Replay::Result(unsigned int & errorCode)
+{
+    Execute();
+    if (!mFound) {
+        errorCode = ERROR_NO_RECORD;
+        return false;
+    }
+    errorCode = mRecord.errorCode;
+    return (mRecord.result != 0);
+}
+
+void mtsMaxonEPOSDriverReplay::Replay::Execute(void)
+{
+    if (mExecuted) {
+        return;
+    }
+    mExecuted = true;
+    mFound = mDriver.Next(mCall, mBus, mAddress, mInputs, mRecord);
+    if (!mFound) {
+        mRecord.bus = 0;
+        mRecord.outputs.clear();
+        const unsigned long long missing = ++mDriver.mNumberOfMissing;
+        if (missing == 1) {
+            CMN_LOG_RUN_WARNING << "mtsMaxonEPOSDriverReplay: no record left for " << CallName(mCall)
+                                << " on bus " << mBus << ", address " << mAddress
+                                << ", further missing records are only counted" << std::endl;
+        }
+        return;
+    }
+    if (mRecord.inputs != mInputs) {
+        const unsigned long long mismatches = ++mDriver.mNumberOfMismatches;
+        if (mismatches <= MaximumMismatchesLogged) {
+            CMN_LOG_RUN_WARNING << "mtsMaxonEPOSDriverReplay: inputs of " << CallName(mCall)
+                                << " on bus " << mBus << ", address " << mAddress
+                                << " differ from the record at " << mRecord.time << "s" << std::endl;
+        }
+    }
+    mDriver.Wait(mRecord.time);
+    if (mDriver.mSpeed > 0.0) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(mRecord.duration / mDriver.mSpeed));
+    }
+}
+
+mtsMaxonEPOSDriverReplay::mtsMaxonEPOSDriverReplay() :
+    mFile(nullptr),
+    mSpeed(1.0),
+    mStarted(false),
+    mFirstRecordTime(0.0),
+    mNumberOfMismatches(0),
+    mNumberOfMissing(0)
+{}
+
+mtsMaxonEPOSDriverReplay::~mtsMaxonEPOSDriverReplay()
+{
+    if (mFile) {
+        std::fclose(mFile);
+    }
+    if ((mNumberOfMismatches > 0) || (mNumberOfMissing > 0)) {
+        CMN_LOG_INIT_WARNING << "mtsMaxonEPOSDriverReplay: " << mNumberOfMismatches
+                             << " call(s) with inputs different from the record, "
+                             << mNumberOfMissing << " call(s) without record" << std::endl;
+    }
+}
+
+bool mtsMaxonEPOSDriverReplay::Configure(const Json::Value & jsonConfig)
+{
+    const Json::Value & replay = jsonConfig["replay"];
+    if (!replay.isObject() || !replay["file"].isString()) {
+        CMN_LOG_INIT_ERROR << "mtsMaxonEPOSDriverReplay::Configure: \"replay\" must define \"file\"" << std::endl;
+        return false;
+    }
+    std::string error;
+    if (!Open(replay["file"].asString(), replay.get("speed", 1.0).asDouble(), error)) {
+        CMN_LOG_INIT_ERROR << "mtsMaxonEPOSDriverReplay::Configure: " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool mtsMaxonEPOSDriverReplay::Open(const std::string & fileName, double speed, std::string & error)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (speed < 0.0) {
+        error = "replay speed must be positive, or 0 to replay as fast as possible";
+        return false;
+    }
+    if (mFile) {
+        std::fclose(mFile);
+    }
+    mPending.clear();
+    mFile = std::fopen(fileName.c_str(), "rb");
+    if (!mFile) {
+        error = "failed to open \"" + fileName + "\": " + std::strerror(errno);
+        return false;
+    }
+    char header[sizeof(mtsMaxonEPOSDriverRecorder::FileHeader)];
+    if ((std::fread(header, sizeof(header), 1, mFile) != 1)
+        || (std::memcmp(header, mtsMaxonEPOSDriverRecorder::FileHeader, sizeof(header)) != 0)) {
+        error = "\"" + fileName + "\" is not an EPOS recording";
+        std::fclose(mFile);
+        mFile = nullptr;
+        return false;
+    }
+    mSpeed = speed;
+    mStarted = false;
+    return true;
+}
+
+uint64_t mtsMaxonEPOSDriverReplay::Key(uint8_t call, uint16_t bus, uint16_t address)
+{
+    // devices are opened before their bus is known
+    if (call == CALL_OPEN_DEVICE) {
+        bus = 0;
+    }
+    return (static_cast<uint64_t>(call) << 32) | (static_cast<uint64_t>(bus) << 16) | address;
+}
+
+bool mtsMaxonEPOSDriverReplay::ReadRecord(RecordData & record)
+{
+    if (!mFile) {
+        return false;
+    }
+    uint8_t header[mtsMaxonEPOSDriverRecorder::RecordHeaderSize];
+    if (std::fread(header, sizeof(header), 1, mFile) != 1) {
+        return false;
+    }
+    uint16_t inputSize, outputSize;
+    const uint8_t * position = header;
+    std::memcpy(&record.time, position, sizeof(record.time));             position += sizeof(record.time);
+    std::memcpy(&record.duration, position, sizeof(record.duration));     position += sizeof(record.duration);
+    std::memcpy(&record.errorCode, position, sizeof(record.errorCode));   position += sizeof(record.errorCode);
+    std::memcpy(&record.address, position, sizeof(record.address));       position += sizeof(record.address);
+    std::memcpy(&record.bus, position, sizeof(record.bus));               position += sizeof(record.bus);
+    std::memcpy(&record.call, position, sizeof(record.call));             position += sizeof(record.call);
+    std::memcpy(&record.result, position, sizeof(record.result));         position += sizeof(record.result);
+    std::memcpy(&inputSize, position, sizeof(inputSize));                 position += sizeof(inputSize);
+    std::memcpy(&outputSize, position, sizeof(outputSize));
+    record.inputs.resize(inputSize);
+    record.outputs.resize(outputSize);
+    if ((inputSize > 0) && (std::fread(record.inputs.data(), inputSize, 1, mFile) != 1)) {
+        return false;
+    }
+    if ((outputSize > 0) && (std::fread(record.outputs.data(), outputSize, 1, mFile) != 1)) {
+        return false;
+    }
+    return true;
+}
+
+bool mtsMaxonEPOSDriverReplay::Next(Call call, uint16_t bus, unsigned short address,
+                                    const std::vector<uint8_t> & inputs, RecordData & record)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    const uint64_t key = Key(call, bus, address);
+    std::deque<RecordData> & queue = mPending[key];
+    const bool matchInputs = (call == CALL_OPEN_DEVICE);
+
+    bool found = false;
+    for (std::deque<RecordData>::iterator pending = queue.begin(); pending != queue.end(); ++pending) {
+        if (!matchInputs || (pending->inputs == inputs)) {
+            record = *pending;
+            queue.erase(pending);
+            found = true;
+            break;
+        }
+    }
+    // read ahead, keeping the records of other keys for later
+    RecordData next;
+    while (!found && ReadRecord(next)) {
+        if ((Key(next.call, next.bus, next.address) == key)
+            && (!matchInputs || (next.inputs == inputs))) {
+            record = next;
+            found = true;
+        } else {
+            mPending[Key(next.call, next.bus, next.address)].push_back(next);
+        }
+    }
+    // no device with the same parameters, use the next one opened
+    if (!found && !queue.empty()) {
+        record = queue.front();
+        queue.pop_front();
+        found = true;
+    }
+    if (found && !mStarted) {
+        mStarted = true;
+        mFirstRecordTime = record.time;
+        mStart = std::chrono::steady_clock::now();
+    }
+    return found;
+}
+
+void mtsMaxonEPOSDriverReplay::Wait(double recordTime)
+{
+    if (mSpeed <= 0.0) {
+        return;
+    }
+    const std::chrono::duration<double> offset((recordTime - mFirstRecordTime) / mSpeed);
+    std::this_thread::sleep_until(mStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset));
+}
+
+void * mtsMaxonEPOSDriverReplay::NewHandle(uint16_t bus)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mHandles.emplace_back(new Handle);
+    mHandles.back()->bus = bus;
+    return mHandles.back().get();
+}
+
+uint16_t mtsMaxonEPOSDriverReplay::Bus(void * handle)
+{
+    if (!handle) {
+        return 0;
+    }
+    return static_cast<Handle *>(handle)->bus;
+}
+
+void * mtsMaxonEPOSDriverReplay::OpenDevice(const std::string & deviceName, const std::string & protocolStackName,
+                                           const std::string & interfaceName, const std::string & portName,
+                                           unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_OPEN_DEVICE, nullptr, 0);
+    replay.Input(deviceName);
+    replay.Input(protocolStackName);
+    replay.Input(interfaceName);
+    replay.Input(portName);
+    if (!replay.Result(errorCode)) {
+        return nullptr;
+    }
+    return NewHandle(replay.Bus());
+}
+
+void * mtsMaxonEPOSDriverReplay::OpenSubDevice(void * deviceHandle, const std::string & deviceName,
+                                              const std::string & protocolStackName, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_OPEN_SUB_DEVICE, deviceHandle, 0);
+    replay.Input(deviceName);
+    replay.Input(protocolStackName);
+    if (!replay.Result(errorCode)) {
+        return nullptr;
+    }
+    return NewHandle(Bus(deviceHandle));
+}
+
+bool mtsMaxonEPOSDriverReplay::CloseSubDevice(void * handle, unsigned int & errorCode)
+{
+    // handles are kept until the driver is deleted
+    Replay replay(*this, CALL_CLOSE_SUB_DEVICE, handle, 0);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::CloseDevice(void * handle, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_CLOSE_DEVICE, handle, 0);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::GetProtocolStackSettings(void * handle, unsigned int & baudrate, unsigned int & timeout,
+                                                        unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_GET_PROTOCOL_STACK_SETTINGS, handle, 0);
+    replay.Output(baudrate);
+    replay.Output(timeout);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::SetProtocolStackSettings(void * handle, unsigned int baudrate, unsigned int timeout,
+                                                        unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_SET_PROTOCOL_STACK_SETTINGS, handle, 0);
+    replay.Input(baudrate);
+    replay.Input(timeout);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::SendNMTService(void * handle, unsigned short nodeId, unsigned short commandSpecifier,
+                                              unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_SEND_NMT_SERVICE, handle, nodeId);
+    replay.Input(commandSpecifier);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::ClearFault(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_CLEAR_FAULT, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::GetFaultState(void * handle, unsigned short nodeId, bool & isFault, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_GET_FAULT_STATE, handle, nodeId);
+    replay.Output(isFault);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::GetEnableState(void * handle, unsigned short nodeId, bool & isEnabled, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_GET_ENABLE_STATE, handle, nodeId);
+    replay.Output(isEnabled);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::SetEnableState(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_SET_ENABLE_STATE, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::SetDisableState(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_SET_DISABLE_STATE, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::GetState(void * handle, unsigned short nodeId, unsigned short & state, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_GET_STATE, handle, nodeId);
+    replay.Output(state);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::GetPositionIs(void * handle, unsigned short nodeId, int & position, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_GET_POSITION_IS, handle, nodeId);
+    replay.Output(position);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::GetCurrentIs(void * handle, unsigned short nodeId, short & current, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_GET_CURRENT_IS, handle, nodeId);
+    replay.Output(current);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::ActivateProfilePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_ACTIVATE_PROFILE_POSITION_MODE, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::ActivatePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_ACTIVATE_POSITION_MODE, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::ActivateVelocityMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_ACTIVATE_VELOCITY_MODE, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::ActivateCurrentMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_ACTIVATE_CURRENT_MODE, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::ActivateInterpolatedPositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_ACTIVATE_INTERPOLATED_POSITION_MODE, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::SetPositionProfile(void * handle, unsigned short nodeId, unsigned int profileVelocity,
+                                                  unsigned int profileAcceleration, unsigned int profileDeceleration,
+                                                  unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_SET_POSITION_PROFILE, handle, nodeId);
+    replay.Input(profileVelocity);
+    replay.Input(profileAcceleration);
+    replay.Input(profileDeceleration);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::MoveToPosition(void * handle, unsigned short nodeId, int targetPosition,
+                                              bool absolute, bool immediately, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_MOVE_TO_POSITION, handle, nodeId);
+    replay.Input(targetPosition);
+    replay.Input(absolute);
+    replay.Input(immediately);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::HaltPositionMovement(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_HALT_POSITION_MOVEMENT, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::HaltVelocityMovement(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_HALT_VELOCITY_MOVEMENT, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::SetPositionMust(void * handle, unsigned short nodeId, int position, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_SET_POSITION_MUST, handle, nodeId);
+    replay.Input(position);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::SetVelocityMust(void * handle, unsigned short nodeId, int velocity, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_SET_VELOCITY_MUST, handle, nodeId);
+    replay.Input(velocity);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::SetCurrentMust(void * handle, unsigned short nodeId, short current, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_SET_CURRENT_MUST, handle, nodeId);
+    replay.Input(current);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::SetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short underflowWarningLimit,
+                                                     unsigned short overflowWarningLimit, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_SET_IPM_BUFFER_PARAMETER, handle, nodeId);
+    replay.Input(underflowWarningLimit);
+    replay.Input(overflowWarningLimit);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::GetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short & underflowWarningLimit,
+                                                     unsigned short & overflowWarningLimit, unsigned int & maxBufferSize,
+                                                     unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_GET_IPM_BUFFER_PARAMETER, handle, nodeId);
+    replay.Output(underflowWarningLimit);
+    replay.Output(overflowWarningLimit);
+    replay.Output(maxBufferSize);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::ClearIpmBuffer(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_CLEAR_IPM_BUFFER, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::GetFreeIpmBufferSize(void * handle, unsigned short nodeId, unsigned int & bufferSize,
+                                                    unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_GET_FREE_IPM_BUFFER_SIZE, handle, nodeId);
+    replay.Output(bufferSize);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::AddPvtValueToIpmBuffer(void * handle, unsigned short nodeId, int position, int velocity,
+                                                      unsigned char time, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_ADD_PVT_VALUE_TO_IPM_BUFFER, handle, nodeId);
+    replay.Input(position);
+    replay.Input(velocity);
+    replay.Input(time);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::StartIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_START_IPM_TRAJECTORY, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::StopIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_STOP_IPM_TRAJECTORY, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::GetIpmStatus(void * handle, unsigned short nodeId, IpmStatus & status, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_GET_IPM_STATUS, handle, nodeId);
+    replay.Output(status.trajectoryRunning);
+    replay.Output(status.underflowWarning);
+    replay.Output(status.overflowWarning);
+    replay.Output(status.velocityWarning);
+    replay.Output(status.accelerationWarning);
+    replay.Output(status.underflowError);
+    replay.Output(status.overflowError);
+    replay.Output(status.velocityError);
+    replay.Output(status.accelerationError);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::GetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                                         void * data, unsigned int numberOfBytesToRead, unsigned int & numberOfBytesRead,
+                                         unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_GET_OBJECT, handle, nodeId);
+    replay.Input(objectIndex);
+    replay.Input(objectSubIndex);
+    replay.Input(numberOfBytesToRead);
+    numberOfBytesRead = static_cast<unsigned int>(replay.OutputBuffer(data, numberOfBytesToRead));
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::SetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                                         const void * data, unsigned int numberOfBytesToWrite, unsigned int & numberOfBytesWritten,
+                                         unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_SET_OBJECT, handle, nodeId);
+    replay.Input(objectIndex);
+    replay.Input(objectSubIndex);
+    replay.InputBuffer(data, numberOfBytesToWrite);
+    replay.Output(numberOfBytesWritten);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::SetRecorderParameter(void * handle, unsigned short nodeId, unsigned short samplingPeriod,
+                                                    unsigned short numberOfPrecedingSamples, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_SET_RECORDER_PARAMETER, handle, nodeId);
+    replay.Input(samplingPeriod);
+    replay.Input(numberOfPrecedingSamples);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::EnableTrigger(void * handle, unsigned short nodeId, unsigned char triggerType, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_ENABLE_TRIGGER, handle, nodeId);
+    replay.Input(triggerType);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::DisableAllTriggers(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_DISABLE_ALL_TRIGGERS, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::ActivateChannel(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                                               unsigned short objectIndex, unsigned char objectSubIndex, unsigned char objectSize,
+                                               unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_ACTIVATE_CHANNEL, handle, nodeId);
+    replay.Input(channelNumber);
+    replay.Input(objectIndex);
+    replay.Input(objectSubIndex);
+    replay.Input(objectSize);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::DeactivateAllChannels(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_DEACTIVATE_ALL_CHANNELS, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::StartRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_START_RECORDER, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::StopRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_STOP_RECORDER, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::ForceTrigger(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_FORCE_TRIGGER, handle, nodeId);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::IsRecorderRunning(void * handle, unsigned short nodeId, bool & isRunning, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_IS_RECORDER_RUNNING, handle, nodeId);
+    replay.Output(isRunning);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::ReadChannelVectorSize(void * handle, unsigned short nodeId, unsigned int & vectorSize,
+                                                     unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_READ_CHANNEL_VECTOR_SIZE, handle, nodeId);
+    replay.Output(vectorSize);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::ReadChannelDataVector(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                                                     void * data, unsigned int bufferSize, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_READ_CHANNEL_DATA_VECTOR, handle, nodeId);
+    replay.Input(channelNumber);
+    replay.Input(bufferSize);
+    replay.OutputBuffer(data, bufferSize);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::ReadCANFrame(void * handle, unsigned short cobId, unsigned short length, void * data,
+                                            unsigned int timeout, unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_READ_CAN_FRAME, handle, cobId);
+    replay.Input(length);
+    replay.Input(timeout);
+    replay.OutputBuffer(data, length);
+    return replay.Result(errorCode);
+}
+
+bool mtsMaxonEPOSDriverReplay::SendCANFrame(void * handle, unsigned short cobId, unsigned short length, const void * data,
+                                            unsigned int & errorCode)
+{
+    Replay replay(*this, CALL_SEND_CAN_FRAME, handle, cobId);
+    replay.InputBuffer(data, length);
+    return replay.Result(errorCode);
+}
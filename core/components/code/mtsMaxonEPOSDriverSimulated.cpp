@@ -0,0 +1,1429 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+  (C) Copyright 2024-2025 Johns Hopkins University (JHU)
+
+--- begin cisst license - do not edit ---
+This software is provided "as is" under an open source license, with no warranty.
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include <cisstCommon/cmnConstants.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSDriverSimulated.h>
+
+namespace {
+    const unsigned int HANDLE_MAGIC = 0x45504F53;  // "EPOS"
+    // Integration step for the motor dynamics
+    const double MAX_STEP = 0.001;
+    // Data recorder sampling period unit
+    const double RECORDER_TIME_BASE = 0.0001;
+    // Below this, busy wait instead of sleeping to keep the latency accurate
+    const double SPIN_THRESHOLD = 0.0002;
+}
+
+mtsMaxonEPOSDriverSimulated::mtsMaxonEPOSDriverSimulated() :
+    mLatency(0.0),
+    mCountsPerTurn(2048.0),
+    mBandwidth(50.0),
+    mMaxVelocity(10000.0),
+    mMaxFollowingError(0.0),
+    mCurrentPerAcceleration(0.001),
+    mCurrentPerVelocity(0.01),
+    mBootTime(0.0)
+{}
+
+mtsMaxonEPOSDriverSimulated::~mtsMaxonEPOSDriverSimulated()
+{}
+
+bool mtsMaxonEPOSDriverSimulated::Configure(const Json::Value & jsonConfig)
+{
+    const Json::Value & sim = jsonConfig["simulated"];
+    if (sim.isNull()) {
+        return true;
+    }
+    if (!sim.isObject()) {
+        return false;
+    }
+    mLatency = sim.get("latency", mLatency).asDouble();
+    mCountsPerTurn = sim.get("counts_per_turn", mCountsPerTurn).asDouble();
+    mBandwidth = sim.get("bandwidth", mBandwidth).asDouble();
+    mMaxVelocity = sim.get("max_velocity", mMaxVelocity).asDouble();
+    mMaxFollowingError = sim.get("max_following_error", mMaxFollowingError).asDouble();
+    mCurrentPerAcceleration = sim.get("current_per_acceleration", mCurrentPerAcceleration).asDouble();
+    mCurrentPerVelocity = sim.get("current_per_velocity", mCurrentPerVelocity).asDouble();
+    mBootTime = sim.get("boot_time", mBootTime).asDouble();
+    return (mLatency >= 0.0) && (mCountsPerTurn > 0.0) && (mBandwidth > 0.0) && (mBootTime >= 0.0);
+}
+
+void mtsMaxonEPOSDriverSimulated::SetFaultHook(const FaultHook & hook)
+{
+    mFaultHook = hook;
+}
+
+void mtsMaxonEPOSDriverSimulated::InjectFault(void * handle, unsigned short nodeId, unsigned int deviceErrorCode)
+{
+    Handle * h = static_cast<Handle *>(handle);
+    if (!h || (h->magic != HANDLE_MAGIC) || (nodeId == 0) || (nodeId >= MAX_NODES)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(h->bus->mutex);
+    Node & node = h->bus->nodes[nodeId];
+    Update(node, Now());
+    node.state = NODE_FAULT;
+    node.deviceError = deviceErrorCode;
+}
+
+double mtsMaxonEPOSDriverSimulated::Now(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void mtsMaxonEPOSDriverSimulated::Wait(double duration) const
+{
+    if (duration <= 0.0) {
+        return;
+    }
+    const double end = Now() + duration;
+    if (duration > SPIN_THRESHOLD) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(duration - SPIN_THRESHOLD));
+    }
+    while (Now() < end) {}
+}
+
+void mtsMaxonEPOSDriverSimulated::ResetNode(Node & node, double now) const
+{
+    node.state = NODE_DISABLED;
+    node.mode = MODE_PROFILE_POSITION;
+    node.velocity = 0.0;
+    node.acceleration = 0.0;
+    node.current = 0.0;
+    node.targetPosition = node.position;
+    node.targetVelocity = 0.0;
+    node.targetCurrent = 0.0;
+    node.moving = false;
+    node.deviceError = 0;
+    node.lastUpdate = now;
+    node.operational = false;
+    node.bootEnd = now;
+    node.objects.clear();
+    node.rxPDOPending = -1;
+    node.ipmUnderflowWarningLimit = 0;
+    node.ipmOverflowWarningLimit = IPM_BUFFER_SIZE;
+    ClearIpm(node);
+    ClearRecorder(node);
+}
+
+void mtsMaxonEPOSDriverSimulated::ClearIpm(Node & node) const
+{
+    node.ipmBuffer.clear();
+    node.ipmTime = 0.0;
+    node.ipmRunning = false;
+    node.ipmUnderflowError = false;
+    node.ipmOverflowError = false;
+}
+
+void mtsMaxonEPOSDriverSimulated::ClearRecorder(Node & node) const
+{
+    for (size_t channel = 0; channel < RECORDER_CHANNELS; ++channel) {
+        node.recorderChannels[channel].size = 0;
+    }
+    node.recorderPeriod = 1;
+    node.recorderPreceding = 0;
+    node.recorderTriggers = 0;
+    node.recorderRunning = false;
+    node.recorderTriggered = false;
+    node.recorderMoving = false;
+    node.recorderTime = 0.0;
+    node.recorderSamples.clear();
+}
+
+void mtsMaxonEPOSDriverSimulated::SampleRecorder(Node & node, double dt) const
+{
+    if (!node.recorderTriggered
+        && (((node.recorderTriggers & TRIGGER_MOVEMENT_START) && node.moving && !node.recorderMoving)
+            || ((node.recorderTriggers & TRIGGER_MOVEMENT_END) && !node.moving && node.recorderMoving)
+            || ((node.recorderTriggers & TRIGGER_ERROR) && (node.state == NODE_FAULT)))) {
+        node.recorderTriggered = true;
+    }
+    node.recorderMoving = node.moving;
+    node.recorderTime += dt;
+    const double period = RECORDER_TIME_BASE * node.recorderPeriod;
+    while (node.recorderRunning && (node.recorderTime >= period)) {
+        node.recorderTime -= period;
+        for (size_t channel = 0; channel < RECORDER_CHANNELS; ++channel) {
+            const RecorderChannel & recorderChannel = node.recorderChannels[channel];
+            unsigned int value = 0, size, errorCode;
+            if (recorderChannel.size > 0) {
+                ReadObject(node, 0, recorderChannel.index, recorderChannel.subIndex, value, size, errorCode);
+            }
+            node.recorderSamples.push_back(value);
+        }
+        if (!node.recorderTriggered) {
+            // only keep the preceding samples until the trigger
+            while (node.recorderSamples.size() > node.recorderPreceding * RECORDER_CHANNELS) {
+                node.recorderSamples.erase(node.recorderSamples.begin(),
+                                           node.recorderSamples.begin() + RECORDER_CHANNELS);
+            }
+        } else if (node.recorderSamples.size() >= RECORDER_SAMPLES * RECORDER_CHANNELS) {
+            node.recorderRunning = false;
+        }
+    }
+}
+
+double mtsMaxonEPOSDriverSimulated::InterpolateIpm(Node & node, double dt) const
+{
+    if (!node.ipmRunning) {
+        return node.targetPosition;
+    }
+    node.ipmTime += dt;
+    while (node.ipmTime >= node.ipmSegment.time) {
+        if (node.ipmSegment.time <= 0.0) {
+            // last point reached
+            node.ipmRunning = false;
+            return node.ipmSegment.position;
+        }
+        if (node.ipmBuffer.empty()) {
+            // no point to end the segment, stop at last position
+            node.ipmRunning = false;
+            node.ipmUnderflowError = true;
+            return node.targetPosition;
+        }
+        node.ipmTime -= node.ipmSegment.time;
+        node.ipmSegment = node.ipmBuffer.front();
+        node.ipmBuffer.pop_front();
+    }
+    if (node.ipmBuffer.empty()) {
+        return node.ipmSegment.position;
+    }
+    // cubic Hermite between the segment start and the next point
+    const PvtPoint & p0 = node.ipmSegment;
+    const PvtPoint & p1 = node.ipmBuffer.front();
+    const double T = p0.time;
+    const double s = node.ipmTime / T;
+    const double s2 = s * s;
+    const double s3 = s2 * s;
+    return (2.0 * s3 - 3.0 * s2 + 1.0) * p0.position + (s3 - 2.0 * s2 + s) * T * p0.velocity
+        + (-2.0 * s3 + 3.0 * s2) * p1.position + (s3 - s2) * T * p1.velocity;
+}
+
+void mtsMaxonEPOSDriverSimulated::ApplyNMT(Bus & bus, unsigned short nodeId, unsigned short commandSpecifier) const
+{
+    const double now = Now();
+    for (size_t i = 1; i < MAX_NODES; i++) {
+        if ((nodeId != 0) && (nodeId != i)) {
+            continue;
+        }
+        Node & node = bus.nodes[i];
+        Update(node, now);
+        switch (commandSpecifier) {
+        case 1:     // start remote node
+            node.operational = true;
+            break;
+        case 2:     // stop remote node
+        case 128:   // enter pre-operational
+            node.operational = false;
+            break;
+        case 129:   // reset node
+        case 130:   // reset communication
+            ResetNode(node, now);
+            node.bootEnd = now + mBootTime;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+unsigned short mtsMaxonEPOSDriverSimulated::Statusword(const Node & node)
+{
+    switch (node.state) {
+    case NODE_ENABLED:
+        return 0x0037;   // operation enabled
+    case NODE_QUICKSTOP:
+        return 0x0017;   // quick stop active
+    case NODE_FAULT:
+        return 0x0008;   // fault
+    default:
+        return 0x0040;   // switch on disabled
+    }
+}
+
+short mtsMaxonEPOSDriverSimulated::CurrentValue(const Node & node)
+{
+    double value = node.current;
+    if (value > 32767.0) {
+        value = 32767.0;
+    } else if (value < -32768.0) {
+        value = -32768.0;
+    }
+    return static_cast<short>(value);
+}
+
+bool mtsMaxonEPOSDriverSimulated::ReadObject(const Node & node, unsigned short nodeId, unsigned short index, unsigned char subIndex,
+                                             unsigned int & value, unsigned int & size, unsigned int & errorCode) const
+{
+    if (subIndex == 0) {
+        switch (index) {
+        case 0x6041:   // statusword
+            value = Statusword(node);
+            size = 2;
+            return true;
+        case 0x6064:   // position actual value
+            value = static_cast<unsigned int>(static_cast<int>(std::lround(node.position)));
+            size = 4;
+            return true;
+        case 0x606C:   // velocity actual value (rpm)
+            value = static_cast<unsigned int>(static_cast<int>(std::lround(node.velocity * 60.0 / mCountsPerTurn)));
+            size = 4;
+            return true;
+        case 0x6078:   // current actual value (mA)
+            value = static_cast<unsigned short>(CurrentValue(node));
+            size = 2;
+            return true;
+        case 0x6081:
+            value = node.profileVelocity;
+            size = 4;
+            return true;
+        case 0x6083:
+            value = node.profileAcceleration;
+            size = 4;
+            return true;
+        case 0x6084:
+            value = node.profileDeceleration;
+            size = 4;
+            return true;
+        default:
+            break;
+        }
+    }
+    if ((index == 0x1018) && (subIndex == 4)) {
+        // serial number, unique per simulated node
+        value = 0x53494D00 + nodeId;
+        size = 4;
+        return true;
+    }
+    std::map<unsigned int, std::pair<unsigned int, unsigned int> >::const_iterator it =
+        node.objects.find((static_cast<unsigned int>(index) << 8) | subIndex);
+    if (it == node.objects.end()) {
+        // static parameters, until written
+        if (subIndex == 0) {
+            switch (index) {
+            case 0x6065:   // max following error
+                value = static_cast<unsigned int>(mMaxFollowingError);
+                size = 4;
+                return true;
+            case 0x607F:   // max profile velocity (rpm)
+                value = static_cast<unsigned int>(mMaxVelocity);
+                size = 4;
+                return true;
+            case 0x6402:   // motor type, sinusoidal PM BL motor
+                value = 11;
+                size = 2;
+                return true;
+            default:
+                break;
+            }
+        }
+        errorCode = ERROR_OBJECT_NOT_FOUND;
+        return false;
+    }
+    value = it->second.first;
+    size = it->second.second;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::WriteObject(Node & node, unsigned short index, unsigned char subIndex,
+                                              unsigned int value, unsigned int size, unsigned int & errorCode) const
+{
+    if (subIndex == 0) {
+        switch (index) {
+        case 0x6041:
+        case 0x6064:
+        case 0x606C:
+        case 0x6078:
+            errorCode = ERROR_READ_ONLY;
+            return false;
+        case 0x6081:
+            node.profileVelocity = value;
+            return true;
+        case 0x6083:
+            node.profileAcceleration = value;
+            return true;
+        case 0x6084:
+            node.profileDeceleration = value;
+            return true;
+        case 0x6040: {
+            // controlword, a rising edge of new setpoint (bit 4) starts a
+            // profile position move to the target position (0x607A),
+            // relative if bit 6 is set
+            std::map<unsigned int, std::pair<unsigned int, unsigned int> >::const_iterator it =
+                node.objects.find(0x604000);
+            const unsigned int previous = (it == node.objects.end()) ? 0 : it->second.first;
+            if ((value & 0x0010) && !(previous & 0x0010) && (node.mode == MODE_PROFILE_POSITION)) {
+                it = node.objects.find(0x607A00);
+                const double target = (it == node.objects.end()) ? 0.0 : static_cast<int>(it->second.first);
+                node.targetPosition = (value & 0x0040) ? node.targetPosition + target : target;
+                node.moving = (node.state == NODE_ENABLED);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    if (index == 0x1018) {
+        errorCode = ERROR_READ_ONLY;
+        return false;
+    }
+    node.objects[(static_cast<unsigned int>(index) << 8) | subIndex] = std::make_pair(value, size);
+    return true;
+}
+
+void mtsMaxonEPOSDriverSimulated::ApplyRxPDO(Node & node, unsigned short nodeId, unsigned short pdo,
+                                             const unsigned char * data) const
+{
+    unsigned int numberOfEntries, size, error;
+    if (!ReadObject(node, nodeId, 0x1600 + pdo, 0, numberOfEntries, size, error)) {
+        return;
+    }
+    unsigned int offset = 0;
+    for (unsigned int entry = 1; entry <= numberOfEntries; entry++) {
+        unsigned int mapping;
+        if (!ReadObject(node, nodeId, 0x1600 + pdo, static_cast<unsigned char>(entry), mapping, size, error)) {
+            return;
+        }
+        const unsigned int bytes = (mapping & 0xFF) / 8;
+        if ((bytes == 0) || (offset + bytes > 8)) {
+            return;
+        }
+        unsigned int value = 0;
+        for (unsigned int i = 0; i < bytes; i++) {
+            value |= static_cast<unsigned int>(data[offset++]) << (8 * i);
+        }
+        WriteObject(node, static_cast<unsigned short>(mapping >> 16), static_cast<unsigned char>((mapping >> 8) & 0xFF),
+                    value, bytes, error);
+    }
+}
+
+void mtsMaxonEPOSDriverSimulated::Update(Node & node, double now) const
+{
+    const double total = now - node.lastUpdate;
+    node.lastUpdate = now;
+    if (total <= 0.0) {
+        return;
+    }
+    if (node.state != NODE_ENABLED) {
+        node.velocity = 0.0;
+        node.acceleration = 0.0;
+        node.current = 0.0;
+        node.moving = false;
+        node.ipmRunning = false;
+        if (node.recorderRunning) {
+            SampleRecorder(node, total);
+        }
+        return;
+    }
+
+    const double omega = 2.0 * cmnPI * mBandwidth;
+    const double maxVelocity = RpmToCounts(mMaxVelocity);
+    const double previousVelocity = node.velocity;
+    double elapsed = total;
+    // smaller steps while recording, to sample at the recorder rate
+    const double step = node.recorderRunning ? std::min(MAX_STEP, RECORDER_TIME_BASE * node.recorderPeriod) : MAX_STEP;
+    while (elapsed > 0.0) {
+        const double dt = (elapsed > step) ? step : elapsed;
+        elapsed -= dt;
+        if (node.recorderRunning) {
+            SampleRecorder(node, dt);
+        }
+        switch (node.mode) {
+        case MODE_POSITION:
+            node.velocity = (node.targetPosition - node.position) * (1.0 - std::exp(-omega * dt)) / dt;
+            break;
+        case MODE_VELOCITY:
+            node.velocity += (node.targetVelocity - node.velocity) * (1.0 - std::exp(-omega * dt));
+            break;
+        case MODE_CURRENT:
+            // current model solved for the velocity: first order response to
+            // current / current_per_velocity, time constant
+            // current_per_acceleration / current_per_velocity
+            if (mCurrentPerAcceleration > 0.0) {
+                if (mCurrentPerVelocity > 0.0) {
+                    const double steadyVelocity = RpmToCounts(node.targetCurrent / mCurrentPerVelocity);
+                    node.velocity += (steadyVelocity - node.velocity)
+                        * (1.0 - std::exp(-dt * mCurrentPerVelocity / mCurrentPerAcceleration));
+                } else {
+                    node.velocity += RpmToCounts(node.targetCurrent / mCurrentPerAcceleration) * dt;
+                }
+            }
+            break;
+        case MODE_INTERPOLATED_POSITION:
+            node.targetPosition = InterpolateIpm(node, dt);
+            node.velocity = (node.targetPosition - node.position) * (1.0 - std::exp(-omega * dt)) / dt;
+            break;
+        case MODE_PROFILE_POSITION:
+            if (node.moving) {
+                const double error = node.targetPosition - node.position;
+                const double direction = (error >= 0.0) ? 1.0 : -1.0;
+                const double vmax = RpmToCounts(node.profileVelocity);
+                const double acc = RpmToCounts(node.profileAcceleration);
+                const double dec = RpmToCounts(node.profileDeceleration);
+                double speed = node.velocity * direction;
+                if (speed < 0.0) {
+                    // moving away from target, brake first
+                    speed += dec * dt;
+                    if (speed > 0.0) {
+                        speed = 0.0;
+                    }
+                } else if (speed * speed > 2.0 * dec * std::fabs(error)) {
+                    // within braking distance
+                    speed -= dec * dt;
+                    if (speed < 0.0) {
+                        speed = 0.0;
+                    }
+                } else {
+                    speed += acc * dt;
+                    if (speed > vmax) {
+                        speed = vmax;
+                    }
+                }
+                if ((speed >= 0.0) && (speed * dt >= std::fabs(error))) {
+                    node.position = node.targetPosition;
+                    node.velocity = 0.0;
+                    node.moving = false;
+                    continue;
+                }
+                node.velocity = speed * direction;
+            } else {
+                node.velocity = 0.0;
+            }
+            break;
+        }
+        if (node.velocity > maxVelocity) {
+            node.velocity = maxVelocity;
+        } else if (node.velocity < -maxVelocity) {
+            node.velocity = -maxVelocity;
+        }
+        node.position += node.velocity * dt;
+    }
+
+    node.acceleration = (node.velocity - previousVelocity) / total;
+    const double countsToRpm = 60.0 / mCountsPerTurn;
+    if (node.mode == MODE_CURRENT) {
+        // ideal current loop
+        node.current = node.targetCurrent;
+    } else {
+        node.current = mCurrentPerAcceleration * node.acceleration * countsToRpm
+            + mCurrentPerVelocity * node.velocity * countsToRpm;
+    }
+
+    if ((mMaxFollowingError > 0.0) && ((node.mode == MODE_POSITION) || (node.mode == MODE_INTERPOLATED_POSITION))
+        && (std::fabs(node.targetPosition - node.position) > mMaxFollowingError)) {
+        node.state = NODE_FAULT;
+        node.deviceError = ERROR_FOLLOWING;
+        node.velocity = 0.0;
+        node.current = 0.0;
+    }
+}
+
+mtsMaxonEPOSDriverSimulated::Bus * mtsMaxonEPOSDriverSimulated::BeginCall(const char * call, void * handle, unsigned short nodeId,
+                                                                          std::unique_lock<std::mutex> & lock,
+                                                                          unsigned int & errorCode)
+{
+    errorCode = 0;
+    Handle * h = static_cast<Handle *>(handle);
+    if (!h || (h->magic != HANDLE_MAGIC) || !h->isOpen) {
+        errorCode = ERROR_HANDLE_NOT_VALID;
+        return nullptr;
+    }
+    if (nodeId >= MAX_NODES) {
+        errorCode = ERROR_BAD_PARAMETER;
+        return nullptr;
+    }
+    lock = std::unique_lock<std::mutex>(h->bus->mutex);
+    Wait(mLatency);
+    if (mFaultHook) {
+        errorCode = mFaultHook(call, nodeId);
+        if (errorCode != 0) {
+            return nullptr;
+        }
+    }
+    return h->bus.get();
+}
+
+mtsMaxonEPOSDriverSimulated::Node * mtsMaxonEPOSDriverSimulated::BeginNodeCall(const char * call, void * handle, unsigned short nodeId,
+                                                                               std::unique_lock<std::mutex> & lock,
+                                                                               unsigned int & errorCode)
+{
+    if (nodeId == 0) {
+        errorCode = ERROR_BAD_PARAMETER;
+        return nullptr;
+    }
+    Bus * bus = BeginCall(call, handle, nodeId, lock, errorCode);
+    if (!bus) {
+        return nullptr;
+    }
+    Node & node = bus->nodes[nodeId];
+    const double now = Now();
+    // No answer while booting, as an SDO timeout
+    if (now < node.bootEnd) {
+        errorCode = ERROR_TIMEOUT;
+        return nullptr;
+    }
+    Update(node, now);
+    return &node;
+}
+
+void * mtsMaxonEPOSDriverSimulated::OpenDevice(const std::string & CMN_UNUSED(deviceName),
+                                              const std::string & CMN_UNUSED(protocolStackName),
+                                              const std::string & CMN_UNUSED(interfaceName),
+                                              const std::string & CMN_UNUSED(portName),
+                                              unsigned int & errorCode)
+{
+    errorCode = 0;
+    std::unique_ptr<Handle> handle(new Handle);
+    handle->magic = HANDLE_MAGIC;
+    handle->bus = std::make_shared<Bus>();
+    handle->bus->nodes.resize(MAX_NODES);
+    handle->bus->baudrate = 1000000;
+    handle->bus->timeout = 500;
+    const double now = Now();
+    for (size_t i = 0; i < MAX_NODES; i++) {
+        Node & node = handle->bus->nodes[i];
+        node.position = 0.0;
+        node.profileVelocity = 1000;
+        node.profileAcceleration = 10000;
+        node.profileDeceleration = 10000;
+        ResetNode(node, now);
+    }
+    handle->isGateway = true;
+    handle->isOpen = true;
+    std::lock_guard<std::mutex> lock(mHandlesMutex);
+    mHandles.push_back(std::move(handle));
+    return mHandles.back().get();
+}
+
+void * mtsMaxonEPOSDriverSimulated::OpenSubDevice(void * deviceHandle, const std::string & CMN_UNUSED(deviceName),
+                                                 const std::string & CMN_UNUSED(protocolStackName),
+                                                 unsigned int & errorCode)
+{
+    errorCode = 0;
+    Handle * gateway = static_cast<Handle *>(deviceHandle);
+    if (!gateway || (gateway->magic != HANDLE_MAGIC) || !gateway->isOpen || !gateway->isGateway) {
+        errorCode = ERROR_HANDLE_NOT_VALID;
+        return nullptr;
+    }
+    std::unique_ptr<Handle> handle(new Handle);
+    handle->magic = HANDLE_MAGIC;
+    handle->bus = gateway->bus;
+    handle->isGateway = false;
+    handle->isOpen = true;
+    std::lock_guard<std::mutex> lock(mHandlesMutex);
+    mHandles.push_back(std::move(handle));
+    return mHandles.back().get();
+}
+
+bool mtsMaxonEPOSDriverSimulated::CloseSubDevice(void * handle, unsigned int & errorCode)
+{
+    errorCode = 0;
+    Handle * h = static_cast<Handle *>(handle);
+    if (!h || (h->magic != HANDLE_MAGIC) || !h->isOpen || h->isGateway) {
+        errorCode = ERROR_HANDLE_NOT_VALID;
+        return false;
+    }
+    h->isOpen = false;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::CloseDevice(void * handle, unsigned int & errorCode)
+{
+    errorCode = 0;
+    Handle * h = static_cast<Handle *>(handle);
+    if (!h || (h->magic != HANDLE_MAGIC) || !h->isOpen || !h->isGateway) {
+        errorCode = ERROR_HANDLE_NOT_VALID;
+        return false;
+    }
+    h->isOpen = false;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::GetProtocolStackSettings(void * handle, unsigned int & baudrate, unsigned int & timeout,
+                                                           unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Bus * bus = BeginCall("GetProtocolStackSettings", handle, 0, lock, errorCode);
+    if (!bus) {
+        return false;
+    }
+    baudrate = bus->baudrate;
+    timeout = bus->timeout;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::SetProtocolStackSettings(void * handle, unsigned int baudrate, unsigned int timeout,
+                                                           unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Bus * bus = BeginCall("SetProtocolStackSettings", handle, 0, lock, errorCode);
+    if (!bus) {
+        return false;
+    }
+    bus->baudrate = baudrate;
+    bus->timeout = timeout;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::SendNMTService(void * handle, unsigned short nodeId, unsigned short commandSpecifier,
+                                                 unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Bus * bus = BeginCall("SendNMTService", handle, nodeId, lock, errorCode);
+    if (!bus) {
+        return false;
+    }
+    ApplyNMT(*bus, nodeId, commandSpecifier);
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::ClearFault(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Bus * bus = BeginCall("ClearFault", handle, nodeId, lock, errorCode);
+    if (!bus) {
+        return false;
+    }
+    const double now = Now();
+    for (size_t i = 1; i < MAX_NODES; i++) {
+        if ((nodeId == 0) || (nodeId == i)) {
+            Node & node = bus->nodes[i];
+            Update(node, now);
+            if (node.state == NODE_FAULT) {
+                node.state = NODE_DISABLED;
+                node.deviceError = 0;
+            }
+        }
+    }
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::GetFaultState(void * handle, unsigned short nodeId, bool & isFault, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("GetFaultState", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    isFault = (node->state == NODE_FAULT);
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::GetEnableState(void * handle, unsigned short nodeId, bool & isEnabled, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("GetEnableState", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    isEnabled = (node->state == NODE_ENABLED);
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::SetEnableState(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("SetEnableState", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    if (node->state == NODE_FAULT) {
+        errorCode = ERROR_COMMAND_FAILED;
+        return false;
+    }
+    if (node->state != NODE_ENABLED) {
+        node->state = NODE_ENABLED;
+        node->targetPosition = node->position;
+        node->targetVelocity = 0.0;
+    }
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::SetDisableState(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("SetDisableState", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    if (node->state != NODE_FAULT) {
+        node->state = NODE_DISABLED;
+    }
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::GetState(void * handle, unsigned short nodeId, unsigned short & state, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("GetState", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    state = static_cast<unsigned short>(node->state);
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::GetPositionIs(void * handle, unsigned short nodeId, int & position, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("GetPositionIs", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    position = static_cast<int>(std::lround(node->position));
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::GetCurrentIs(void * handle, unsigned short nodeId, short & current, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("GetCurrentIs", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    current = CurrentValue(*node);
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::ActivateProfilePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("ActivateProfilePositionMode", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    node->mode = MODE_PROFILE_POSITION;
+    node->moving = false;
+    node->targetPosition = node->position;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::ActivatePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("ActivatePositionMode", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    node->mode = MODE_POSITION;
+    node->targetPosition = node->position;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::ActivateVelocityMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("ActivateVelocityMode", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    node->mode = MODE_VELOCITY;
+    node->targetVelocity = 0.0;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::ActivateCurrentMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("ActivateCurrentMode", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    node->mode = MODE_CURRENT;
+    node->targetCurrent = 0.0;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::ActivateInterpolatedPositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("ActivateInterpolatedPositionMode", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    node->mode = MODE_INTERPOLATED_POSITION;
+    node->targetPosition = node->position;
+    ClearIpm(*node);
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::SetPositionProfile(void * handle, unsigned short nodeId, unsigned int profileVelocity,
+                                                     unsigned int profileAcceleration, unsigned int profileDeceleration,
+                                                     unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("SetPositionProfile", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    if ((profileVelocity == 0) || (profileAcceleration == 0) || (profileDeceleration == 0)) {
+        errorCode = ERROR_BAD_PARAMETER;
+        return false;
+    }
+    node->profileVelocity = profileVelocity;
+    node->profileAcceleration = profileAcceleration;
+    node->profileDeceleration = profileDeceleration;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::MoveToPosition(void * handle, unsigned short nodeId, int targetPosition,
+                                                 bool absolute, bool CMN_UNUSED(immediately), unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("MoveToPosition", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    if (node->mode != MODE_PROFILE_POSITION) {
+        errorCode = ERROR_COMMAND_FAILED;
+        return false;
+    }
+    node->targetPosition = absolute ? targetPosition : node->targetPosition + targetPosition;
+    node->moving = (node->state == NODE_ENABLED);
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::HaltPositionMovement(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("HaltPositionMovement", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    if (node->mode == MODE_PROFILE_POSITION) {
+        // stop with the profile deceleration
+        const double dec = RpmToCounts(node->profileDeceleration);
+        const double direction = (node->velocity >= 0.0) ? 1.0 : -1.0;
+        node->targetPosition = node->position + direction * node->velocity * node->velocity / (2.0 * dec);
+    }
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::HaltVelocityMovement(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("HaltVelocityMovement", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    node->targetVelocity = 0.0;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::SetPositionMust(void * handle, unsigned short nodeId, int position, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("SetPositionMust", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    if (node->mode != MODE_POSITION) {
+        errorCode = ERROR_COMMAND_FAILED;
+        return false;
+    }
+    node->targetPosition = position;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::SetVelocityMust(void * handle, unsigned short nodeId, int velocity, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("SetVelocityMust", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    if (node->mode != MODE_VELOCITY) {
+        errorCode = ERROR_COMMAND_FAILED;
+        return false;
+    }
+    node->targetVelocity = RpmToCounts(velocity);
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::SetCurrentMust(void * handle, unsigned short nodeId, short current, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("SetCurrentMust", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    if (node->mode != MODE_CURRENT) {
+        errorCode = ERROR_COMMAND_FAILED;
+        return false;
+    }
+    node->targetCurrent = current;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::SetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short underflowWarningLimit,
+                                                        unsigned short overflowWarningLimit, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("SetIpmBufferParameter", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    if ((underflowWarningLimit > IPM_BUFFER_SIZE) || (overflowWarningLimit > IPM_BUFFER_SIZE)) {
+        errorCode = ERROR_BAD_PARAMETER;
+        return false;
+    }
+    node->ipmUnderflowWarningLimit = underflowWarningLimit;
+    node->ipmOverflowWarningLimit = overflowWarningLimit;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::GetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short & underflowWarningLimit,
+                                                        unsigned short & overflowWarningLimit, unsigned int & maxBufferSize,
+                                                        unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("GetIpmBufferParameter", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    underflowWarningLimit = node->ipmUnderflowWarningLimit;
+    overflowWarningLimit = node->ipmOverflowWarningLimit;
+    maxBufferSize = IPM_BUFFER_SIZE;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::ClearIpmBuffer(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("ClearIpmBuffer", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    ClearIpm(*node);
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::GetFreeIpmBufferSize(void * handle, unsigned short nodeId, unsigned int & bufferSize,
+                                                       unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("GetFreeIpmBufferSize", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    bufferSize = static_cast<unsigned int>(IPM_BUFFER_SIZE - node->ipmBuffer.size());
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::AddPvtValueToIpmBuffer(void * handle, unsigned short nodeId, int position, int velocity,
+                                                         unsigned char time, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("AddPvtValueToIpmBuffer", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    if (node->mode != MODE_INTERPOLATED_POSITION) {
+        errorCode = ERROR_COMMAND_FAILED;
+        return false;
+    }
+    if (node->ipmBuffer.size() >= IPM_BUFFER_SIZE) {
+        node->ipmOverflowError = true;
+        errorCode = ERROR_COMMAND_FAILED;
+        return false;
+    }
+    PvtPoint point;
+    point.position = position;
+    point.velocity = RpmToCounts(velocity);
+    point.time = time * 0.001;
+    node->ipmBuffer.push_back(point);
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::StartIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("StartIpmTrajectory", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    if ((node->mode != MODE_INTERPOLATED_POSITION) || (node->state != NODE_ENABLED)
+        || node->ipmBuffer.empty() || node->ipmUnderflowError || node->ipmOverflowError) {
+        errorCode = ERROR_COMMAND_FAILED;
+        return false;
+    }
+    if (!node->ipmRunning) {
+        node->ipmSegment = node->ipmBuffer.front();
+        node->ipmBuffer.pop_front();
+        node->ipmTime = 0.0;
+        node->ipmRunning = true;
+    }
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::StopIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("StopIpmTrajectory", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    // hold the last interpolated position
+    node->ipmRunning = false;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::GetIpmStatus(void * handle, unsigned short nodeId, IpmStatus & status, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("GetIpmStatus", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    status.trajectoryRunning = node->ipmRunning;
+    status.underflowWarning = node->ipmRunning && (node->ipmBuffer.size() < node->ipmUnderflowWarningLimit);
+    status.overflowWarning = (node->ipmBuffer.size() > node->ipmOverflowWarningLimit);
+    status.velocityWarning = false;
+    status.accelerationWarning = false;
+    status.underflowError = node->ipmUnderflowError;
+    status.overflowError = node->ipmOverflowError;
+    status.velocityError = false;
+    status.accelerationError = false;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::GetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                                            void * data, unsigned int numberOfBytesToRead, unsigned int & numberOfBytesRead,
+                                            unsigned int & errorCode)
+{
+    numberOfBytesRead = 0;
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("GetObject", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    unsigned int value, size;
+    if (!ReadObject(*node, nodeId, objectIndex, objectSubIndex, value, size, errorCode)) {
+        return false;
+    }
+    // little endian, as on the CAN bus
+    unsigned char * bytes = static_cast<unsigned char *>(data);
+    for (unsigned int i = 0; (i < size) && (i < numberOfBytesToRead); i++) {
+        bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+        numberOfBytesRead++;
+    }
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::SetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                                            const void * data, unsigned int numberOfBytesToWrite, unsigned int & numberOfBytesWritten,
+                                            unsigned int & errorCode)
+{
+    numberOfBytesWritten = 0;
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("SetObject", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    if ((numberOfBytesToWrite == 0) || (numberOfBytesToWrite > 4)) {
+        errorCode = ERROR_BAD_PARAMETER;
+        return false;
+    }
+    const unsigned char * bytes = static_cast<const unsigned char *>(data);
+    unsigned int value = 0;
+    for (unsigned int i = 0; i < numberOfBytesToWrite; i++) {
+        value |= static_cast<unsigned int>(bytes[i]) << (8 * i);
+    }
+    if (!WriteObject(*node, objectIndex, objectSubIndex, value, numberOfBytesToWrite, errorCode)) {
+        return false;
+    }
+    numberOfBytesWritten = numberOfBytesToWrite;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::SetRecorderParameter(void * handle, unsigned short nodeId, unsigned short samplingPeriod,
+                                                       unsigned short numberOfPrecedingSamples, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("SetRecorderParameter", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    if ((samplingPeriod == 0) || (numberOfPrecedingSamples >= RECORDER_SAMPLES)) {
+        errorCode = ERROR_BAD_PARAMETER;
+        return false;
+    }
+    node->recorderPeriod = samplingPeriod;
+    node->recorderPreceding = numberOfPrecedingSamples;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::EnableTrigger(void * handle, unsigned short nodeId, unsigned char triggerType, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("EnableTrigger", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    node->recorderTriggers |= triggerType;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::DisableAllTriggers(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("DisableAllTriggers", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    node->recorderTriggers = 0;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::ActivateChannel(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                                                  unsigned short objectIndex, unsigned char objectSubIndex, unsigned char objectSize,
+                                                  unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("ActivateChannel", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    if ((channelNumber < 1) || (channelNumber > RECORDER_CHANNELS)
+        || ((objectSize != 1) && (objectSize != 2) && (objectSize != 4))) {
+        errorCode = ERROR_BAD_PARAMETER;
+        return false;
+    }
+    // the object has to exist
+    unsigned int value, size;
+    if (!ReadObject(*node, nodeId, objectIndex, objectSubIndex, value, size, errorCode)) {
+        return false;
+    }
+    RecorderChannel & channel = node->recorderChannels[channelNumber - 1];
+    channel.index = objectIndex;
+    channel.subIndex = objectSubIndex;
+    channel.size = objectSize;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::DeactivateAllChannels(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("DeactivateAllChannels", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    for (size_t channel = 0; channel < RECORDER_CHANNELS; ++channel) {
+        node->recorderChannels[channel].size = 0;
+    }
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::StartRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("StartRecorder", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    node->recorderSamples.clear();
+    node->recorderRunning = true;
+    node->recorderTriggered = false;
+    node->recorderMoving = node->moving;
+    node->recorderTime = 0.0;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::StopRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("StopRecorder", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    node->recorderRunning = false;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::ForceTrigger(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("ForceTrigger", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    if (node->recorderRunning) {
+        node->recorderTriggered = true;
+    }
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::IsRecorderRunning(void * handle, unsigned short nodeId, bool & isRunning, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("IsRecorderRunning", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    isRunning = node->recorderRunning;
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::ReadChannelVectorSize(void * handle, unsigned short nodeId, unsigned int & vectorSize,
+                                                        unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("ReadChannelVectorSize", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    vectorSize = static_cast<unsigned int>(node->recorderSamples.size() / RECORDER_CHANNELS);
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::ReadChannelDataVector(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                                                        void * data, unsigned int bufferSize, unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Node * node = BeginNodeCall("ReadChannelDataVector", handle, nodeId, lock, errorCode);
+    if (!node) {
+        return false;
+    }
+    if ((channelNumber < 1) || (channelNumber > RECORDER_CHANNELS)
+        || (node->recorderChannels[channelNumber - 1].size == 0)) {
+        errorCode = ERROR_BAD_PARAMETER;
+        return false;
+    }
+    const size_t size = node->recorderChannels[channelNumber - 1].size;
+    const size_t numberOfSamples = node->recorderSamples.size() / RECORDER_CHANNELS;
+    if (bufferSize < numberOfSamples * size) {
+        errorCode = ERROR_BAD_PARAMETER;
+        return false;
+    }
+    unsigned char * bytes = static_cast<unsigned char *>(data);
+    for (size_t sample = 0; sample < numberOfSamples; ++sample) {
+        const unsigned int value = node->recorderSamples[sample * RECORDER_CHANNELS + channelNumber - 1];
+        for (size_t byte = 0; byte < size; ++byte) {
+            *bytes++ = static_cast<unsigned char>(value >> (8 * byte));
+        }
+    }
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::ReadCANFrame(void * handle, unsigned short cobId, unsigned short length, void * data,
+                                               unsigned int CMN_UNUSED(timeout), unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Bus * bus = BeginCall("ReadCANFrame", handle, 0, lock, errorCode);
+    if (!bus) {
+        return false;
+    }
+    // Only TxPDO 1 to 4 are produced (COB-ID 0x180, 0x280, 0x380, 0x480 + node id)
+    const unsigned short functionCode = cobId & 0x780;
+    const unsigned short nodeId = cobId & 0x7F;
+    if ((functionCode < 0x180) || (functionCode > 0x480) || ((functionCode & 0x7F) != 0)
+        || ((functionCode - 0x180) % 0x100 != 0) || (nodeId == 0)) {
+        errorCode = ERROR_TIMEOUT;
+        return false;
+    }
+    const unsigned short pdo = (functionCode - 0x180) / 0x100;
+    Node & node = bus->nodes[nodeId];
+    Update(node, Now());
+    unsigned int value, size, error;
+    // PDO must be valid (COB-ID bit 31 cleared) and node operational
+    if (!node.operational
+        || (ReadObject(node, nodeId, 0x1800 + pdo, 1, value, size, error) && ((value & 0x80000000) || ((value & 0x7FF) != cobId)))) {
+        errorCode = ERROR_TIMEOUT;
+        return false;
+    }
+    unsigned char frame[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    unsigned int frameSize = 0;
+    unsigned int numberOfEntries = 0;
+    if (ReadObject(node, nodeId, 0x1A00 + pdo, 0, numberOfEntries, size, error)) {
+        for (unsigned int entry = 1; entry <= numberOfEntries; entry++) {
+            unsigned int mapping;
+            if (!ReadObject(node, nodeId, 0x1A00 + pdo, static_cast<unsigned char>(entry), mapping, size, error)) {
+                break;
+            }
+            const unsigned short index = static_cast<unsigned short>(mapping >> 16);
+            const unsigned char subIndex = static_cast<unsigned char>((mapping >> 8) & 0xFF);
+            const unsigned int bytes = (mapping & 0xFF) / 8;
+            if (!ReadObject(node, nodeId, index, subIndex, value, size, error) || (frameSize + bytes > 8)) {
+                break;
+            }
+            for (unsigned int i = 0; i < bytes; i++) {
+                frame[frameSize++] = static_cast<unsigned char>(value >> (8 * i));
+            }
+        }
+    }
+    unsigned char * bytes = static_cast<unsigned char *>(data);
+    for (unsigned int i = 0; (i < length) && (i < 8); i++) {
+        bytes[i] = frame[i];
+    }
+    return true;
+}
+
+bool mtsMaxonEPOSDriverSimulated::SendCANFrame(void * handle, unsigned short cobId, unsigned short length, const void * data,
+                                               unsigned int & errorCode)
+{
+    std::unique_lock<std::mutex> lock;
+    Bus * bus = BeginCall("SendCANFrame", handle, 0, lock, errorCode);
+    if (!bus) {
+        return false;
+    }
+    const unsigned char * bytes = static_cast<const unsigned char *>(data);
+    if ((cobId == 0) && (length >= 2)) {
+        // NMT: command specifier, node id
+        ApplyNMT(*bus, bytes[1], bytes[0]);
+    } else if (cobId == 0x80) {
+        // SYNC: synchronous RxPDOs received since the last SYNC are applied
+        const double now = Now();
+        for (unsigned short nodeId = 1; nodeId < MAX_NODES; nodeId++) {
+            Node & node = bus->nodes[nodeId];
+            if (node.rxPDOPending >= 0) {
+                Update(node, now);
+                ApplyRxPDO(node, nodeId, static_cast<unsigned short>(node.rxPDOPending), node.rxPDOData);
+                node.rxPDOPending = -1;
+            }
+        }
+    } else if ((cobId >= 0x200) && (cobId < 0x580)) {
+        // RxPDO, received by all operational nodes with a valid RxPDO using
+        // this COB-ID (several nodes can share one)
+        unsigned char frame[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        for (unsigned int i = 0; (i < length) && (i < 8); i++) {
+            frame[i] = bytes[i];
+        }
+        const double now = Now();
+        for (unsigned short nodeId = 1; nodeId < MAX_NODES; nodeId++) {
+            Node & node = bus->nodes[nodeId];
+            if (!node.operational) {
+                continue;
+            }
+            for (unsigned short pdo = 0; pdo < 4; pdo++) {
+                unsigned int value, size, error;
+                if (!ReadObject(node, nodeId, 0x1400 + pdo, 1, value, size, error)
+                    || (value & 0x80000000) || ((value & 0x7FF) != cobId)) {
+                    continue;
+                }
+                unsigned int transmissionType = 255;
+                ReadObject(node, nodeId, 0x1400 + pdo, 2, transmissionType, size, error);
+                if (transmissionType <= 240) {
+                    node.rxPDOPending = pdo;
+                    std::copy(frame, frame + 8, node.rxPDOData);
+                } else {
+                    Update(node, now);
+                    ApplyRxPDO(node, nodeId, pdo, frame);
+                }
+            }
+        }
+    }
+    return true;
+}
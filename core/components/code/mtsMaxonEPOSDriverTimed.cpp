@@ -0,0 +1,380 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+  (C) Copyright 2024-2025 Johns Hopkins University (JHU)
+
+--- begin cisst license - do not edit ---
+This software is provided "as is" under an open source license, with no warranty.
+--- end cisst license ---
+*/
+
+#include <sawMaxonEPOS/mtsMaxonEPOSDriverTimed.h>
+
+mtsMaxonEPOSDriverTimed::mtsMaxonEPOSDriverTimed(mtsMaxonEPOSDriver * driver, size_t numberOfAxes) :
+    mDriver(driver)
+{
+    AxisKey unknown;
+    unknown.handle = nullptr;
+    unknown.nodeId = 0;
+    mAxes.resize(numberOfAxes, unknown);
+    // one extra column for calls not addressed to an axis
+    mHistogram.SetSize(NUMBER_OF_CALLS, numberOfAxes + 1);
+}
+
+mtsMaxonEPOSDriverTimed::~mtsMaxonEPOSDriverTimed()
+{
+    delete mDriver;
+}
+
+void mtsMaxonEPOSDriverTimed::SetAxis(size_t axis, void * handle, unsigned short nodeId)
+{
+    if (axis < mAxes.size()) {
+        mAxes[axis].handle = handle;
+        mAxes[axis].nodeId = nodeId;
+    }
+}
+
+size_t mtsMaxonEPOSDriverTimed::Axis(void * handle, unsigned short nodeId) const
+{
+    if (nodeId == 0) {
+        return mAxes.size();
+    }
+    // exact match first, then node id only (e.g. node reached through the gateway handle)
+    size_t nodeMatch = mAxes.size();
+    for (size_t axis = 0; axis < mAxes.size(); axis++) {
+        if (mAxes[axis].nodeId == nodeId) {
+            if (mAxes[axis].handle == handle) {
+                return axis;
+            }
+            if (nodeMatch == mAxes.size()) {
+                nodeMatch = axis;
+            }
+        }
+    }
+    return nodeMatch;
+}
+
+void * mtsMaxonEPOSDriverTimed::OpenDevice(const std::string & deviceName, const std::string & protocolStackName,
+                                          const std::string & interfaceName, const std::string & portName,
+                                          unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_OPEN_DEVICE, nullptr, 0);
+    return mDriver->OpenDevice(deviceName, protocolStackName, interfaceName, portName, errorCode);
+}
+
+void * mtsMaxonEPOSDriverTimed::OpenSubDevice(void * deviceHandle, const std::string & deviceName,
+                                             const std::string & protocolStackName, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_OPEN_SUB_DEVICE, deviceHandle, 0);
+    return mDriver->OpenSubDevice(deviceHandle, deviceName, protocolStackName, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::CloseSubDevice(void * handle, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_CLOSE_SUB_DEVICE, handle, 0);
+    return mDriver->CloseSubDevice(handle, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::CloseDevice(void * handle, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_CLOSE_DEVICE, handle, 0);
+    return mDriver->CloseDevice(handle, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::GetProtocolStackSettings(void * handle, unsigned int & baudrate, unsigned int & timeout,
+                                                       unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_GET_PROTOCOL_STACK_SETTINGS, handle, 0);
+    return mDriver->GetProtocolStackSettings(handle, baudrate, timeout, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::SetProtocolStackSettings(void * handle, unsigned int baudrate, unsigned int timeout,
+                                                       unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_SET_PROTOCOL_STACK_SETTINGS, handle, 0);
+    return mDriver->SetProtocolStackSettings(handle, baudrate, timeout, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::SendNMTService(void * handle, unsigned short nodeId, unsigned short commandSpecifier,
+                                             unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_SEND_NMT_SERVICE, handle, nodeId);
+    return mDriver->SendNMTService(handle, nodeId, commandSpecifier, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::ClearFault(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_CLEAR_FAULT, handle, nodeId);
+    return mDriver->ClearFault(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::GetFaultState(void * handle, unsigned short nodeId, bool & isFault, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_GET_FAULT_STATE, handle, nodeId);
+    return mDriver->GetFaultState(handle, nodeId, isFault, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::GetEnableState(void * handle, unsigned short nodeId, bool & isEnabled, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_GET_ENABLE_STATE, handle, nodeId);
+    return mDriver->GetEnableState(handle, nodeId, isEnabled, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::SetEnableState(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_SET_ENABLE_STATE, handle, nodeId);
+    return mDriver->SetEnableState(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::SetDisableState(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_SET_DISABLE_STATE, handle, nodeId);
+    return mDriver->SetDisableState(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::GetState(void * handle, unsigned short nodeId, unsigned short & state, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_GET_STATE, handle, nodeId);
+    return mDriver->GetState(handle, nodeId, state, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::GetPositionIs(void * handle, unsigned short nodeId, int & position, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_GET_POSITION_IS, handle, nodeId);
+    return mDriver->GetPositionIs(handle, nodeId, position, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::GetCurrentIs(void * handle, unsigned short nodeId, short & current, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_GET_CURRENT_IS, handle, nodeId);
+    return mDriver->GetCurrentIs(handle, nodeId, current, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::ActivateProfilePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_ACTIVATE_PROFILE_POSITION_MODE, handle, nodeId);
+    return mDriver->ActivateProfilePositionMode(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::ActivatePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_ACTIVATE_POSITION_MODE, handle, nodeId);
+    return mDriver->ActivatePositionMode(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::ActivateVelocityMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_ACTIVATE_VELOCITY_MODE, handle, nodeId);
+    return mDriver->ActivateVelocityMode(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::ActivateCurrentMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_ACTIVATE_CURRENT_MODE, handle, nodeId);
+    return mDriver->ActivateCurrentMode(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::ActivateInterpolatedPositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_ACTIVATE_INTERPOLATED_POSITION_MODE, handle, nodeId);
+    return mDriver->ActivateInterpolatedPositionMode(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::SetPositionProfile(void * handle, unsigned short nodeId, unsigned int profileVelocity,
+                                                 unsigned int profileAcceleration, unsigned int profileDeceleration,
+                                                 unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_SET_POSITION_PROFILE, handle, nodeId);
+    return mDriver->SetPositionProfile(handle, nodeId, profileVelocity, profileAcceleration, profileDeceleration, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::MoveToPosition(void * handle, unsigned short nodeId, int targetPosition,
+                                             bool absolute, bool immediately, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_MOVE_TO_POSITION, handle, nodeId);
+    return mDriver->MoveToPosition(handle, nodeId, targetPosition, absolute, immediately, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::HaltPositionMovement(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_HALT_POSITION_MOVEMENT, handle, nodeId);
+    return mDriver->HaltPositionMovement(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::HaltVelocityMovement(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_HALT_VELOCITY_MOVEMENT, handle, nodeId);
+    return mDriver->HaltVelocityMovement(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::SetPositionMust(void * handle, unsigned short nodeId, int position, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_SET_POSITION_MUST, handle, nodeId);
+    return mDriver->SetPositionMust(handle, nodeId, position, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::SetVelocityMust(void * handle, unsigned short nodeId, int velocity, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_SET_VELOCITY_MUST, handle, nodeId);
+    return mDriver->SetVelocityMust(handle, nodeId, velocity, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::SetCurrentMust(void * handle, unsigned short nodeId, short current, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_SET_CURRENT_MUST, handle, nodeId);
+    return mDriver->SetCurrentMust(handle, nodeId, current, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::SetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short underflowWarningLimit,
+                                                    unsigned short overflowWarningLimit, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_SET_IPM_BUFFER_PARAMETER, handle, nodeId);
+    return mDriver->SetIpmBufferParameter(handle, nodeId, underflowWarningLimit, overflowWarningLimit, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::GetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short & underflowWarningLimit,
+                                                    unsigned short & overflowWarningLimit, unsigned int & maxBufferSize,
+                                                    unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_GET_IPM_BUFFER_PARAMETER, handle, nodeId);
+    return mDriver->GetIpmBufferParameter(handle, nodeId, underflowWarningLimit, overflowWarningLimit, maxBufferSize, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::ClearIpmBuffer(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_CLEAR_IPM_BUFFER, handle, nodeId);
+    return mDriver->ClearIpmBuffer(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::GetFreeIpmBufferSize(void * handle, unsigned short nodeId, unsigned int & bufferSize,
+                                                   unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_GET_FREE_IPM_BUFFER_SIZE, handle, nodeId);
+    return mDriver->GetFreeIpmBufferSize(handle, nodeId, bufferSize, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::AddPvtValueToIpmBuffer(void * handle, unsigned short nodeId, int position, int velocity,
+                                                     unsigned char time, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_ADD_PVT_VALUE_TO_IPM_BUFFER, handle, nodeId);
+    return mDriver->AddPvtValueToIpmBuffer(handle, nodeId, position, velocity, time, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::StartIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_START_IPM_TRAJECTORY, handle, nodeId);
+    return mDriver->StartIpmTrajectory(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::StopIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_STOP_IPM_TRAJECTORY, handle, nodeId);
+    return mDriver->StopIpmTrajectory(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::GetIpmStatus(void * handle, unsigned short nodeId, IpmStatus & status, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_GET_IPM_STATUS, handle, nodeId);
+    return mDriver->GetIpmStatus(handle, nodeId, status, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::GetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                                        void * data, unsigned int numberOfBytesToRead, unsigned int & numberOfBytesRead,
+                                        unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_GET_OBJECT, handle, nodeId);
+    return mDriver->GetObject(handle, nodeId, objectIndex, objectSubIndex, data, numberOfBytesToRead, numberOfBytesRead, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::SetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                                        const void * data, unsigned int numberOfBytesToWrite, unsigned int & numberOfBytesWritten,
+                                        unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_SET_OBJECT, handle, nodeId);
+    return mDriver->SetObject(handle, nodeId, objectIndex, objectSubIndex, data, numberOfBytesToWrite, numberOfBytesWritten, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::SetRecorderParameter(void * handle, unsigned short nodeId, unsigned short samplingPeriod,
+                                                   unsigned short numberOfPrecedingSamples, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_SET_RECORDER_PARAMETER, handle, nodeId);
+    return mDriver->SetRecorderParameter(handle, nodeId, samplingPeriod, numberOfPrecedingSamples, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::EnableTrigger(void * handle, unsigned short nodeId, unsigned char triggerType, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_ENABLE_TRIGGER, handle, nodeId);
+    return mDriver->EnableTrigger(handle, nodeId, triggerType, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::DisableAllTriggers(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_DISABLE_ALL_TRIGGERS, handle, nodeId);
+    return mDriver->DisableAllTriggers(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::ActivateChannel(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                                              unsigned short objectIndex, unsigned char objectSubIndex, unsigned char objectSize,
+                                              unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_ACTIVATE_CHANNEL, handle, nodeId);
+    return mDriver->ActivateChannel(handle, nodeId, channelNumber, objectIndex, objectSubIndex, objectSize, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::DeactivateAllChannels(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_DEACTIVATE_ALL_CHANNELS, handle, nodeId);
+    return mDriver->DeactivateAllChannels(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::StartRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_START_RECORDER, handle, nodeId);
+    return mDriver->StartRecorder(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::StopRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_STOP_RECORDER, handle, nodeId);
+    return mDriver->StopRecorder(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::ForceTrigger(void * handle, unsigned short nodeId, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_FORCE_TRIGGER, handle, nodeId);
+    return mDriver->ForceTrigger(handle, nodeId, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::IsRecorderRunning(void * handle, unsigned short nodeId, bool & isRunning, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_IS_RECORDER_RUNNING, handle, nodeId);
+    return mDriver->IsRecorderRunning(handle, nodeId, isRunning, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::ReadChannelVectorSize(void * handle, unsigned short nodeId, unsigned int & vectorSize,
+                                                    unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_READ_CHANNEL_VECTOR_SIZE, handle, nodeId);
+    return mDriver->ReadChannelVectorSize(handle, nodeId, vectorSize, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::ReadChannelDataVector(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                                                    void * data, unsigned int bufferSize, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_READ_CHANNEL_DATA_VECTOR, handle, nodeId);
+    return mDriver->ReadChannelDataVector(handle, nodeId, channelNumber, data, bufferSize, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::ReadCANFrame(void * handle, unsigned short cobId, unsigned short length, void * data,
+                                           unsigned int timeout, unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_READ_CAN_FRAME, handle, static_cast<unsigned short>(cobId & 0x7F));
+    return mDriver->ReadCANFrame(handle, cobId, length, data, timeout, errorCode);
+}
+
+bool mtsMaxonEPOSDriverTimed::SendCANFrame(void * handle, unsigned short cobId, unsigned short length, const void * data,
+                                           unsigned int & errorCode)
+{
+    Timer timer(*this, CALL_SEND_CAN_FRAME, handle, 0);
+    return mDriver->SendCANFrame(handle, cobId, length, data, errorCode);
+}
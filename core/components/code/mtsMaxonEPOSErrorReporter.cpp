@@ -0,0 +1,104 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+  (C) Copyright 2024-2025 Johns Hopkins University (JHU)
+
+--- begin cisst license - do not edit ---
+This software is provided "as is" under an open source license, with no warranty.
+--- end cisst license ---
+*/
+
+#include <cstdio>
+
+#include <sawMaxonEPOS/mtsMaxonEPOSErrorReporter.h>
+
+// Maximum number of call/axis detailed in a summary
+static const size_t MaximumDetails = 4;
+
+mtsMaxonEPOSErrorReporter::mtsMaxonEPOSErrorReporter() :
+    mNumberOfColumns(0),
+    mSummaryPeriod(0.1),
+    mLastSummary(0.0),
+    mPending(0),
+    mTotal(0)
+{}
+
+void mtsMaxonEPOSErrorReporter::Configure(size_t numberOfAxes, double summaryPeriod)
+{
+    mNumberOfColumns = numberOfAxes + 1;
+    mSummaryPeriod = summaryPeriod;
+    mCells.resize(mtsMaxonEPOSDriver::NUMBER_OF_CALLS * mNumberOfColumns);
+    Reset();
+}
+
+void mtsMaxonEPOSErrorReporter::Record(mtsMaxonEPOSDriver::Call call, size_t axis, unsigned int errorCode)
+{
+    if ((call >= mtsMaxonEPOSDriver::NUMBER_OF_CALLS) || (axis >= mNumberOfColumns)) {
+        return;
+    }
+    Cell & cell = mCells[call * mNumberOfColumns + axis];
+    cell.total++;
+    cell.pending++;
+    cell.lastErrorCode = errorCode;
+    mPending++;
+    mTotal++;
+}
+
+bool mtsMaxonEPOSErrorReporter::Summary(double now, std::string & message)
+{
+    if ((mPending == 0) || (now - mLastSummary < mSummaryPeriod)) {
+        return false;
+    }
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer), "%u error(s) in last %.2fs:", mPending, now - mLastSummary);
+    message = buffer;
+    size_t details = 0;
+    for (size_t index = 0; index < mCells.size(); ++index) {
+        Cell & cell = mCells[index];
+        if (cell.pending == 0) {
+            continue;
+        }
+        if (details < MaximumDetails) {
+            const size_t axis = index % mNumberOfColumns;
+            const mtsMaxonEPOSDriver::Call call = static_cast<mtsMaxonEPOSDriver::Call>(index / mNumberOfColumns);
+            char axisName[16];
+            if (axis + 1 < mNumberOfColumns) {
+                std::snprintf(axisName, sizeof(axisName), "axis %u", static_cast<unsigned int>(axis));
+            } else {
+                std::snprintf(axisName, sizeof(axisName), "bus");
+            }
+            std::snprintf(buffer, sizeof(buffer), "%s %s %s x%u (0x%08X %s)",
+                          (details > 0) ? ";" : "", mtsMaxonEPOSDriver::CallName(call), axisName,
+                          cell.pending, cell.lastErrorCode, mtsMaxonEPOSDriver::ErrorDescription(cell.lastErrorCode));
+            message += buffer;
+        }
+        details++;
+        cell.pending = 0;
+    }
+    if (details > MaximumDetails) {
+        std::snprintf(buffer, sizeof(buffer), "; and %u more", static_cast<unsigned int>(details - MaximumDetails));
+        message += buffer;
+    }
+    mPending = 0;
+    mLastSummary = now;
+    return true;
+}
+
+void mtsMaxonEPOSErrorReporter::GetCounters(vctDoubleVec & counters) const
+{
+    counters.SetSize(mCells.size());
+    for (size_t index = 0; index < mCells.size(); ++index) {
+        counters[index] = static_cast<double>(mCells[index].total);
+    }
+}
+
+void mtsMaxonEPOSErrorReporter::Reset(void)
+{
+    for (size_t index = 0; index < mCells.size(); ++index) {
+        mCells[index].total = 0;
+        mCells[index].pending = 0;
+        mCells[index].lastErrorCode = 0;
+    }
+    mPending = 0;
+    mTotal = 0;
+}
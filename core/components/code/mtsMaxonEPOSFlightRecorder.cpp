@@ -0,0 +1,169 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+  (C) Copyright 2024-2025 Johns Hopkins University (JHU)
+
+--- begin cisst license - do not edit ---
+This software is provided "as is" under an open source license, with no warranty.
+--- end cisst license ---
+*/
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+#include <cisstCommon/cmnLogger.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSFlightRecorder.h>
+
+mtsMaxonEPOSFlightRecorder::mtsMaxonEPOSFlightRecorder() :
+    mNumberOfAxes(0),
+    mCapacity(0),
+    mSampleSize(0),
+    mDuration(0.0),
+    mHead(0),
+    mCount(0),
+    mDumpHead(0),
+    mDumpCount(0),
+    mDumpRequested(false),
+    mDumpInProgress(false),
+    mStopRequested(false)
+{}
+
+mtsMaxonEPOSFlightRecorder::~mtsMaxonEPOSFlightRecorder()
+{
+    Stop();
+}
+
+void mtsMaxonEPOSFlightRecorder::Configure(size_t numberOfAxes, size_t capacity, double duration)
+{
+    Stop();
+    mNumberOfAxes = numberOfAxes;
+    mCapacity = capacity;
+    mDuration = duration;
+    mSampleSize = sizeof(SampleHeader) + numberOfAxes * sizeof(AxisSample);
+    mBuffer.assign(mCapacity * mSampleSize, 0);
+    mDumpBuffer.assign(mCapacity * mSampleSize, 0);
+    mHead = 0;
+    mCount = 0;
+}
+
+void mtsMaxonEPOSFlightRecorder::Start(void)
+{
+    if (!IsEnabled() || mThread.joinable()) {
+        return;
+    }
+    mStopRequested = false;
+    mThread = std::thread(&mtsMaxonEPOSFlightRecorder::Writer, this);
+}
+
+void mtsMaxonEPOSFlightRecorder::Stop(void)
+{
+    if (!mThread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopRequested = true;
+    }
+    mCondition.notify_one();
+    mThread.join();
+}
+
+void mtsMaxonEPOSFlightRecorder::Record(const SampleHeader & header, const AxisSample * axes)
+{
+    if (!IsEnabled()) {
+        return;
+    }
+    unsigned char * sample = mBuffer.data() + mHead * mSampleSize;
+    std::memcpy(sample, &header, sizeof(SampleHeader));
+    std::memcpy(sample + sizeof(SampleHeader), axes, mNumberOfAxes * sizeof(AxisSample));
+    mHead = (mHead + 1) % mCapacity;
+    if (mCount < mCapacity) {
+        mCount++;
+    }
+}
+
+bool mtsMaxonEPOSFlightRecorder::Dump(const std::string & fileName)
+{
+    if (!IsEnabled() || (mCount == 0)) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mDumpRequested || mDumpInProgress || !mThread.joinable()) {
+            return false;
+        }
+        // hand the ring over to the writer thread, no copy
+        mBuffer.swap(mDumpBuffer);
+        mDumpHead = mHead;
+        mDumpCount = mCount;
+        mDumpFileName = fileName;
+        mDumpRequested = true;
+    }
+    mHead = 0;
+    mCount = 0;
+    mCondition.notify_one();
+    return true;
+}
+
+void mtsMaxonEPOSFlightRecorder::Writer(void)
+{
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this] { return mStopRequested || mDumpRequested; });
+            if (!mDumpRequested) {
+                return;
+            }
+            mDumpRequested = false;
+            mDumpInProgress = true;
+        }
+        Write();
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mDumpInProgress = false;
+        }
+    }
+}
+
+void mtsMaxonEPOSFlightRecorder::Write(void)
+{
+    // oldest sample in the ring
+    const size_t first = (mDumpHead + mCapacity - mDumpCount) % mCapacity;
+    const unsigned char * newest = mDumpBuffer.data() + ((mDumpHead + mCapacity - 1) % mCapacity) * mSampleSize;
+    const double end = reinterpret_cast<const SampleHeader *>(newest)->time;
+
+    // skip samples older than duration
+    size_t skip = 0;
+    while (skip < mDumpCount) {
+        const unsigned char * sample = mDumpBuffer.data() + ((first + skip) % mCapacity) * mSampleSize;
+        if (reinterpret_cast<const SampleHeader *>(sample)->time >= end - mDuration) {
+            break;
+        }
+        skip++;
+    }
+
+    std::ofstream file(mDumpFileName.c_str(), std::ios::binary);
+    if (!file.is_open()) {
+        CMN_LOG_RUN_ERROR << "mtsMaxonEPOSFlightRecorder: failed to open " << mDumpFileName << std::endl;
+        return;
+    }
+    const uint32_t numberOfAxes = static_cast<uint32_t>(mNumberOfAxes);
+    const uint32_t numberOfSamples = static_cast<uint32_t>(mDumpCount - skip);
+    const double wallClock = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    file.write("EPOSFR01", 8);
+    file.write(reinterpret_cast<const char *>(&numberOfAxes), sizeof(numberOfAxes));
+    file.write(reinterpret_cast<const char *>(&numberOfSamples), sizeof(numberOfSamples));
+    file.write(reinterpret_cast<const char *>(&wallClock), sizeof(wallClock));
+    // ring may wrap, write in up to two blocks
+    const size_t start = (first + skip) % mCapacity;
+    const size_t firstBlock = (start + numberOfSamples <= mCapacity) ? numberOfSamples : (mCapacity - start);
+    file.write(reinterpret_cast<const char *>(mDumpBuffer.data() + start * mSampleSize), firstBlock * mSampleSize);
+    file.write(reinterpret_cast<const char *>(mDumpBuffer.data()), (numberOfSamples - firstBlock) * mSampleSize);
+    if (!file.good()) {
+        CMN_LOG_RUN_ERROR << "mtsMaxonEPOSFlightRecorder: failed to write " << mDumpFileName << std::endl;
+        return;
+    }
+    CMN_LOG_RUN_WARNING << "mtsMaxonEPOSFlightRecorder: saved " << numberOfSamples << " samples to "
+                        << mDumpFileName << std::endl;
+}
@@ -0,0 +1,348 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+  (C) Copyright 2024-2025 Johns Hopkins University (JHU)
+
+--- begin cisst license - do not edit ---
+This software is provided "as is" under an open source license, with no warranty.
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <sawMaxonEPOS/mtsMaxonEPOSKinematics.h>
+
+// Below this bending angle, use the series expansion of the snake position
+static const double StraightSnakeAngle = 1.0e-6;
+
+// Joint step for the finite difference Jacobian (rad)
+static const double JacobianStep = 1.0e-6;
+
+// Largest joint change per inverse kinematics iteration (rad)
+static const double MaximumStep = 0.2;
+
+// Pose error: position error and orientation error (rad, about the
+// reference frame axes) scaled by the orientation weight
+static void PoseError(const double rotation[3][3], const double position[3],
+                      const double goalRotation[3][3], const double goalPosition[3],
+                      double orientationWeight, double error[6])
+{
+    for (size_t i = 0; i < 3; ++i) {
+        error[i] = goalPosition[i] - position[i];
+    }
+    // 1/2 sum of column_i x goal column_i
+    double rotationError[3] = { 0.0, 0.0, 0.0 };
+    for (size_t col = 0; col < 3; ++col) {
+        rotationError[0] += rotation[1][col] * goalRotation[2][col] - rotation[2][col] * goalRotation[1][col];
+        rotationError[1] += rotation[2][col] * goalRotation[0][col] - rotation[0][col] * goalRotation[2][col];
+        rotationError[2] += rotation[0][col] * goalRotation[1][col] - rotation[1][col] * goalRotation[0][col];
+    }
+    for (size_t i = 0; i < 3; ++i) {
+        error[3 + i] = 0.5 * orientationWeight * rotationError[i];
+    }
+}
+
+mtsMaxonEPOSKinematics::mtsMaxonEPOSKinematics() :
+    mEnabled(false),
+    mSnakeLength(0.0),
+    mToolLength(0.0),
+    mTolerance(1.0e-6),
+    mIKBudget(0.0005),
+    mIKMaxIterations(20),
+    mIKTolerance(1.0e-6),
+    mIKDamping(1.0e-4),
+    mIKOrientationWeight(0.001),
+    mValid(false),
+    mRollCos(1.0),
+    mRollSin(0.0)
+{
+    for (size_t joint = 0; joint < NUMBER_OF_JOINTS; ++joint) {
+        mAxis[joint] = -1;
+        mScale[joint] = 0.0;
+        mJoints[joint] = 0.0;
+    }
+}
+
+bool mtsMaxonEPOSKinematics::Configure(const Json::Value & jsonConfig, size_t numberOfAxes,
+                                       const std::string & robotName, std::string & error)
+{
+    mEnabled = false;
+    mValid = false;
+    if (jsonConfig.isNull()) {
+        return true;
+    }
+    const std::string type = jsonConfig.get("type", "I2RIS").asString();
+    if (type != "I2RIS") {
+        error = "unsupported kinematics type \"" + type + "\", must be I2RIS";
+        return false;
+    }
+    const char * names[NUMBER_OF_JOINTS] = { "roll", "pitch", "yaw" };
+    for (size_t joint = 0; joint < NUMBER_OF_JOINTS; ++joint) {
+        const Json::Value jsonJoint = jsonConfig[names[joint]];
+        mAxis[joint] = jsonJoint.get("axis", -1).asInt();
+        mScale[joint] = jsonJoint.get("scale", 0.0).asDouble();
+        if ((mAxis[joint] < -1) || (mAxis[joint] >= static_cast<int>(numberOfAxes))) {
+            error = std::string("invalid axis for ") + names[joint];
+            return false;
+        }
+    }
+    mSnakeLength = jsonConfig.get("snake_length", 0.0).asDouble();
+    mToolLength = jsonConfig.get("tool_length", 0.0).asDouble();
+    mTolerance = jsonConfig.get("tolerance", 1.0e-6).asDouble();
+    if ((mSnakeLength <= 0.0) || (mToolLength < 0.0) || (mTolerance < 0.0)) {
+        error = "snake_length must be positive, tool_length and tolerance can't be negative";
+        return false;
+    }
+    const Json::Value jsonIK = jsonConfig["ik"];
+    mIKBudget = jsonIK.get("budget", 0.0005).asDouble();
+    mIKMaxIterations = jsonIK.get("max_iterations", 20).asUInt();
+    mIKTolerance = jsonIK.get("tolerance", 1.0e-6).asDouble();
+    mIKDamping = jsonIK.get("damping", 1.0e-4).asDouble();
+    mIKOrientationWeight = jsonIK.get("orientation_weight", 0.001).asDouble();
+    if ((mIKBudget < 0.0) || (mIKMaxIterations == 0) || (mIKTolerance <= 0.0)
+        || (mIKDamping < 0.0) || (mIKOrientationWeight < 0.0)) {
+        error = "ik max_iterations and tolerance must be positive, budget, damping and orientation_weight can't be negative";
+        return false;
+    }
+    mBaseFrame = jsonConfig.get("base_frame", robotName + "_base").asString();
+    mTipFrame = jsonConfig.get("tip_frame", robotName + "_tip").asString();
+    mEnabled = true;
+    return true;
+}
+
+void mtsMaxonEPOSKinematics::JointsFromMotors(const vctDoubleVec & motors, double joints[NUMBER_OF_JOINTS]) const
+{
+    for (size_t joint = 0; joint < NUMBER_OF_JOINTS; ++joint) {
+        joints[joint] = (mAxis[joint] < 0) ? 0.0 : mScale[joint] * motors[mAxis[joint]];
+    }
+}
+
+void mtsMaxonEPOSKinematics::MotorsFromJoints(const double joints[NUMBER_OF_JOINTS], vctDoubleVec & motors) const
+{
+    for (size_t joint = 0; joint < NUMBER_OF_JOINTS; ++joint) {
+        if ((mAxis[joint] >= 0) && (mScale[joint] != 0.0)) {
+            motors[mAxis[joint]] = joints[joint] / mScale[joint];
+        }
+    }
+}
+
+void mtsMaxonEPOSKinematics::Snake(double pitch, double yaw, double rotation[3][3], double position[3]) const
+{
+    const double theta = std::sqrt(pitch * pitch + yaw * yaw);
+    const double c = std::cos(theta);
+    const double s = std::sin(theta);
+    double cphi = 1.0, sphi = 0.0;
+    if (theta > 0.0) {
+        cphi = pitch / theta;
+        sphi = yaw / theta;
+    }
+    // Rz(phi) Ry(theta) Rz(-phi)
+    rotation[0][0] = cphi * cphi * c + sphi * sphi;
+    rotation[0][1] = cphi * sphi * (c - 1.0);
+    rotation[0][2] = cphi * s;
+    rotation[1][0] = rotation[0][1];
+    rotation[1][1] = sphi * sphi * c + cphi * cphi;
+    rotation[1][2] = sphi * s;
+    rotation[2][0] = -cphi * s;
+    rotation[2][1] = -sphi * s;
+    rotation[2][2] = c;
+    // L (1 - cos) / theta and L sin / theta, series for a straight snake
+    double radial, axial;
+    if (theta < StraightSnakeAngle) {
+        radial = mSnakeLength * theta / 2.0;
+        axial = mSnakeLength * (1.0 - theta * theta / 6.0);
+    } else {
+        radial = mSnakeLength * (1.0 - c) / theta;
+        axial = mSnakeLength * s / theta;
+    }
+    // tool along the tip z axis
+    position[0] = radial * cphi + mToolLength * rotation[0][2];
+    position[1] = radial * sphi + mToolLength * rotation[1][2];
+    position[2] = axial + mToolLength * rotation[2][2];
+}
+
+void mtsMaxonEPOSKinematics::ForwardKinematics(const double joints[NUMBER_OF_JOINTS],
+                                               double rotation[3][3], double position[3]) const
+{
+    double snakeRotation[3][3], snakePosition[3];
+    Snake(joints[PITCH], joints[YAW], snakeRotation, snakePosition);
+    const double c = std::cos(joints[ROLL]);
+    const double s = std::sin(joints[ROLL]);
+    // Rz(roll) applied to the rows 0 and 1
+    for (size_t col = 0; col < 3; ++col) {
+        rotation[0][col] = c * snakeRotation[0][col] - s * snakeRotation[1][col];
+        rotation[1][col] = s * snakeRotation[0][col] + c * snakeRotation[1][col];
+        rotation[2][col] = snakeRotation[2][col];
+    }
+    position[0] = c * snakePosition[0] - s * snakePosition[1];
+    position[1] = s * snakePosition[0] + c * snakePosition[1];
+    position[2] = snakePosition[2];
+}
+
+bool mtsMaxonEPOSKinematics::Update(const vctDoubleVec & motors, vctFrm3 & pose)
+{
+    double joints[NUMBER_OF_JOINTS];
+    JointsFromMotors(motors, joints);
+
+    const bool rollChanged = !mValid || (std::abs(joints[ROLL] - mJoints[ROLL]) > mTolerance);
+    const bool snakeChanged = !mValid
+        || (std::abs(joints[PITCH] - mJoints[PITCH]) > mTolerance)
+        || (std::abs(joints[YAW] - mJoints[YAW]) > mTolerance);
+    if (!rollChanged && !snakeChanged) {
+        return false;
+    }
+    if (snakeChanged) {
+        Snake(joints[PITCH], joints[YAW], mSnakeRotation, mSnakePosition);
+        mJoints[PITCH] = joints[PITCH];
+        mJoints[YAW] = joints[YAW];
+    }
+    if (rollChanged) {
+        mRollCos = std::cos(joints[ROLL]);
+        mRollSin = std::sin(joints[ROLL]);
+        mJoints[ROLL] = joints[ROLL];
+    }
+    mValid = true;
+
+    // Rz(roll) applied to the cached snake terms
+    const double c = mRollCos;
+    const double s = mRollSin;
+    for (size_t col = 0; col < 3; ++col) {
+        pose.Rotation().Element(0, col) = c * mSnakeRotation[0][col] - s * mSnakeRotation[1][col];
+        pose.Rotation().Element(1, col) = s * mSnakeRotation[0][col] + c * mSnakeRotation[1][col];
+        pose.Rotation().Element(2, col) = mSnakeRotation[2][col];
+    }
+    pose.Translation()[0] = c * mSnakePosition[0] - s * mSnakePosition[1];
+    pose.Translation()[1] = s * mSnakePosition[0] + c * mSnakePosition[1];
+    pose.Translation()[2] = mSnakePosition[2];
+    return true;
+}
+
+mtsMaxonEPOSKinematics::Status
+mtsMaxonEPOSKinematics::InverseKinematics(const vctFrm3 & goal, double joints[NUMBER_OF_JOINTS],
+                                          unsigned int & iterations, double & residual, double budget) const
+{
+    typedef std::chrono::steady_clock clock;
+    const clock::time_point start = clock::now();
+    if (budget < 0.0) {
+        budget = mIKBudget;
+    }
+
+    double goalRotation[3][3], goalPosition[3];
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t col = 0; col < 3; ++col) {
+            goalRotation[i][col] = goal.Rotation().Element(i, col);
+        }
+        goalPosition[i] = goal.Translation()[i];
+    }
+    // Joints not actuated stay at 0
+    bool active[NUMBER_OF_JOINTS];
+    for (size_t joint = 0; joint < NUMBER_OF_JOINTS; ++joint) {
+        active[joint] = (mAxis[joint] >= 0) && (mScale[joint] != 0.0);
+        if (!active[joint]) {
+            joints[joint] = 0.0;
+        }
+    }
+
+    double rotation[3][3], position[3], error[6];
+    ForwardKinematics(joints, rotation, position);
+    PoseError(rotation, position, goalRotation, goalPosition, mIKOrientationWeight, error);
+    iterations = 0;
+    double iterationTime = 0.0;
+    while (true) {
+        residual = 0.0;
+        for (size_t i = 0; i < 6; ++i) {
+            residual += error[i] * error[i];
+        }
+        residual = std::sqrt(residual);
+        if (residual < mIKTolerance) {
+            return CONVERGED;
+        }
+        if (iterations >= mIKMaxIterations) {
+            return ITERATIONS;
+        }
+        // Stop if the next iteration would likely overrun the budget
+        const double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        if ((budget > 0.0) && (elapsed + iterationTime > budget)) {
+            return BUDGET;
+        }
+        iterationTime = elapsed / (iterations + 1);
+        ++iterations;
+
+        // Jacobian of the weighted pose error, one column per joint
+        double jacobian[6][NUMBER_OF_JOINTS];
+        for (size_t joint = 0; joint < NUMBER_OF_JOINTS; ++joint) {
+            if (!active[joint]) {
+                for (size_t i = 0; i < 6; ++i) {
+                    jacobian[i][joint] = 0.0;
+                }
+                continue;
+            }
+            double q[NUMBER_OF_JOINTS] = { joints[0], joints[1], joints[2] };
+            double rotationStep[3][3], positionStep[3], errorStep[6];
+            q[joint] += JacobianStep;
+            ForwardKinematics(q, rotationStep, positionStep);
+            PoseError(rotationStep, positionStep, goalRotation, goalPosition, mIKOrientationWeight, errorStep);
+            for (size_t i = 0; i < 6; ++i) {
+                jacobian[i][joint] = (error[i] - errorStep[i]) / JacobianStep;
+            }
+        }
+
+        // (J^T J + damping^2 I) dq = J^T e
+        double A[NUMBER_OF_JOINTS][NUMBER_OF_JOINTS], b[NUMBER_OF_JOINTS];
+        for (size_t row = 0; row < NUMBER_OF_JOINTS; ++row) {
+            b[row] = 0.0;
+            for (size_t i = 0; i < 6; ++i) {
+                b[row] += jacobian[i][row] * error[i];
+            }
+            for (size_t col = 0; col < NUMBER_OF_JOINTS; ++col) {
+                A[row][col] = (row == col) ? mIKDamping * mIKDamping : 0.0;
+                for (size_t i = 0; i < 6; ++i) {
+                    A[row][col] += jacobian[i][row] * jacobian[i][col];
+                }
+            }
+            if (!active[row]) {
+                A[row][row] = 1.0;
+            }
+        }
+        const double det =
+            A[0][0] * (A[1][1] * A[2][2] - A[1][2] * A[2][1])
+            - A[0][1] * (A[1][0] * A[2][2] - A[1][2] * A[2][0])
+            + A[0][2] * (A[1][0] * A[2][1] - A[1][1] * A[2][0]);
+        if (det == 0.0) {
+            return STALLED;
+        }
+        // Cramer's rule, A is symmetric
+        double step[NUMBER_OF_JOINTS];
+        step[0] = (b[0] * (A[1][1] * A[2][2] - A[1][2] * A[2][1])
+                   - A[0][1] * (b[1] * A[2][2] - A[1][2] * b[2])
+                   + A[0][2] * (b[1] * A[2][1] - A[1][1] * b[2])) / det;
+        step[1] = (A[0][0] * (b[1] * A[2][2] - A[1][2] * b[2])
+                   - b[0] * (A[1][0] * A[2][2] - A[1][2] * A[2][0])
+                   + A[0][2] * (A[1][0] * b[2] - b[1] * A[2][0])) / det;
+        step[2] = (A[0][0] * (A[1][1] * b[2] - b[1] * A[2][1])
+                   - A[0][1] * (A[1][0] * b[2] - b[1] * A[2][0])
+                   + b[0] * (A[1][0] * A[2][1] - A[1][1] * A[2][0])) / det;
+
+        double stepNorm = 0.0;
+        for (size_t joint = 0; joint < NUMBER_OF_JOINTS; ++joint) {
+            stepNorm = std::max(stepNorm, std::abs(step[joint]));
+        }
+        const double stepScale = (stepNorm > MaximumStep) ? MaximumStep / stepNorm : 1.0;
+        for (size_t joint = 0; joint < NUMBER_OF_JOINTS; ++joint) {
+            joints[joint] += stepScale * step[joint];
+        }
+        ForwardKinematics(joints, rotation, position);
+        PoseError(rotation, position, goalRotation, goalPosition, mIKOrientationWeight, error);
+        // Steps that don't move the tip, closest reachable pose
+        if (stepScale * stepNorm * mSnakeLength < mIKTolerance) {
+            residual = 0.0;
+            for (size_t i = 0; i < 6; ++i) {
+                residual += error[i] * error[i];
+            }
+            residual = std::sqrt(residual);
+            return (residual < mIKTolerance) ? CONVERGED : STALLED;
+        }
+    }
+}
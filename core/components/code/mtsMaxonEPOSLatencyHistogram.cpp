@@ -0,0 +1,106 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+  (C) Copyright 2024-2025 Johns Hopkins University (JHU)
+
+--- begin cisst license - do not edit ---
+This software is provided "as is" under an open source license, with no warranty.
+--- end cisst license ---
+*/
+
+#include <cmath>
+
+#include <sawMaxonEPOS/mtsMaxonEPOSLatencyHistogram.h>
+
+mtsMaxonEPOSLatencyHistogram::mtsMaxonEPOSLatencyHistogram() :
+    mNumberOfKeys(0),
+    mNumberOfColumns(0)
+{}
+
+void mtsMaxonEPOSLatencyHistogram::SetSize(size_t numberOfKeys, size_t numberOfColumns)
+{
+    mNumberOfKeys = numberOfKeys;
+    mNumberOfColumns = numberOfColumns;
+    mCells.reset(new Cell[numberOfKeys * numberOfColumns]);
+    Reset();
+}
+
+void mtsMaxonEPOSLatencyHistogram::Record(size_t key, size_t column, double seconds)
+{
+    if ((key >= mNumberOfKeys) || (column >= mNumberOfColumns)) {
+        return;
+    }
+    Cell & cell = mCells[key * mNumberOfColumns + column];
+    const unsigned long long nanoseconds = (seconds > 0.0) ? static_cast<unsigned long long>(seconds * 1.0e9) : 0;
+    // bucket from exponent and first bits of mantissa, in us
+    const double microseconds = seconds * 1.0e6;
+    size_t bucket = 0;
+    if (microseconds >= 1.0) {
+        int exponent;
+        const double mantissa = std::frexp(microseconds, &exponent);   // in [0.5, 1)
+        bucket = 1 + (exponent - 1) * SUB_BUCKETS + static_cast<size_t>((2.0 * mantissa - 1.0) * SUB_BUCKETS);
+        if (bucket >= NUMBER_OF_BUCKETS) {
+            bucket = NUMBER_OF_BUCKETS - 1;
+        }
+    }
+    cell.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    unsigned long long max = cell.maxNanoseconds.load(std::memory_order_relaxed);
+    while ((nanoseconds > max)
+           && !cell.maxNanoseconds.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed)) {}
+}
+
+double mtsMaxonEPOSLatencyHistogram::BucketUpperBound(size_t bucket)
+{
+    if (bucket == 0) {
+        return 1.0e-6;
+    }
+    const size_t exponent = (bucket - 1) / SUB_BUCKETS;
+    const size_t sub = (bucket - 1) % SUB_BUCKETS;
+    return std::ldexp(1.0 + static_cast<double>(sub + 1) / SUB_BUCKETS, static_cast<int>(exponent)) * 1.0e-6;
+}
+
+void mtsMaxonEPOSLatencyHistogram::Reset(void)
+{
+    for (size_t i = 0; i < mNumberOfKeys * mNumberOfColumns; i++) {
+        for (size_t bucket = 0; bucket < NUMBER_OF_BUCKETS; bucket++) {
+            mCells[i].buckets[bucket].store(0, std::memory_order_relaxed);
+        }
+        mCells[i].maxNanoseconds.store(0, std::memory_order_relaxed);
+    }
+}
+
+void mtsMaxonEPOSLatencyHistogram::GetStatistics(size_t key, size_t column, unsigned long long & count,
+                                                 double & p50, double & p99, double & max) const
+{
+    count = 0;
+    p50 = p99 = max = 0.0;
+    if ((key >= mNumberOfKeys) || (column >= mNumberOfColumns)) {
+        return;
+    }
+    const Cell & cell = mCells[key * mNumberOfColumns + column];
+    unsigned int buckets[NUMBER_OF_BUCKETS];
+    for (size_t bucket = 0; bucket < NUMBER_OF_BUCKETS; bucket++) {
+        buckets[bucket] = cell.buckets[bucket].load(std::memory_order_relaxed);
+        count += buckets[bucket];
+    }
+    max = cell.maxNanoseconds.load(std::memory_order_relaxed) * 1.0e-9;
+    if (count == 0) {
+        return;
+    }
+    const double p50Count = 0.50 * count;
+    const double p99Count = 0.99 * count;
+    unsigned long long cumulated = 0;
+    bool p50Found = false;
+    for (size_t bucket = 0; bucket < NUMBER_OF_BUCKETS; bucket++) {
+        cumulated += buckets[bucket];
+        const double upperBound = BucketUpperBound(bucket);
+        if (!p50Found && (cumulated >= p50Count)) {
+            p50 = (upperBound < max) ? upperBound : max;
+            p50Found = true;
+        }
+        if (cumulated >= p99Count) {
+            p99 = (upperBound < max) ? upperBound : max;
+            break;
+        }
+    }
+}
@@ -0,0 +1,323 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+  (C) Copyright 2024-2025 Johns Hopkins University (JHU)
+
+--- begin cisst license - do not edit ---
+This software is provided "as is" under an open source license, with no warranty.
+--- end cisst license ---
+*/
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#include <sawMaxonEPOS/mtsMaxonEPOSObjectDictionary.h>
+
+// Identity object, serial number
+static const unsigned short SerialNumberIndex = 0x1018;
+static const unsigned char SerialNumberSubIndex = 4;
+
+static bool NumberFromJSON(const Json::Value & value, unsigned long & number)
+{
+    if (value.isString()) {
+        try {
+            size_t end;
+            number = std::stoul(value.asString(), &end, 0);
+            return end == value.asString().size();
+        } catch (const std::exception &) {
+            return false;
+        }
+    }
+    if (value.isUInt()) {
+        number = value.asUInt();
+        return true;
+    }
+    return false;
+}
+
+bool mtsMaxonEPOSObjectDictionary::ObjectFromJSON(const Json::Value & jsonObject, Object & object, std::string & error)
+{
+    unsigned long index, subIndex, size = 4;
+    if (!NumberFromJSON(jsonObject["index"], index) || (index > 0xFFFF)) {
+        error = "invalid or missing index";
+        return false;
+    }
+    if (!NumberFromJSON(jsonObject.get("subindex", 0), subIndex) || (subIndex > 0xFF)) {
+        error = "invalid subindex";
+        return false;
+    }
+    if (!NumberFromJSON(jsonObject.get("size", 4), size) || (size < 1) || (size > 4)) {
+        error = "invalid size, must be between 1 and 4 bytes";
+        return false;
+    }
+    object.index = static_cast<unsigned short>(index);
+    object.subIndex = static_cast<unsigned char>(subIndex);
+    object.size = static_cast<unsigned char>(size);
+    object.name = jsonObject.get("name", ObjectKey(object)).asString();
+    return true;
+}
+
+std::string mtsMaxonEPOSObjectDictionary::ObjectKey(const Object & object)
+{
+    char key[16];
+    std::snprintf(key, sizeof(key), "%04X.%02X", object.index, object.subIndex);
+    return key;
+}
+
+mtsMaxonEPOSObjectDictionary::mtsMaxonEPOSObjectDictionary() :
+    mDriver(nullptr),
+    mCache(Json::objectValue),
+    mCacheModified(false),
+    mNumberOfReads(0),
+    mNumberOfWrites(0),
+    mNumberOfHits(0)
+{}
+
+void mtsMaxonEPOSObjectDictionary::Configure(mtsMaxonEPOSDriver * driver, size_t numberOfNodes)
+{
+    mDriver = driver;
+    Node empty;
+    empty.handle = nullptr;
+    empty.nodeId = 0;
+    empty.identified = false;
+    empty.serialNumber = 0;
+    mNodes.assign(numberOfNodes, empty);
+}
+
+void mtsMaxonEPOSObjectDictionary::SetNode(size_t node, void * handle, unsigned short nodeId)
+{
+    mNodes[node].handle = handle;
+    mNodes[node].nodeId = nodeId;
+}
+
+bool mtsMaxonEPOSObjectDictionary::Read(size_t nodeIndex, const Object & object, unsigned int & value,
+                                        unsigned int & errorCode)
+{
+    Node & node = mNodes[nodeIndex];
+    Entry & entry = node.entries[EntryKey(object)];
+    if (entry.valid || entry.dirty) {
+        ++mNumberOfHits;
+        value = entry.value;
+        return true;
+    }
+    // values are little endian on the bus
+    unsigned char data[4] = {0, 0, 0, 0};
+    unsigned int read;
+    ++mNumberOfReads;
+    if (!mDriver->GetObject(node.handle, node.nodeId, object.index, object.subIndex,
+                            data, object.size, read, errorCode)) {
+        return false;
+    }
+    value = 0;
+    for (unsigned int i = 0; (i < read) && (i < 4); i++) {
+        value |= static_cast<unsigned int>(data[i]) << (8 * i);
+    }
+    entry.value = value;
+    entry.size = object.size;
+    entry.valid = true;
+    entry.dirty = false;
+    return true;
+}
+
+bool mtsMaxonEPOSObjectDictionary::Read(size_t node, const std::vector<Object> & objects,
+                                        std::vector<unsigned int> & values, unsigned int & errorCode)
+{
+    values.resize(objects.size());
+    for (size_t index = 0; index < objects.size(); ++index) {
+        if (!Read(node, objects[index], values[index], errorCode)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void mtsMaxonEPOSObjectDictionary::Set(size_t node, const Object & object, unsigned int value)
+{
+    Entry & entry = mNodes[node].entries[EntryKey(object)];
+    if (entry.valid && !entry.dirty && (entry.value == value)) {
+        return;
+    }
+    entry.value = value;
+    entry.size = object.size;
+    entry.dirty = true;
+}
+
+bool mtsMaxonEPOSObjectDictionary::WriteEntry(Node & node, unsigned int key, Entry & entry, unsigned int & errorCode)
+{
+    unsigned char data[4];
+    for (unsigned int i = 0; i < 4; i++) {
+        data[i] = static_cast<unsigned char>(entry.value >> (8 * i));
+    }
+    unsigned int written;
+    ++mNumberOfWrites;
+    if (!mDriver->SetObject(node.handle, node.nodeId, static_cast<unsigned short>(key >> 8),
+                            static_cast<unsigned char>(key & 0xFF), data, entry.size, written, errorCode)) {
+        return false;
+    }
+    entry.valid = true;
+    entry.dirty = false;
+    return true;
+}
+
+bool mtsMaxonEPOSObjectDictionary::Flush(size_t nodeIndex, unsigned int & errorCode)
+{
+    Node & node = mNodes[nodeIndex];
+    bool result = true;
+    std::map<unsigned int, Entry>::iterator entry;
+    for (entry = node.entries.begin(); entry != node.entries.end(); ++entry) {
+        if (entry->second.dirty) {
+            unsigned int entryErrorCode;
+            if (!WriteEntry(node, entry->first, entry->second, entryErrorCode) && result) {
+                errorCode = entryErrorCode;
+                result = false;
+            }
+        }
+    }
+    return result;
+}
+
+bool mtsMaxonEPOSObjectDictionary::IsDirty(size_t node) const
+{
+    std::map<unsigned int, Entry>::const_iterator entry;
+    for (entry = mNodes[node].entries.begin(); entry != mNodes[node].entries.end(); ++entry) {
+        if (entry->second.dirty) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool mtsMaxonEPOSObjectDictionary::Write(size_t nodeIndex, const Object & object, unsigned int value,
+                                         unsigned int & errorCode)
+{
+    Set(nodeIndex, object, value);
+    const unsigned int key = EntryKey(object);
+    Entry & entry = mNodes[nodeIndex].entries[key];
+    if (!entry.dirty) {
+        ++mNumberOfHits;
+        return true;
+    }
+    return WriteEntry(mNodes[nodeIndex], key, entry, errorCode);
+}
+
+bool mtsMaxonEPOSObjectDictionary::Write(size_t node, const std::vector<Object> & objects,
+                                         const std::vector<unsigned int> & values, unsigned int & errorCode)
+{
+    for (size_t index = 0; (index < objects.size()) && (index < values.size()); ++index) {
+        if (!Write(node, objects[index], values[index], errorCode)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void mtsMaxonEPOSObjectDictionary::Invalidate(size_t node)
+{
+    std::map<unsigned int, Entry>::iterator entry;
+    for (entry = mNodes[node].entries.begin(); entry != mNodes[node].entries.end(); ++entry) {
+        entry->second.valid = false;
+    }
+}
+
+bool mtsMaxonEPOSObjectDictionary::LoadCache(const std::string & fileName, std::string & error)
+{
+    std::ifstream stream(fileName.c_str());
+    if (!stream.is_open()) {
+        // no cache yet
+        mCache = Json::Value(Json::objectValue);
+        return true;
+    }
+    Json::Reader reader;
+    Json::Value cache;
+    if (!reader.parse(stream, cache) || !cache["nodes"].isObject()) {
+        error = "failed to parse " + fileName + " " + reader.getFormattedErrorMessages();
+        return false;
+    }
+    mCache = cache["nodes"];
+    mCacheModified = false;
+    return true;
+}
+
+bool mtsMaxonEPOSObjectDictionary::Identify(size_t nodeIndex, unsigned int & errorCode)
+{
+    Node & node = mNodes[nodeIndex];
+    // always read from the node, it's what tells the cache is valid
+    Object serialNumber;
+    serialNumber.index = SerialNumberIndex;
+    serialNumber.subIndex = SerialNumberSubIndex;
+    serialNumber.size = 4;
+    node.entries.erase(EntryKey(serialNumber));
+    if (!Read(nodeIndex, serialNumber, node.serialNumber, errorCode)) {
+        return false;
+    }
+    node.identified = true;
+
+    char serial[16];
+    std::snprintf(serial, sizeof(serial), "%08X", node.serialNumber);
+    const Json::Value & values = mCache[serial];
+    if (!values.isObject()) {
+        return true;
+    }
+    const std::vector<std::string> keys = values.getMemberNames();
+    for (size_t index = 0; index < keys.size(); ++index) {
+        unsigned int objectIndex, objectSubIndex;
+        const Json::Value & value = values[keys[index]];
+        if ((std::sscanf(keys[index].c_str(), "%4X.%2X", &objectIndex, &objectSubIndex) != 2)
+            || !value.isArray() || (value.size() != 2)) {
+            continue;
+        }
+        Entry & entry = node.entries[(objectIndex << 8) | objectSubIndex];
+        if (!entry.dirty) {
+            entry.value = value[0].asUInt();
+            entry.size = static_cast<unsigned char>(value[1].asUInt());
+            entry.valid = true;
+        }
+    }
+    return true;
+}
+
+void mtsMaxonEPOSObjectDictionary::UpdateCache(const std::vector<Object> & staticObjects)
+{
+    for (size_t nodeIndex = 0; nodeIndex < mNodes.size(); ++nodeIndex) {
+        const Node & node = mNodes[nodeIndex];
+        if (!node.identified) {
+            continue;
+        }
+        char serial[16];
+        std::snprintf(serial, sizeof(serial), "%08X", node.serialNumber);
+        for (size_t index = 0; index < staticObjects.size(); ++index) {
+            std::map<unsigned int, Entry>::const_iterator entry = node.entries.find(EntryKey(staticObjects[index]));
+            if ((entry == node.entries.end()) || !entry->second.valid) {
+                continue;
+            }
+            // value and size
+            Json::Value value(Json::arrayValue);
+            value.append(entry->second.value);
+            value.append(entry->second.size);
+            Json::Value & cached = mCache[serial][ObjectKey(staticObjects[index])];
+            if (cached != value) {
+                cached = value;
+                mCacheModified = true;
+            }
+        }
+    }
+}
+
+bool mtsMaxonEPOSObjectDictionary::SaveCache(const std::string & fileName, std::string & error)
+{
+    if (!mCacheModified) {
+        return true;
+    }
+    std::ofstream stream(fileName.c_str());
+    if (!stream.is_open()) {
+        error = "failed to create " + fileName;
+        return false;
+    }
+    Json::Value cache;
+    cache["file_version"] = 1;
+    cache["nodes"] = mCache;
+    stream << cache.toStyledString();
+    mCacheModified = false;
+    return true;
+}
@@ -0,0 +1,115 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+  (C) Copyright 2024-2025 Johns Hopkins University (JHU)
+
+--- begin cisst license - do not edit ---
+This software is provided "as is" under an open source license, with no warranty.
+--- end cisst license ---
+*/
+
+#include <chrono>
+
+#include <sawMaxonEPOS/mtsMaxonEPOSPoller.h>
+
+mtsMaxonEPOSPoller::mtsMaxonEPOSPoller() :
+    mGeneration(0),
+    mPending(0),
+    mStopRequested(false)
+{}
+
+mtsMaxonEPOSPoller::~mtsMaxonEPOSPoller()
+{
+    Stop();
+}
+
+void mtsMaxonEPOSPoller::Configure(const std::vector<std::vector<size_t> > & groups, const JobFunction & function)
+{
+    Stop();
+    mGroups = groups;
+    mFunction = function;
+}
+
+void mtsMaxonEPOSPoller::Start(void)
+{
+    if (!mThreads.empty()) {
+        return;
+    }
+    mStopRequested = false;
+    // first group is executed by the caller of Execute
+    for (size_t group = 1; group < mGroups.size(); group++) {
+        mThreads.push_back(std::thread(&mtsMaxonEPOSPoller::Worker, this, group, mGeneration));
+    }
+}
+
+void mtsMaxonEPOSPoller::Stop(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopRequested = true;
+    }
+    mStartCondition.notify_all();
+    for (size_t i = 0; i < mThreads.size(); i++) {
+        mThreads[i].join();
+    }
+    mThreads.clear();
+}
+
+void mtsMaxonEPOSPoller::ExecuteGroup(size_t group)
+{
+    const std::vector<size_t> & jobs = mGroups[group];
+    for (size_t i = 0; i < jobs.size(); i++) {
+        mFunction(jobs[i]);
+    }
+}
+
+double mtsMaxonEPOSPoller::Execute(void)
+{
+    if (mGroups.empty()) {
+        return 0.0;
+    }
+    if (mThreads.empty()) {
+        // not started (or single group), execute everything in this thread
+        for (size_t group = 0; group < mGroups.size(); group++) {
+            ExecuteGroup(group);
+        }
+        return 0.0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPending = mThreads.size();
+        mGeneration++;
+    }
+    mStartCondition.notify_all();
+
+    ExecuteGroup(0);
+
+    const std::chrono::steady_clock::time_point startWait = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDoneCondition.wait(lock, [this] { return mPending == 0; });
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startWait).count();
+}
+
+void mtsMaxonEPOSPoller::Worker(size_t group, unsigned long long generation)
+{
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mStartCondition.wait(lock, [this, generation] { return mStopRequested || (mGeneration != generation); });
+            if (mStopRequested) {
+                return;
+            }
+            generation = mGeneration;
+        }
+        ExecuteGroup(group);
+        bool last;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mPending--;
+            last = (mPending == 0);
+        }
+        if (last) {
+            mDoneCondition.notify_one();
+        }
+    }
+}
@@ -0,0 +1,142 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+  (C) Copyright 2024-2025 Johns Hopkins University (JHU)
+
+--- begin cisst license - do not edit ---
+This software is provided "as is" under an open source license, with no warranty.
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cstring>
+
+#include <sawMaxonEPOS/mtsMaxonEPOSRealTime.h>
+
+#if (CISST_OS == CISST_LINUX)
+#include <cerrno>
+#include <ctime>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#else
+#include <chrono>
+#include <thread>
+#endif
+
+mtsMaxonEPOSRealTime::mtsMaxonEPOSRealTime() :
+    mPeriodNanoseconds(0),
+    mPriority(0),
+    mCPU(-1),
+    mLockMemory(false),
+    mBucketWidth(10.0e-6),
+    mDeadline(0),
+    mJitter(0.0),
+    mMaxJitter(0.0),
+    mOverruns(0)
+{}
+
+void mtsMaxonEPOSRealTime::Configure(double period, int priority, int cpu, bool lockMemory,
+                                     double bucketWidth, size_t numberOfBuckets)
+{
+    mPeriodNanoseconds = (period > 0.0) ? static_cast<int64_t>(period * 1.0e9 + 0.5) : 0;
+    mPriority = priority;
+    mCPU = cpu;
+    mLockMemory = lockMemory;
+    mBucketWidth = bucketWidth;
+    mHistogram.SetSize(std::max(numberOfBuckets, static_cast<size_t>(1)));
+    Reset();
+}
+
+bool mtsMaxonEPOSRealTime::SetupThread(std::string & error) const
+{
+    error.clear();
+#if (CISST_OS == CISST_LINUX)
+    if (mLockMemory && (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)) {
+        error += std::string("mlockall failed (") + std::strerror(errno) + ") ";
+    }
+    if (mCPU >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(mCPU, &cpus);
+        const int result = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (result != 0) {
+            error += "setting affinity to CPU " + std::to_string(mCPU) + " failed (" + std::strerror(result) + ") ";
+        }
+    }
+    if (mPriority > 0) {
+        sched_param parameters;
+        std::memset(&parameters, 0, sizeof(parameters));
+        parameters.sched_priority = mPriority;
+        const int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters);
+        if (result != 0) {
+            error += "setting SCHED_FIFO priority " + std::to_string(mPriority) + " failed ("
+                + std::strerror(result) + ") ";
+        }
+    }
+#else
+    if (mLockMemory || (mCPU >= 0) || (mPriority > 0)) {
+        error = "priority, affinity and memory locking are only supported on Linux ";
+    }
+#endif
+    return error.empty();
+}
+
+int64_t mtsMaxonEPOSRealTime::Now(void)
+{
+#if (CISST_OS == CISST_LINUX)
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<int64_t>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void mtsMaxonEPOSRealTime::SleepUntil(int64_t deadline)
+{
+#if (CISST_OS == CISST_LINUX)
+    timespec time;
+    time.tv_sec = static_cast<time_t>(deadline / 1000000000LL);
+    time.tv_nsec = static_cast<long>(deadline % 1000000000LL);
+    // restart if interrupted by a signal, the deadline is absolute
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &time, nullptr) == EINTR) {}
+#else
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deadline)));
+#endif
+}
+
+void mtsMaxonEPOSRealTime::Start(void)
+{
+    mDeadline = Now() + mPeriodNanoseconds;
+}
+
+void mtsMaxonEPOSRealTime::WaitForNextPeriod(void)
+{
+    if (!IsPeriodic()) {
+        return;
+    }
+    int64_t now = Now();
+    if (now > mDeadline) {
+        // Overrun, skip the deadlines already missed
+        mOverruns++;
+        mDeadline += ((now - mDeadline) / mPeriodNanoseconds) * mPeriodNanoseconds;
+    } else {
+        SleepUntil(mDeadline);
+        now = Now();
+    }
+    mJitter = static_cast<double>(now - mDeadline) * 1.0e-9;
+    mMaxJitter = std::max(mMaxJitter, mJitter);
+    const size_t bucket = std::min(static_cast<size_t>(mJitter / mBucketWidth), mHistogram.size() - 1);
+    mHistogram[bucket]++;
+    mDeadline += mPeriodNanoseconds;
+}
+
+void mtsMaxonEPOSRealTime::Reset(void)
+{
+    mHistogram.SetAll(0);
+    mJitter = 0.0;
+    mMaxJitter = 0.0;
+    mOverruns = 0;
+}
@@ -0,0 +1,192 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+  (C) Copyright 2024-2025 Johns Hopkins University (JHU)
+
+--- begin cisst license - do not edit ---
+This software is provided "as is" under an open source license, with no warranty.
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <sawMaxonEPOS/mtsMaxonEPOSTrajectoryFile.h>
+
+#if (CISST_OS == CISST_WINDOWS)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Prefetch granularity and read ahead, in bytes
+static const size_t PrefetchChunkSize = 4 * 1024 * 1024;
+static const size_t PrefetchChunksAhead = 2;
+
+mtsMaxonEPOSTrajectoryFile::mtsMaxonEPOSTrajectoryFile() :
+    mData(nullptr),
+    mSize(0),
+    mNumberOfAxes(0),
+    mNumberOfPoints(0),
+    mPointSize(0),
+    mPrefetchChunk(0)
+#if (CISST_OS == CISST_WINDOWS)
+    , mFile(nullptr),
+    mMapping(nullptr)
+#endif
+{}
+
+mtsMaxonEPOSTrajectoryFile::~mtsMaxonEPOSTrajectoryFile()
+{
+    Close();
+}
+
+bool mtsMaxonEPOSTrajectoryFile::Open(const std::string & fileName, std::string & error)
+{
+    Close();
+
+#if (CISST_OS == CISST_WINDOWS)
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "can't open " + fileName;
+        return false;
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    mSize = static_cast<size_t>(size.QuadPart);
+    HANDLE mapping = (mSize > 0) ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    if (!mapping) {
+        CloseHandle(file);
+        error = "can't map " + fileName;
+        return false;
+    }
+    mData = static_cast<const unsigned char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    mFile = file;
+    mMapping = mapping;
+#else
+    const int file = open(fileName.c_str(), O_RDONLY);
+    if (file < 0) {
+        error = "can't open " + fileName + " (" + std::strerror(errno) + ")";
+        return false;
+    }
+    struct stat status;
+    if ((fstat(file, &status) != 0) || (status.st_size == 0)) {
+        close(file);
+        error = "can't get size of " + fileName;
+        return false;
+    }
+    mSize = static_cast<size_t>(status.st_size);
+    void * data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, file, 0);
+    // the mapping keeps the file open
+    close(file);
+    if (data != MAP_FAILED) {
+        mData = static_cast<const unsigned char *>(data);
+        madvise(data, mSize, MADV_SEQUENTIAL);
+    }
+#endif
+    if (!mData) {
+        error = "can't map " + fileName;
+        Close();
+        return false;
+    }
+
+    // Header
+    if ((mSize < HEADER_SIZE) || (std::memcmp(mData, "EPOSTJ01", 8) != 0)) {
+        error = fileName + " is not a trajectory file (EPOSTJ01)";
+        Close();
+        return false;
+    }
+    uint32_t numberOfAxes;
+    uint64_t numberOfPoints;
+    std::memcpy(&numberOfAxes, mData + 8, sizeof(numberOfAxes));
+    std::memcpy(&numberOfPoints, mData + 16, sizeof(numberOfPoints));
+    mNumberOfAxes = numberOfAxes;
+    mNumberOfPoints = static_cast<size_t>(numberOfPoints);
+    mPointSize = (1 + mNumberOfAxes) * sizeof(double);
+    if ((mNumberOfAxes == 0) || (mNumberOfPoints == 0)
+        || ((mSize - HEADER_SIZE) / mPointSize < mNumberOfPoints)) {
+        error = fileName + " is truncated or empty (" + std::to_string(mNumberOfPoints) + " points of "
+            + std::to_string(mNumberOfAxes) + " axes, " + std::to_string(mSize) + " bytes)";
+        Close();
+        return false;
+    }
+    if (EndTime() < StartTime()) {
+        error = fileName + " times are not increasing";
+        Close();
+        return false;
+    }
+    mPrefetchChunk = static_cast<size_t>(-1);
+    Prefetch(0);
+    return true;
+}
+
+void mtsMaxonEPOSTrajectoryFile::Close(void)
+{
+#if (CISST_OS == CISST_WINDOWS)
+    if (mData) {
+        UnmapViewOfFile(mData);
+    }
+    if (mMapping) {
+        CloseHandle(static_cast<HANDLE>(mMapping));
+        mMapping = nullptr;
+    }
+    if (mFile) {
+        CloseHandle(static_cast<HANDLE>(mFile));
+        mFile = nullptr;
+    }
+#else
+    if (mData) {
+        munmap(const_cast<unsigned char *>(mData), mSize);
+    }
+#endif
+    mData = nullptr;
+    mSize = 0;
+    mNumberOfAxes = 0;
+    mNumberOfPoints = 0;
+}
+
+size_t mtsMaxonEPOSTrajectoryFile::Find(double time) const
+{
+    // first point after time
+    size_t low = 0;
+    size_t high = mNumberOfPoints;
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        if (Time(middle) <= time) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return (low > 0) ? (low - 1) : 0;
+}
+
+void mtsMaxonEPOSTrajectoryFile::Prefetch(size_t point)
+{
+    const size_t offset = HEADER_SIZE + point * mPointSize;
+    const size_t chunk = offset / PrefetchChunkSize;
+    if (!mData || (chunk == mPrefetchChunk)) {
+        return;
+    }
+#if (CISST_OS != CISST_WINDOWS)
+    unsigned char * data = const_cast<unsigned char *>(mData);
+    // read ahead, mapping start is page aligned and so are chunks
+    const size_t start = chunk * PrefetchChunkSize;
+    if (start < mSize) {
+        const size_t length = std::min(PrefetchChunksAhead * PrefetchChunkSize, mSize - start);
+        madvise(data + start, length, MADV_WILLNEED);
+    }
+    // release what has been played since the last call (everything before
+    // after a seek back), keep the previous chunk for small seeks back
+    const size_t released = ((mPrefetchChunk < chunk) && (mPrefetchChunk > 0)) ? (mPrefetchChunk - 1) : 0;
+    if (chunk > released + 1) {
+        madvise(data + released * PrefetchChunkSize, (chunk - 1 - released) * PrefetchChunkSize, MADV_DONTNEED);
+    }
+#endif
+    mPrefetchChunk = chunk;
+}
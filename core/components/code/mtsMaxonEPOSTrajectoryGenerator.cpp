@@ -0,0 +1,122 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+  (C) Copyright 2024-2025 Johns Hopkins University (JHU)
+
+--- begin cisst license - do not edit ---
+This software is provided "as is" under an open source license, with no warranty.
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include <sawMaxonEPOS/mtsMaxonEPOSTrajectoryGenerator.h>
+
+// Below this distance (units), and with the velocity and acceleration a
+// few jerk steps from 0, the axis is considered at its goal
+static const double GoalTolerance = 1.0;
+
+static double Sign(double value)
+{
+    return (value > 0.0) ? 1.0 : ((value < 0.0) ? -1.0 : 0.0);
+}
+
+mtsMaxonEPOSTrajectoryGenerator::mtsMaxonEPOSTrajectoryGenerator()
+{}
+
+void mtsMaxonEPOSTrajectoryGenerator::Configure(size_t numberOfAxes)
+{
+    mAxes.resize(numberOfAxes);
+    for (size_t axis = 0; axis < numberOfAxes; ++axis) {
+        SetLimits(axis, 1.0, 1.0, 1.0);
+        Reset(axis, 0.0);
+    }
+}
+
+void mtsMaxonEPOSTrajectoryGenerator::SetLimits(size_t axis, double velocity, double acceleration, double jerk)
+{
+    AxisState & state = mAxes[axis];
+    state.maxVelocity = velocity;
+    state.maxAcceleration = acceleration;
+    state.maxJerk = jerk;
+}
+
+void mtsMaxonEPOSTrajectoryGenerator::Reset(size_t axis, double position)
+{
+    AxisState & state = mAxes[axis];
+    state.goal = position;
+    state.position = position;
+    state.velocity = 0.0;
+    state.acceleration = 0.0;
+}
+
+void mtsMaxonEPOSTrajectoryGenerator::SetGoal(size_t axis, double goal)
+{
+    mAxes[axis].goal = goal;
+}
+
+bool mtsMaxonEPOSTrajectoryGenerator::Update(double dt)
+{
+    bool atGoal = true;
+    for (size_t axis = 0; axis < mAxes.size(); ++axis) {
+        if (!Step(mAxes[axis], dt)) {
+            atGoal = false;
+        }
+    }
+    return atGoal;
+}
+
+double mtsMaxonEPOSTrajectoryGenerator::BrakingVelocity(const AxisState & state, double distance)
+{
+    if (distance <= 0.0) {
+        return 0.0;
+    }
+    const double A = state.maxAcceleration;
+    const double J = state.maxJerk;
+    // Triangular deceleration if the maximum deceleration isn't reached
+    if (distance <= A * A * A / (J * J)) {
+        return std::pow(distance * std::sqrt(J), 2.0 / 3.0);
+    }
+    return -A * A / (2.0 * J) + std::sqrt(A * A * A * A / (4.0 * J * J) + 2.0 * A * distance);
+}
+
+bool mtsMaxonEPOSTrajectoryGenerator::Step(AxisState & state, double dt)
+{
+    const double J = state.maxJerk;
+    if ((std::abs(state.goal - state.position) < GoalTolerance)
+        && (std::abs(state.velocity) < 2.0 * J * dt * dt)
+        && (std::abs(state.acceleration) < 4.0 * J * dt)) {
+        state.position = state.goal;
+        state.velocity = 0.0;
+        state.acceleration = 0.0;
+        return true;
+    }
+    if (dt <= 0.0) {
+        return false;
+    }
+
+    // Predicted state once the acceleration is brought back to 0, looking
+    // one cycle ahead since the new jerk only applies from this cycle
+    const double position = state.position + state.velocity * dt + state.acceleration * dt * dt / 2.0;
+    const double velocity = state.velocity + state.acceleration * dt;
+    const double rampTime = std::abs(state.acceleration) / J;
+    const double rampVelocity = velocity + state.acceleration * rampTime / 2.0;
+    const double rampPosition = position + velocity * rampTime
+        + state.acceleration * rampTime * rampTime / 2.0
+        - Sign(state.acceleration) * J * rampTime * rampTime * rampTime / 6.0;
+
+    // Velocity target, then acceleration target that reaches 0 with the velocity
+    const double distance = state.goal - rampPosition;
+    const double targetVelocity = Sign(distance) * std::min(state.maxVelocity,
+                                                            BrakingVelocity(state, std::abs(distance)));
+    const double velocityError = targetVelocity - rampVelocity;
+    const double targetAcceleration = Sign(velocityError) * std::min(state.maxAcceleration,
+                                                                     std::sqrt(2.0 * J * std::abs(velocityError)));
+    const double jerk = std::max(-J, std::min(J, (targetAcceleration - state.acceleration) / dt));
+
+    state.position += state.velocity * dt + state.acceleration * dt * dt / 2.0 + jerk * dt * dt * dt / 6.0;
+    state.velocity += state.acceleration * dt + jerk * dt * dt / 2.0;
+    state.acceleration += jerk * dt;
+    return false;
+}
@@ -0,0 +1,104 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+  (C) Copyright 2024-2025 Johns Hopkins University (JHU)
+
+--- begin cisst license - do not edit ---
+This software is provided "as is" under an open source license, with no warranty.
+--- end cisst license ---
+*/
+
+#include <cmath>
+
+#include <cisstCommon/cmnConstants.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSVelocityEstimator.h>
+
+// Samples further apart restart the estimator (s)
+static const double MaximumSamplePeriod = 0.5;
+
+mtsMaxonEPOSVelocityEstimator::mtsMaxonEPOSVelocityEstimator() :
+    mType(FILTER),
+    mCutoff(20.0),
+    mProcessNoise(1.0e6),
+    mMeasurementNoise(1.0 / 12.0)
+{}
+
+void mtsMaxonEPOSVelocityEstimator::Configure(size_t numberOfAxes, Type type, double cutoff,
+                                              double processNoise, double measurementNoise)
+{
+    mType = type;
+    mCutoff = cutoff;
+    mProcessNoise = processNoise;
+    mMeasurementNoise = measurementNoise;
+    mAxes.resize(numberOfAxes);
+    for (size_t axis = 0; axis < numberOfAxes; ++axis) {
+        Reset(axis);
+        mAxes[axis].velocity = 0.0;
+    }
+}
+
+void mtsMaxonEPOSVelocityEstimator::Reset(size_t axis)
+{
+    mAxes[axis].initialized = false;
+}
+
+double mtsMaxonEPOSVelocityEstimator::Update(size_t axis, double position, double time)
+{
+    AxisState & state = mAxes[axis];
+    const double dt = time - state.time;
+    if (!state.initialized || (dt > MaximumSamplePeriod)) {
+        state.initialized = true;
+        state.time = time;
+        state.position = position;
+        state.velocity = 0.0;
+        // position known to the measurement noise, velocity unknown
+        state.covariance[0][0] = mMeasurementNoise;
+        state.covariance[0][1] = state.covariance[1][0] = 0.0;
+        state.covariance[1][1] = mProcessNoise * MaximumSamplePeriod;
+        return state.velocity;
+    }
+    if (dt <= 0.0) {
+        return state.velocity;
+    }
+    state.time = time;
+
+    if (mType == FILTER) {
+        const double raw = (position - state.position) / dt;
+        const double alpha = 1.0 - std::exp(-2.0 * cmnPI * mCutoff * dt);
+        state.velocity += alpha * (raw - state.velocity);
+        state.position = position;
+        return state.velocity;
+    }
+
+    // Kalman predict, constant velocity with white noise acceleration
+    double (&P)[2][2] = state.covariance;
+    state.position += state.velocity * dt;
+    const double dt2 = dt * dt;
+    const double p00 = P[0][0] + dt * (P[1][0] + P[0][1]) + dt2 * P[1][1] + mProcessNoise * dt2 * dt / 3.0;
+    const double p01 = P[0][1] + dt * P[1][1] + mProcessNoise * dt2 / 2.0;
+    const double p11 = P[1][1] + mProcessNoise * dt;
+    // update with position measurement
+    const double innovation = position - state.position;
+    const double s = p00 + mMeasurementNoise;
+    const double k0 = p00 / s;
+    const double k1 = p01 / s;
+    state.position += k0 * innovation;
+    state.velocity += k1 * innovation;
+    P[0][0] = (1.0 - k0) * p00;
+    P[0][1] = P[1][0] = (1.0 - k0) * p01;
+    P[1][1] = p11 - k1 * p01;
+    return state.velocity;
+}
+
+bool mtsMaxonEPOSVelocityEstimator::TypeFromString(const std::string & name, Type & type)
+{
+    if (name == "filter") {
+        type = FILTER;
+        return true;
+    }
+    if (name == "kalman") {
+        type = KALMAN;
+        return true;
+    }
+    return false;
+}
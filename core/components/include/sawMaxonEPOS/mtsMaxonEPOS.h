@@ -18,24 +18,42 @@ http://www.cisst.org/cisst/license.txt.
 #ifndef _mtsGalilEPOS_h
 #define _mtsGalilEPOS_h
 
+#include <functional>
 #include <string>
 #include <cstdint>
 
 #include <cisstCommon/cmnPath.h>
 #include <cisstVector/vctDynamicVectorTypes.h>
+#include <cisstVector/vctDynamicMatrixTypes.h>
 #include <cisstMultiTask/mtsTaskContinuous.h>
 #include <cisstMultiTask/mtsInterfaceProvided.h>
 #include <cisstParameterTypes/prmConfigurationJoint.h>
 #include <cisstParameterTypes/prmStateJoint.h>
 #include <cisstParameterTypes/prmPositionJointSet.h>
 #include <cisstParameterTypes/prmVelocityJointSet.h>
+#include <cisstParameterTypes/prmForceTorqueJointSet.h>
 #include <cisstParameterTypes/prmPositionCartesianGet.h>
+#include <cisstParameterTypes/prmPositionCartesianSet.h>
 #include <cisstParameterTypes/prmOperatingState.h>
 #include <cisstParameterTypes/prmActuatorState.h>
 
+#include <sawMaxonEPOS/mtsMaxonEPOSDataRecorder.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSErrorReporter.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSFlightRecorder.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSKinematics.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSObjectDictionary.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSPoller.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSRealTime.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSTrajectoryFile.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSTrajectoryGenerator.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSVelocityEstimator.h>
+
 // Always include last
 #include <sawMaxonEPOS/sawMaxonEPOSExport.h>
 
+class mtsMaxonEPOSDriver;
+class mtsMaxonEPOSDriverTimed;
+
 class CISST_EXPORT mtsMaxonEPOS : public mtsTaskContinuous
 {
     CMN_DECLARE_SERVICES(CMN_DYNAMIC_CREATION_ONEARG, CMN_LOG_LOD_RUN_ERROR)
@@ -59,21 +77,84 @@ protected:
     // Path to configuration files
     cmnPath mConfigPath;
 
-    // Structure for robot data
-    struct RobotData {
-        std::string   name;                     // Robot name (from config file)
+    // EPOS driver backend, created from the configuration file, wrapped
+    // to record the latency of each call
+    mtsMaxonEPOSDriver *mDriver;
+    mtsMaxonEPOSDriverTimed *mTimedDriver;
+
+    // Latency statistics, one row per call type and axis (the last "axis"
+    // is for calls addressed to the bus): count, p50, p99 and max (s)
+    void GetLatencyStatistics(vctDoubleMat & statistics) const;
+    void GetLatencyStatisticsNames(std::vector<std::string> & names) const;
+    void ResetLatencyStatistics(void);
+
+    // Polling of the axes in Run
+    std::string mPollingMode;
+    mtsMaxonEPOSPoller mPoller;
+    double mPollingTime;                        // Time spent reading all axes (s)
+    double mPollingWaitTime;                    // Part of it spent waiting for polling threads (s)
+
+    // Optional periodic execution of Run, with priority, affinity and
+    // jitter statistics
+    mtsMaxonEPOSRealTime mRealTime;
+
+    // Flight recorder, samples recorded at each Run and saved on fault
+    mtsMaxonEPOSFlightRecorder mFlightRecorder;
+    std::vector<mtsMaxonEPOSFlightRecorder::AxisSample> mFlightRecorderAxes;
+    std::string mFlightRecorderDirectory;
+    void RecordFlightRecorder(double time);
+    void DumpFlightRecorder(void);
+
+    // Startup sequence, nodes are polled until ready instead of waiting
+    // a fixed time after each NMT command
+    bool mStartupResetNodes;                    // NMT reset, otherwise only enter pre-operational
+    double mStartupBootDelay;                   // Wait after reset before polling (s)
+    double mStartupTimeout;                     // Maximum wait for each phase (s)
+    double mStartupPollPeriod;                  // (s)
+    std::vector<std::string> mStartupPhases;
+    vctDoubleVec mStartupTimes;                 // Duration of each phase (s)
+    void GetStartupTimes(vctDoubleVec & times) const;
+    void GetStartupPhases(std::vector<std::string> & phases) const;
+    // Poll ready until it returns true, false after the startup timeout
+    bool WaitUntilReady(const std::function<bool (void)> & ready) const;
+
+    // Object dictionary access for all axes (node index is the global
+    // axis index), static parameters are read at startup and optionally
+    // cached in a file keyed by node serial number
+    mtsMaxonEPOSObjectDictionary mObjectDictionary;
+    std::vector<mtsMaxonEPOSObjectDictionary::Object> mStaticObjects;
+    std::string mObjectDictionaryCacheFile;     // Empty if no file cache
+    void GetStaticParameterNames(std::vector<std::string> & names) const;
+
+    // Gateways, one per interface (e.g. USB port or CAN channel), each
+    // gateway is the first node of a CAN bus and the other nodes of the bus
+    // are reached through it
+    struct GatewayData {
+        std::string   name;                     // Gateway name (from config file)
         std::string   deviceName;
         std::string   protocolStackName;
         std::string   interfaceName;
         std::string   portName;
-        
         unsigned int  baudrate;
-        unsigned int  mTimeout;                 // Timeout
+        unsigned int  timeout;                  // Protocol stack timeout (ms)
+        void *        handle;                   // Device handle, nullptr until Startup
+        bool          sendSync;                 // At least one PDO on this bus uses synchronous transmission
+        bool          syncPending;              // Synchronized move_jp staged, SYNC sent by the next Run
+        double        syncTime;                 // When the last move SYNC was sent, relative to the first one (s)
+    };
+    std::vector<GatewayData> mGateways;
+
+    // Structure for robot data
+    struct RobotData {
+        std::string   name;                     // Robot name (from config file)
 
         unsigned int  mNumAxes;                 // Number of axes
+        size_t        mFirstAxis;               // Index of axis 0 in the component (flight recorder, statistics)
 
         prmStateJoint m_measured_js;            // Measured joint state (CRTK)
         prmStateJoint m_setpoint_js;            // Setpoint joint state (CRTK)
+        prmPositionCartesianGet m_measured_cp;  // Measured tip pose (CRTK), if kinematics are configured
+        mtsMaxonEPOSKinematics mKinematics;
         vctDoubleVec offset_js;                 // read offset for zero.
         
         prmOperatingState m_op_state;           // Operating state (CRTK)
@@ -83,6 +164,7 @@ protected:
         prmActuatorState mActuatorState;        // Actuator state
 
         vctUIntVec    mAxisToNodeIDMap;         // Map from axis number to nodeID
+        vctUIntVec    mAxisToGateway;           // Map from axis number to gateway index
 
         vctUIntVec    mState;                   // Internal axis state machine
         
@@ -91,18 +173,230 @@ protected:
         unsigned int  mErrorCode;               // Indicates that an error occurred last iteration
 
         mtsMaxonEPOS *mParent;            // Pointer to parent object
+        mtsMaxonEPOSDriver *mDriver;      // EPOS driver backend (owned by parent)
 
         std::vector<void*> mHandles;
 
+        // Signals read from each axis, each one at its own rate
+        enum { SIGNAL_STATE = 0, SIGNAL_POSITION, SIGNAL_CURRENT, NUMBER_OF_SIGNALS };
+        unsigned int  mReadPeriod[NUMBER_OF_SIGNALS];   // Read every N cycles
+        unsigned long long mCycle;                     // Run cycles since Startup
+        vctDoubleMat  mFeedbackTime;            // Time of last read (s), one row per axis, one column per signal
+        vctDoubleMat  mFeedbackAge;             // Age of last read (s), same layout
+
+        // Position sample times (steady clock, s), the last two samples of
+        // each axis are kept to build the time aligned joint state: all
+        // axes interpolated (or extrapolated with the estimated velocity)
+        // to the earliest or latest sample time of the cycle
+        enum Alignment { ALIGN_NONE, ALIGN_EARLIEST, ALIGN_LATEST };
+        Alignment     mAlignment;
+        vctDoubleVec  mPositionTimes;           // Time of each axis' last position sample
+        vctDoubleVec  mPreviousPositionTimes;
+        vctDoubleVec  mRawPositions;            // Last two samples, before offset_js
+        vctDoubleVec  mPreviousRawPositions;
+        prmStateJoint m_measured_js_aligned;    // Positions and velocities at mAlignedTime
+        double        mAlignedTime;             // Reference time (steady clock, s)
+
+        // Called from UpdateFeedback after the new samples
+        void UpdateAlignedState(void);
+
+        // Select the signals to read this cycle, slow signals are spread
+        // across cycles so each cycle has about the same number of reads
+        void ScheduleReads(void);
+
+        // Feedback read from one axis, filled by ReadAxis
+        struct AxisFeedback {
+            unsigned int   requested;           // Signals to read, bit mask (1 << SIGNAL_xxx)
+            unsigned int   received;            // Signals read
+            mtsMaxonEPOSDriver::Call failedCall; // First failed call, NUMBER_OF_CALLS if none
+            unsigned int   errorCode;
+            unsigned short opState;
+            int            position;
+            double         positionTime;        // Steady clock time of the position read (s)
+            short          current;
+        };
+        std::vector<AxisFeedback> mFeedback;
+
+        // Errors of the cyclic calls, reported as periodic summaries
+        mtsMaxonEPOSErrorReporter mErrors;
+        std::string   mErrorSummary;
+
+        // Error counters, same layout as the latency statistics, copied
+        // from mErrors by Run when they change so clients read them from
+        // the state table
+        vctDoubleVec  mErrorCounters;
+        unsigned int  mErrorCountersTotal;
+        void ResetErrorCounters(void);
+
+        // Servo commands, when coalescing only the last servo_jp, servo_jv
+        // or servo_jf queued during a cycle is sent
+        enum ServoCommand { SERVO_NONE, SERVO_JP, SERVO_JV, SERVO_JF };
+        bool          mServoCoalesce;
+        int           mServoPositionDeadband;   // quadcounts
+        int           mServoVelocityDeadband;   // rpm
+        int           mServoCurrentDeadband;    // mA
+        ServoCommand  mServoPending;
+        vctDoubleVec  mServoPendingGoal;
+        vctIntVec     mServoSent;               // Last setpoint sent, per axis
+        vctBoolVec    mServoSentValid;          // Reset on mode change and enable
+        unsigned int  mServoDropped;            // Servo commands superseded before being sent
+        vctUIntVec    mServoSkipped;            // Per axis writes skipped (deadband)
+
+        // move_jp synchronization: with MOVE_SYNC_CONTROLWORD or
+        // MOVE_SYNC_SYNC the targets are staged on all axes first (SDO),
+        // then started by one controlword RxPDO frame received by all the
+        // nodes of a bus, or by one synchronous RxPDO per node applied at
+        // the next SYNC.  Profiles can be scaled so all axes arrive together.
+        enum MoveSynchronization { MOVE_SYNC_NONE, MOVE_SYNC_CONTROLWORD, MOVE_SYNC_SYNC };
+        MoveSynchronization mMoveSynchronization;
+        unsigned short mMoveRxPDO;              // RxPDO number, 1 to 4
+        unsigned short mMoveCobId;              // COB-ID shared by all nodes for MOVE_SYNC_CONTROLWORD
+        bool          mMoveScaleProfiles;
+        vctDoubleVec  mCountsPerTurn;           // Encoder quadcounts per motor turn, to scale profiles
+        vctDoubleMat  mMoveProfile;             // Profile used by the last move, scaled or not
+        vctDoubleVec  mMoveStartTimes;          // Start command of each axis, relative to the first one (s)
+        double        mMoveSkew;                // Last move, latest minus earliest start (s)
+        bool          mMoveStartPending;        // MOVE_SYNC_SYNC, start at the next Run's SYNC
+
+        // Map the controlword in the RxPDO used to start moves (node must be pre-operational)
+        bool ConfigureMoveRxPDO(size_t axis);
+        // Scale mMoveProfile so all axes reach the goal at the same time
+        bool ScaleMoveProfiles(const vctDoubleVec & goal);
+        // Start the staged moves and record the start times; with
+        // MOVE_SYNC_SYNC the moves start at the SYNC sent by the next Run
+        bool TriggerMove(void);
+        // Called by Run once the SYNC started the staged moves
+        void UpdateMoveStartTimes(void);
+        // Replace the staged start controlword so the next SYNC doesn't
+        // start the moves, 0x000F to stay enabled or 0x0006 to disable
+        void CancelMove(unsigned short controlword);
+
+        // Velocity estimated from the positions, InMotion above threshold
+        mtsMaxonEPOSVelocityEstimator mVelocityEstimator;
+        double        mInMotionThreshold;       // quadcounts/s
+
+        // Optional TxPDO used for cyclic feedback instead of SDO reads
+        struct AxisPDO {
+            bool           enabled;
+            unsigned short number;              // TxPDO number, 1 to 4
+            unsigned short cobId;
+            unsigned char  transmissionType;    // 1-240: synchronous, 254/255: event driven
+            unsigned short inhibitTime;         // 100 us
+            unsigned short eventTimer;          // ms
+            unsigned int   timeout;             // ReadCANFrame timeout (ms)
+            std::vector<unsigned int> mapping;  // Mapped objects: index << 16 | subindex << 8 | bits
+        };
+        std::vector<AxisPDO> mPDO;
+
+        // Write the TxPDO communication and mapping parameters of one axis (node must be pre-operational)
+        bool ConfigurePDO(size_t axis);
+        // Write one object through the object dictionary, skipped if the node already has the value
+        bool WriteObject(size_t axis, unsigned short index, unsigned char subIndex, unsigned int value, unsigned int size);
+
+        // Interpolated Position Mode (IPM) streaming: PVT points are queued
+        // on the host by ipm_add_points and transferred to the drives'
+        // buffers in Run, the drives interpolate between points
+        vctDoubleMat  mIpmQueue;                // Ring buffer, one row per point: time (ms), positions, velocities (rpm)
+        size_t        mIpmQueueHead;
+        unsigned int  mIpmQueueCount;           // Points queued on host
+        unsigned int  mIpmStartLevel;           // Points in drive buffers before starting the trajectory
+        unsigned short mIpmUnderflowWarningLimit;
+        unsigned int  mIpmMaxBufferSize;        // Drive buffer size
+        bool          mIpmStarted;
+        vctUIntVec    mIpmBufferFill;           // Points in each drive's buffer
+        vctUIntVec    mIpmUnderflows;           // Number of buffer underflows per axis
+
+        // Queue PVT points, switches to IPM if needed
+        void ipm_add_points(const vctDoubleMat & points);
+        // Stop the trajectory and flush host queue and drive buffers
+        void ipm_stop(void);
+        // Called from Run: transfer queued points, start trajectory and check buffer status
+        void UpdateIPM(void);
+        // Number of axes in IPM, all of them unless an activation failed part way
+        size_t NumberOfAxesInIpm(void) const;
+
+        // Trajectory playback: setpoints read from a memory mapped file
+        // (see mtsMaxonEPOSTrajectoryFile) and sent from Run using position
+        // mode, interpolated at the trajectory time of each cycle
+        mtsMaxonEPOSTrajectoryFile mPlayback;
+        bool          mPlaybackPlaying;
+        double        mPlaybackTime;            // Trajectory time from first point (s)
+        double        mPlaybackRate;            // 1 for real time
+        double        mPlaybackLastUpdate;      // Run time of last update (s)
+        size_t        mPlaybackPoint;           // Last point before mPlaybackTime
+        double        mPlaybackProgressPeriod;  // Period of progress events (s)
+        double        mPlaybackLastProgress;
+        prmPositionJointSet mPlaybackSetpoint;
+        mtsFunctionWrite playback_progress;     // Event, trajectory time (s)
+
+        void playback_load(const std::string & fileName);
+        void playback_play(void);
+        void playback_pause(void);
+        void playback_seek(const double & time);
+        void playback_rate(const double & rate);
+        // Called from Run when playing, now is the Run time (s)
+        void UpdatePlayback(double now);
+
+        // Interpolation of sparse goals (interpolate_jp): jerk limited
+        // setpoints computed in Run and sent using position mode.  A new
+        // goal replans from the current setpoints, other motion commands
+        // stop the interpolation.
+        mtsMaxonEPOSTrajectoryGenerator mInterpolation;
+        bool          mInterpolating;
+        double        mInterpolationLastUpdate; // Run time of last update (s), negative before first
+        prmPositionJointSet mInterpolationSetpoint;
+
+        void interpolate_jp(const prmPositionJointSet & jtpos);
+        // Called from Run when interpolating, now is the Run time (s)
+        void UpdateInterpolation(double now);
+
+        // Drive data recorder captures, configured, polled and uploaded
+        // by a worker thread so the cyclic reads are not delayed
+        mtsMaxonEPOSDataRecorder mDataRecorder;
+        Json::Value   mDataRecorderConfig;      // Initial settings, applied at startup
+        vctDoubleMat  mDataRecorderData;        // Last upload, sent with data_recorder_uploaded
+        mtsFunctionWrite data_recorder_uploaded; // Event, uploaded samples
+
+        void data_recorder_configure(const std::string & settings);
+        void data_recorder_start(void);
+        void data_recorder_trigger(void);
+        void data_recorder_stop(void);
+        void GetDataRecorderData(vctDoubleMat & data) const;
+        void GetDataRecorderColumns(std::vector<std::string> & names) const;
+        void GetDataRecorderState(std::string & state) const;
+        // Called from Run, sends the upload event and errors
+        void UpdateDataRecorder(void);
+
+        // Read the requested signals of one axis (thread safe w.r.t. other axes),
+        // mapped signals are read from the TxPDO, others using SDO
+        void ReadAxis(size_t axis);
+
+        // Called from Run after polling: update the measured state from the
+        // feedback read, stream IPM points and playback, compute newState
+        void UpdateFeedback(double now);
+
         // Move joint to specified position
         //  servo_jp:  uses Position Tracking mode (PT)
         //  move_jp:  uses Independent Axis Positioning mode (PA, BG)
         void servo_jp(const prmPositionJointSet &jtpos);
         void move_jp(const prmPositionJointSet &jtpos);
+        // Move tip to specified pose, inverse kinematics solved in the
+        // component then sent as servo_jp or move_jp (only with kinematics)
+        void servo_cp(const prmPositionCartesianSet &cppos);
+        void move_cp(const prmPositionCartesianSet &cppos);
         // Move joint to specified relative position
         void servo_jr(const prmPositionJointSet &jtpos);
         // Move joint at specified velocity
         void servo_jv(const prmVelocityJointSet &jtvel);
+        // Apply specified motor current (mA), uses Current Mode (CM)
+        void servo_jf(const prmForceTorqueJointSet &jtf);
+        // Send servo setpoints to the drives, per axis writes are skipped
+        // within the deadband of the last value sent
+        void SendServoJp(const vctDoubleVec & goal);
+        void SendServoJv(const vctDoubleVec & goal);
+        void SendServoJf(const vctDoubleVec & goal);
+        // Called from Run after the queued commands when coalescing
+        void SendPendingServo(void);
         // Hold joint at current position (Stop)
         void hold(void);
 
@@ -116,17 +410,59 @@ protected:
 
         bool CheckStateEnabled(const char *cmdName) const;
 
+        // Inverse kinematics for servo_cp and move_cp.  servo_cp starts
+        // from the last solution if recent, otherwise from the measured
+        // joints.  Statistics: solves, converged, stalled, iterations
+        // limit, budget limit, iterations (last, mean, max) and solve time
+        // (s, last, mean, max)
+        enum { IK_SOLVES = 0, IK_CONVERGED, IK_STALLED, IK_ITERATIONS_LIMIT, IK_BUDGET_LIMIT,
+               IK_LAST_ITERATIONS, IK_MEAN_ITERATIONS, IK_MAX_ITERATIONS,
+               IK_LAST_TIME, IK_MEAN_TIME, IK_MAX_TIME, NUMBER_OF_IK_STATISTICS };
+        double        mIKJoints[mtsMaxonEPOSKinematics::NUMBER_OF_JOINTS];
+        double        mIKLastSolve;             // s, to warm start servo_cp
+        double        mIKResidual;
+        prmPositionJointSet mIKGoal;            // Solution in quadcounts
+        vctDoubleVec  mIKStatistics;
+
+        // Solve for goal and set mIKGoal, budget as in mtsMaxonEPOSKinematics::InverseKinematics
+        mtsMaxonEPOSKinematics::Status SolveIK(const vctFrm3 & goal, bool warmStart, double budget);
+        void ResetIKStatistics(void);
+
         // Set this point as home.
         void SetHome(void);
 
+        // Profile position mode parameters, one row per axis: velocity
+        // (rpm), acceleration and deceleration (rpm/s), 0 keeps the drive's
+        // value.  The last values written to each node are cached so only
+        // changed parameters are written.
+        enum { PROFILE_VELOCITY = 0, PROFILE_ACCELERATION, PROFILE_DECELERATION, NUMBER_OF_PROFILE_PARAMETERS };
+        vctDoubleMat  mProfile;                 // Requested, written values are cached in mObjectDictionary
+
         void SetPositionProfile(const vctDoubleVec & profileVelocity, const vctDoubleVec & profileAcceleration, const vctDoubleVec & profileDeceleration);
+        void configure_profile(const vctDoubleMat & profile);
+        // Write the parameters (mProfile or mMoveProfile) that differ from the cache (SDO)
+        bool WriteProfile(size_t axis, const vctDoubleMat & profile);
+
+        // Static parameters read at startup, one row per axis, one column
+        // per object (see static_parameter_names), NaN if not available
+        vctDoubleMat  mStaticParameters;
+        void GetStaticParameters(vctDoubleMat & parameters) const;
+    };
+    std::vector<RobotData *> mRobots;
+
+    // All axes of all robots, in configuration order
+    struct AxisReference {
+        RobotData *   robot;
+        size_t        axis;                     // Axis index in robot
     };
-    RobotData mRobot;
+    std::vector<AxisReference> mAxes;
 
     void Init();
     void Close();
 
-    void SetupInterfaces();
+    void ConfigureRobot(RobotData & robot, const Json::Value & jsonConfig);
+    void SetupInterfaces(RobotData & robot);
+    void SetupPolling();
 };
 
 CMN_DECLARE_SERVICES_INSTANTIATION(mtsMaxonEPOS)
@@ -0,0 +1,147 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+
+  (C) Copyright 2025 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsMaxonEPOSDataRecorder_h
+#define _mtsMaxonEPOSDataRecorder_h
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <json/json.h>
+
+#include <cisstVector/vctDynamicMatrixTypes.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSDriver.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSObjectDictionary.h>
+
+// Always include last
+#include <sawMaxonEPOS/sawMaxonEPOSExport.h>
+
+// Captures with the drives' own data recorder: each axis samples up to 4
+// objects at the drive's rate, the buffers are uploaded in bulk once the
+// recorders stop (buffer full or Stop).  All the EPOS calls are made by a
+// worker thread, requests only queue work so neither the commands nor
+// Run wait for the transfers; Run picks up the results with Poll.
+//
+// Settings (see Configure), each axis keeps the last settings it was
+// configured with:
+//   {
+//       "axes": [0, 1],               // axes to configure, default all
+//       "enabled": true,              // false to leave these axes out of the captures
+//       "sampling_period": 1,         // recorder time base multiples
+//       "preceding_samples": 0,       // kept before the trigger
+//       "trigger": ["movement_start"],// movement_start, movement_end, error, digital_input;
+//                                     // none to start on Start
+//       "channels": [{"name": "position", "index": "0x6064", "size": 4}],
+//       "poll_period": 0.05,          // s, recorder state polling while capturing
+//       "file": ""                    // CSV file written after each upload
+//   }
+// Channels are objects as in mtsMaxonEPOSObjectDictionary, with "signed"
+// (default true).
+//
+// Uploaded data: one row per sample, one column per axis and channel
+// (axes in order), NaN past the end of shorter captures.
+class CISST_EXPORT mtsMaxonEPOSDataRecorder
+{
+public:
+
+    enum { MAXIMUM_CHANNELS = 4 };
+    enum State { IDLE, CONFIGURING, CONFIGURED, CAPTURING, UPLOADING, READY, FAILED };
+    enum Event { EVENT_NONE, EVENT_UPLOADED, EVENT_FAILED };
+
+    struct Channel {
+        mtsMaxonEPOSObjectDictionary::Object object;
+        bool isSigned;
+    };
+
+    struct AxisSettings {
+        bool enabled;
+        unsigned short samplingPeriod;
+        unsigned short precedingSamples;
+        unsigned char triggers;         // mask of mtsMaxonEPOSDriver::TRIGGER_*
+        std::vector<Channel> channels;
+    };
+
+    mtsMaxonEPOSDataRecorder();
+    ~mtsMaxonEPOSDataRecorder();
+
+    // Driver and axes, before Start
+    void SetAxes(mtsMaxonEPOSDriver * driver, const std::vector<void *> & handles,
+                 const std::vector<unsigned short> & nodeIds);
+
+    // Worker thread
+    void Start(void);
+    void Stop(void);
+
+    // Requests, return false (with error) if they can't be queued
+    bool Configure(const Json::Value & jsonConfig, std::string & error);
+    bool Capture(std::string & error);
+    bool Trigger(std::string & error);
+    bool Finish(std::string & error);
+
+    // Called from Run, returns the last event (once) and its message
+    Event Poll(std::string & message);
+
+    State GetState(void) const;
+    static const char * StateName(State state);
+    void GetData(vctDoubleMat & data) const;
+    void GetColumnNames(std::vector<std::string> & names) const;
+
+protected:
+    enum Request { REQUEST_NONE, REQUEST_CONFIGURE, REQUEST_CAPTURE, REQUEST_TRIGGER, REQUEST_FINISH };
+
+    void Worker(void);
+    bool ExecuteConfigure(const std::vector<AxisSettings> & settings, std::string & error);
+    bool ExecuteCapture(std::string & error);
+    bool ExecuteTrigger(std::string & error);
+    bool ExecuteFinish(std::string & error);
+    bool IsCaptureDone(bool & done, std::string & error);
+    // Read the recorded samples of all the enabled axes into mData
+    bool Upload(size_t & numberOfSamples, std::string & error);
+    bool WriteFile(const std::string & fileName, std::string & error) const;
+    std::string CallError(size_t axis, mtsMaxonEPOSDriver::Call call, unsigned int errorCode) const;
+
+    mtsMaxonEPOSDriver * mDriver;
+    std::vector<void *> mHandles;
+    std::vector<unsigned short> mNodeIds;
+
+    // Protected by mMutex
+    mutable std::mutex mMutex;
+    std::condition_variable mCondition;
+    State mState;
+    std::deque<Request> mRequests;
+    bool mStopRequested;
+    bool mConfigured;                   // last configuration succeeded
+    std::vector<AxisSettings> mPendingSettings;
+    std::chrono::duration<double> mPollPeriod;
+    std::string mFileName;
+    Event mEvent;
+    std::string mEventMessage;
+    vctDoubleMat mData;
+    std::vector<std::string> mColumnNames;
+
+    // Worker thread only
+    std::vector<AxisSettings> mSettings;  // applied to the drives
+
+    std::thread mThread;
+};
+
+#endif
@@ -0,0 +1,242 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+
+  (C) Copyright 2025 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsMaxonEPOSDriver_h
+#define _mtsMaxonEPOSDriver_h
+
+#include <string>
+
+#include <json/json.h>
+
+#include <cisstCommon/cmnPortability.h>
+
+// Always include last
+#include <sawMaxonEPOS/sawMaxonEPOSExport.h>
+
+// Abstract interface to the EPOS command set.
+//
+// The methods mirror the VCS_* functions of the Maxon EPOS Command Library
+// (EposCmdLib), with the same semantics: they return true on success and
+// set errorCode (EPOS error code) on failure.  The handles are opaque and
+// only need to be valid for the driver that created them.
+//
+// Available backends (selected with "backend" in the JSON configuration):
+//   "EposCmdLib"  wraps the Maxon library (default, requires the Maxon SDK)
+//   "simulated"   in-process simulation of the nodes, see mtsMaxonEPOSDriverSimulated
+//   "replay"      replay of a recorded session, see mtsMaxonEPOSDriverReplay
+class CISST_EXPORT mtsMaxonEPOSDriver
+{
+public:
+
+    // Interpolated position mode status, see VCS_GetIpmStatus
+    struct IpmStatus {
+        bool trajectoryRunning;
+        bool underflowWarning;
+        bool overflowWarning;
+        bool velocityWarning;
+        bool accelerationWarning;
+        bool underflowError;
+        bool overflowError;
+        bool velocityError;
+        bool accelerationError;
+    };
+
+    // Driver calls, to identify calls in statistics and logs
+    enum Call {
+        CALL_OPEN_DEVICE,
+        CALL_OPEN_SUB_DEVICE,
+        CALL_CLOSE_SUB_DEVICE,
+        CALL_CLOSE_DEVICE,
+        CALL_GET_PROTOCOL_STACK_SETTINGS,
+        CALL_SET_PROTOCOL_STACK_SETTINGS,
+        CALL_SEND_NMT_SERVICE,
+        CALL_CLEAR_FAULT,
+        CALL_GET_FAULT_STATE,
+        CALL_GET_ENABLE_STATE,
+        CALL_SET_ENABLE_STATE,
+        CALL_SET_DISABLE_STATE,
+        CALL_GET_STATE,
+        CALL_GET_POSITION_IS,
+        CALL_GET_CURRENT_IS,
+        CALL_ACTIVATE_PROFILE_POSITION_MODE,
+        CALL_ACTIVATE_POSITION_MODE,
+        CALL_ACTIVATE_VELOCITY_MODE,
+        CALL_ACTIVATE_CURRENT_MODE,
+        CALL_ACTIVATE_INTERPOLATED_POSITION_MODE,
+        CALL_SET_POSITION_PROFILE,
+        CALL_MOVE_TO_POSITION,
+        CALL_HALT_POSITION_MOVEMENT,
+        CALL_HALT_VELOCITY_MOVEMENT,
+        CALL_SET_POSITION_MUST,
+        CALL_SET_VELOCITY_MUST,
+        CALL_SET_CURRENT_MUST,
+        CALL_SET_IPM_BUFFER_PARAMETER,
+        CALL_GET_IPM_BUFFER_PARAMETER,
+        CALL_CLEAR_IPM_BUFFER,
+        CALL_GET_FREE_IPM_BUFFER_SIZE,
+        CALL_ADD_PVT_VALUE_TO_IPM_BUFFER,
+        CALL_START_IPM_TRAJECTORY,
+        CALL_STOP_IPM_TRAJECTORY,
+        CALL_GET_IPM_STATUS,
+        CALL_GET_OBJECT,
+        CALL_SET_OBJECT,
+        CALL_SET_RECORDER_PARAMETER,
+        CALL_ENABLE_TRIGGER,
+        CALL_DISABLE_ALL_TRIGGERS,
+        CALL_ACTIVATE_CHANNEL,
+        CALL_DEACTIVATE_ALL_CHANNELS,
+        CALL_START_RECORDER,
+        CALL_STOP_RECORDER,
+        CALL_FORCE_TRIGGER,
+        CALL_IS_RECORDER_RUNNING,
+        CALL_READ_CHANNEL_VECTOR_SIZE,
+        CALL_READ_CHANNEL_DATA_VECTOR,
+        CALL_READ_CAN_FRAME,
+        CALL_SEND_CAN_FRAME,
+        NUMBER_OF_CALLS
+    };
+
+    // Name of the call, VCS_ function name without prefix
+    static const char * CallName(Call call);
+
+    // Description of an EPOS error code (communication, library, interface
+    // and protocol errors, see EPOS Command Library documentation)
+    static const char * ErrorDescription(unsigned int errorCode);
+
+    virtual ~mtsMaxonEPOSDriver() {}
+
+    // Create the driver selected by "backend" in jsonConfig and configure it;
+    // returns nullptr if the backend is unknown or not compiled in.
+    static mtsMaxonEPOSDriver * Create(const Json::Value & jsonConfig);
+
+    // Backend name, as used in the JSON configuration
+    virtual std::string GetBackendName(void) const = 0;
+
+    // Backend specific configuration (whole component JSON configuration)
+    virtual bool Configure(const Json::Value & CMN_UNUSED(jsonConfig)) { return true; }
+
+    // Communication
+    virtual void * OpenDevice(const std::string & deviceName, const std::string & protocolStackName,
+                              const std::string & interfaceName, const std::string & portName,
+                              unsigned int & errorCode) = 0;
+    virtual void * OpenSubDevice(void * deviceHandle, const std::string & deviceName,
+                                 const std::string & protocolStackName, unsigned int & errorCode) = 0;
+    virtual bool CloseSubDevice(void * handle, unsigned int & errorCode) = 0;
+    virtual bool CloseDevice(void * handle, unsigned int & errorCode) = 0;
+    virtual bool GetProtocolStackSettings(void * handle, unsigned int & baudrate, unsigned int & timeout,
+                                          unsigned int & errorCode) = 0;
+    virtual bool SetProtocolStackSettings(void * handle, unsigned int baudrate, unsigned int timeout,
+                                          unsigned int & errorCode) = 0;
+    virtual bool SendNMTService(void * handle, unsigned short nodeId, unsigned short commandSpecifier,
+                                unsigned int & errorCode) = 0;
+
+    // State machine
+    virtual bool ClearFault(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+    virtual bool GetFaultState(void * handle, unsigned short nodeId, bool & isFault, unsigned int & errorCode) = 0;
+    virtual bool GetEnableState(void * handle, unsigned short nodeId, bool & isEnabled, unsigned int & errorCode) = 0;
+    virtual bool SetEnableState(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+    virtual bool SetDisableState(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+    // State: 0 = disabled, 1 = enabled, 2 = quickstop, 3 = fault
+    virtual bool GetState(void * handle, unsigned short nodeId, unsigned short & state, unsigned int & errorCode) = 0;
+
+    // Motion info
+    virtual bool GetPositionIs(void * handle, unsigned short nodeId, int & position, unsigned int & errorCode) = 0;
+    virtual bool GetCurrentIs(void * handle, unsigned short nodeId, short & current, unsigned int & errorCode) = 0;
+
+    // Operation modes
+    virtual bool ActivateProfilePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+    virtual bool ActivatePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+    virtual bool ActivateVelocityMode(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+    virtual bool ActivateCurrentMode(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+    virtual bool ActivateInterpolatedPositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+
+    // Profile position mode
+    virtual bool SetPositionProfile(void * handle, unsigned short nodeId, unsigned int profileVelocity,
+                                    unsigned int profileAcceleration, unsigned int profileDeceleration,
+                                    unsigned int & errorCode) = 0;
+    virtual bool MoveToPosition(void * handle, unsigned short nodeId, int targetPosition,
+                                bool absolute, bool immediately, unsigned int & errorCode) = 0;
+    virtual bool HaltPositionMovement(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+    virtual bool HaltVelocityMovement(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+
+    // Position, velocity and current modes, current in mA
+    virtual bool SetPositionMust(void * handle, unsigned short nodeId, int position, unsigned int & errorCode) = 0;
+    virtual bool SetVelocityMust(void * handle, unsigned short nodeId, int velocity, unsigned int & errorCode) = 0;
+    virtual bool SetCurrentMust(void * handle, unsigned short nodeId, short current, unsigned int & errorCode) = 0;
+
+    // Interpolated position mode, PVT points: position (quadcounts),
+    // velocity (rpm) and time to the next point (ms, 0 ends the trajectory)
+    virtual bool SetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short underflowWarningLimit,
+                                       unsigned short overflowWarningLimit, unsigned int & errorCode) = 0;
+    virtual bool GetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short & underflowWarningLimit,
+                                       unsigned short & overflowWarningLimit, unsigned int & maxBufferSize,
+                                       unsigned int & errorCode) = 0;
+    virtual bool ClearIpmBuffer(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+    virtual bool GetFreeIpmBufferSize(void * handle, unsigned short nodeId, unsigned int & bufferSize,
+                                      unsigned int & errorCode) = 0;
+    virtual bool AddPvtValueToIpmBuffer(void * handle, unsigned short nodeId, int position, int velocity,
+                                        unsigned char time, unsigned int & errorCode) = 0;
+    virtual bool StartIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+    virtual bool StopIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+    virtual bool GetIpmStatus(void * handle, unsigned short nodeId, IpmStatus & status, unsigned int & errorCode) = 0;
+
+    // Object dictionary (SDO)
+    virtual bool GetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                           void * data, unsigned int numberOfBytesToRead, unsigned int & numberOfBytesRead,
+                           unsigned int & errorCode) = 0;
+    virtual bool SetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                           const void * data, unsigned int numberOfBytesToWrite, unsigned int & numberOfBytesWritten,
+                           unsigned int & errorCode) = 0;
+
+    // Data recorder, sampling period in multiples of the drive's recorder
+    // time base, trigger type is a mask of TRIGGER_*, channels are numbered
+    // from 1 and record an object of objectSize bytes.  The vector size is
+    // the number of samples recorded per channel, data vectors are little
+    // endian (objectSize bytes per sample).
+    enum {
+        TRIGGER_MOVEMENT_START = 1,
+        TRIGGER_ERROR          = 2,
+        TRIGGER_DIGITAL_INPUT  = 4,
+        TRIGGER_MOVEMENT_END   = 8
+    };
+    virtual bool SetRecorderParameter(void * handle, unsigned short nodeId, unsigned short samplingPeriod,
+                                      unsigned short numberOfPrecedingSamples, unsigned int & errorCode) = 0;
+    virtual bool EnableTrigger(void * handle, unsigned short nodeId, unsigned char triggerType,
+                               unsigned int & errorCode) = 0;
+    virtual bool DisableAllTriggers(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+    virtual bool ActivateChannel(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                                 unsigned short objectIndex, unsigned char objectSubIndex, unsigned char objectSize,
+                                 unsigned int & errorCode) = 0;
+    virtual bool DeactivateAllChannels(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+    virtual bool StartRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+    virtual bool StopRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+    virtual bool ForceTrigger(void * handle, unsigned short nodeId, unsigned int & errorCode) = 0;
+    virtual bool IsRecorderRunning(void * handle, unsigned short nodeId, bool & isRunning, unsigned int & errorCode) = 0;
+    virtual bool ReadChannelVectorSize(void * handle, unsigned short nodeId, unsigned int & vectorSize,
+                                       unsigned int & errorCode) = 0;
+    virtual bool ReadChannelDataVector(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                                       void * data, unsigned int bufferSize, unsigned int & errorCode) = 0;
+
+    // Low layer CAN frames (PDO, SYNC), only available on CANopen interfaces;
+    // ReadCANFrame waits up to timeout (ms) for the next frame with cobId
+    virtual bool ReadCANFrame(void * handle, unsigned short cobId, unsigned short length, void * data,
+                              unsigned int timeout, unsigned int & errorCode) = 0;
+    virtual bool SendCANFrame(void * handle, unsigned short cobId, unsigned short length, const void * data,
+                              unsigned int & errorCode) = 0;
+};
+
+#endif
@@ -0,0 +1,243 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+
+  (C) Copyright 2025 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsMaxonEPOSDriverRecorder_h
+#define _mtsMaxonEPOSDriverRecorder_h
+
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <sawMaxonEPOS/mtsMaxonEPOSDriver.h>
+
+// Always include last
+#include <sawMaxonEPOS/sawMaxonEPOSExport.h>
+
+// Driver decorator logging every call of the wrapped driver, with its
+// arguments, results, error code and timestamp, to a binary file that can
+// be replayed with mtsMaxonEPOSDriverReplay.
+//
+// File format, little endian, no padding:
+//   "EPOSRC01"                        file header (8 bytes)
+//   then one record per call:
+//     double   time                   call start, s since the file was opened
+//     float    duration               s
+//     uint32   error code
+//     uint16   address                node id, COB-ID for CAN frames, 0 for the bus
+//     uint16   bus                    1 for the first device opened, sub-devices share
+//                                     the bus of their device, 0 for unknown handles
+//     uint8    call                   mtsMaxonEPOSDriver::Call
+//     uint8    result                 1 on success (valid handle for open calls)
+//     uint16   input size, uint16 output size
+//     inputs, then outputs           in argument order, bool as uint8, strings and
+//                                     buffers prefixed by their uint16 size
+//
+// Records are written by the calling thread, under a mutex, to a buffered
+// file so the cost of a call is a few copies.
+class CISST_EXPORT mtsMaxonEPOSDriverRecorder : public mtsMaxonEPOSDriver
+{
+public:
+
+    static const char FileHeader[8];
+    // Size of a record header in the file
+    static const size_t RecordHeaderSize = 26;
+    // Inputs and outputs of a record are truncated to this size
+    static const size_t MaximumDataSize = 512;
+
+    // Takes ownership of driver
+    mtsMaxonEPOSDriverRecorder(mtsMaxonEPOSDriver * driver);
+    ~mtsMaxonEPOSDriverRecorder();
+
+    std::string GetBackendName(void) const override { return mDriver->GetBackendName(); }
+    bool Configure(const Json::Value & jsonConfig) override { return mDriver->Configure(jsonConfig); }
+
+    // Create the file and write the header, the time origin is reset
+    bool Open(const std::string & fileName, std::string & error);
+    void Close(void);
+    unsigned long long NumberOfRecords(void) const { return mNumberOfRecords; }
+
+    void * OpenDevice(const std::string & deviceName, const std::string & protocolStackName,
+                      const std::string & interfaceName, const std::string & portName,
+                      unsigned int & errorCode) override;
+    void * OpenSubDevice(void * deviceHandle, const std::string & deviceName,
+                         const std::string & protocolStackName, unsigned int & errorCode) override;
+    bool CloseSubDevice(void * handle, unsigned int & errorCode) override;
+    bool CloseDevice(void * handle, unsigned int & errorCode) override;
+    bool GetProtocolStackSettings(void * handle, unsigned int & baudrate, unsigned int & timeout,
+                                  unsigned int & errorCode) override;
+    bool SetProtocolStackSettings(void * handle, unsigned int baudrate, unsigned int timeout,
+                                  unsigned int & errorCode) override;
+    bool SendNMTService(void * handle, unsigned short nodeId, unsigned short commandSpecifier,
+                        unsigned int & errorCode) override;
+
+    bool ClearFault(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool GetFaultState(void * handle, unsigned short nodeId, bool & isFault, unsigned int & errorCode) override;
+    bool GetEnableState(void * handle, unsigned short nodeId, bool & isEnabled, unsigned int & errorCode) override;
+    bool SetEnableState(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool SetDisableState(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool GetState(void * handle, unsigned short nodeId, unsigned short & state, unsigned int & errorCode) override;
+
+    bool GetPositionIs(void * handle, unsigned short nodeId, int & position, unsigned int & errorCode) override;
+    bool GetCurrentIs(void * handle, unsigned short nodeId, short & current, unsigned int & errorCode) override;
+
+    bool ActivateProfilePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivatePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivateVelocityMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivateCurrentMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivateInterpolatedPositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+
+    bool SetPositionProfile(void * handle, unsigned short nodeId, unsigned int profileVelocity,
+                            unsigned int profileAcceleration, unsigned int profileDeceleration,
+                            unsigned int & errorCode) override;
+    bool MoveToPosition(void * handle, unsigned short nodeId, int targetPosition,
+                        bool absolute, bool immediately, unsigned int & errorCode) override;
+    bool HaltPositionMovement(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool HaltVelocityMovement(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+
+    bool SetPositionMust(void * handle, unsigned short nodeId, int position, unsigned int & errorCode) override;
+    bool SetVelocityMust(void * handle, unsigned short nodeId, int velocity, unsigned int & errorCode) override;
+    bool SetCurrentMust(void * handle, unsigned short nodeId, short current, unsigned int & errorCode) override;
+
+    bool SetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short underflowWarningLimit,
+                               unsigned short overflowWarningLimit, unsigned int & errorCode) override;
+    bool GetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short & underflowWarningLimit,
+                               unsigned short & overflowWarningLimit, unsigned int & maxBufferSize,
+                               unsigned int & errorCode) override;
+    bool ClearIpmBuffer(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool GetFreeIpmBufferSize(void * handle, unsigned short nodeId, unsigned int & bufferSize,
+                              unsigned int & errorCode) override;
+    bool AddPvtValueToIpmBuffer(void * handle, unsigned short nodeId, int position, int velocity,
+                                unsigned char time, unsigned int & errorCode) override;
+    bool StartIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool StopIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool GetIpmStatus(void * handle, unsigned short nodeId, IpmStatus & status, unsigned int & errorCode) override;
+
+    bool GetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                   void * data, unsigned int numberOfBytesToRead, unsigned int & numberOfBytesRead,
+                   unsigned int & errorCode) override;
+    bool SetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                   const void * data, unsigned int numberOfBytesToWrite, unsigned int & numberOfBytesWritten,
+                   unsigned int & errorCode) override;
+
+    bool SetRecorderParameter(void * handle, unsigned short nodeId, unsigned short samplingPeriod,
+                              unsigned short numberOfPrecedingSamples, unsigned int & errorCode) override;
+    bool EnableTrigger(void * handle, unsigned short nodeId, unsigned char triggerType, unsigned int & errorCode) override;
+    bool DisableAllTriggers(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivateChannel(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                         unsigned short objectIndex, unsigned char objectSubIndex, unsigned char objectSize,
+                         unsigned int & errorCode) override;
+    bool DeactivateAllChannels(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool StartRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool StopRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ForceTrigger(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool IsRecorderRunning(void * handle, unsigned short nodeId, bool & isRunning, unsigned int & errorCode) override;
+    bool ReadChannelVectorSize(void * handle, unsigned short nodeId, unsigned int & vectorSize,
+                               unsigned int & errorCode) override;
+    bool ReadChannelDataVector(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                               void * data, unsigned int bufferSize, unsigned int & errorCode) override;
+
+    bool ReadCANFrame(void * handle, unsigned short cobId, unsigned short length, void * data,
+                      unsigned int timeout, unsigned int & errorCode) override;
+    bool SendCANFrame(void * handle, unsigned short cobId, unsigned short length, const void * data,
+                      unsigned int & errorCode) override;
+
+
+protected:
+
+    // Filled by a call and written to the file on destruction
+    class Record {
+    public:
+        Record(mtsMaxonEPOSDriverRecorder & recorder, Call call, void * handle, unsigned short address);
+        ~Record();
+
+        template <typename _elementType>
+        void Input(const _elementType & value) {
+            Append(mInputs, mInputSize, &value, sizeof(value));
+        }
+        void Input(bool value) {
+            const uint8_t byte = value ? 1 : 0;
+            Append(mInputs, mInputSize, &byte, sizeof(byte));
+        }
+        void Input(const std::string & value) {
+            InputBuffer(value.data(), value.size());
+        }
+        void InputBuffer(const void * data, size_t size) {
+            AppendBuffer(mInputs, mInputSize, data, size);
+        }
+
+        template <typename _elementType>
+        void Output(const _elementType & value) {
+            Append(mOutputs, mOutputSize, &value, sizeof(value));
+        }
+        void Output(bool value) {
+            const uint8_t byte = value ? 1 : 0;
+            Append(mOutputs, mOutputSize, &byte, sizeof(byte));
+        }
+        void OutputBuffer(const void * data, size_t size) {
+            AppendBuffer(mOutputs, mOutputSize, data, size);
+        }
+
+        // Bus of the record, for calls opening a device
+        void SetBus(uint16_t bus) { mBus = bus; }
+
+        bool Result(bool result, unsigned int errorCode) {
+            mResult = result;
+            mErrorCode = errorCode;
+            return result;
+        }
+
+    private:
+        static void Append(uint8_t * buffer, size_t & size, const void * data, size_t dataSize);
+        static void AppendBuffer(uint8_t * buffer, size_t & size, const void * data, size_t dataSize);
+
+        mtsMaxonEPOSDriverRecorder & mRecorder;
+        Call mCall;
+        unsigned short mAddress;
+        uint16_t mBus;
+        std::chrono::steady_clock::time_point mStart;
+        bool mResult;
+        unsigned int mErrorCode;
+        size_t mInputSize;
+        size_t mOutputSize;
+        uint8_t mInputs[MaximumDataSize];
+        uint8_t mOutputs[MaximumDataSize];
+    };
+
+    void Write(const uint8_t * header, const uint8_t * inputs, size_t inputSize,
+               const uint8_t * outputs, size_t outputSize);
+    uint16_t Bus(void * handle);
+    uint16_t AddHandle(void * handle, uint16_t bus);
+    void RemoveHandle(void * handle);
+
+    struct HandleBus {
+        void * handle;
+        uint16_t bus;
+    };
+
+    mtsMaxonEPOSDriver * mDriver;
+    std::FILE * mFile;
+    std::vector<char> mFileBuffer;
+    std::mutex mMutex;                  // file and handles
+    std::chrono::steady_clock::time_point mStart;
+    unsigned long long mNumberOfRecords;
+    uint16_t mNumberOfBuses;
+    std::vector<HandleBus> mHandles;
+};
+
+#endif
@@ -0,0 +1,254 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+
+  (C) Copyright 2025 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsMaxonEPOSDriverReplay_h
+#define _mtsMaxonEPOSDriverReplay_h
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <sawMaxonEPOS/mtsMaxonEPOSDriver.h>
+
+// Always include last
+#include <sawMaxonEPOS/sawMaxonEPOSExport.h>
+
+// Driver backend replaying a file written by mtsMaxonEPOSDriverRecorder:
+// each call returns the recorded result, error code and outputs instead
+// of talking to the hardware.
+//
+// Records are matched by call, bus and address (node id or COB-ID), in
+// the recorded order for each of these keys.  This keeps the replay
+// deterministic when calls were made from several threads (concurrent
+// startup or polling), since only the interleaving of the keys varies
+// between runs.  Gateways are matched by their open parameters (port
+// name...), not by their opening order.  The file is read as needed, so
+// long recordings don't have to fit in memory.
+//
+// Inputs are compared to the recorded ones; a call with different inputs
+// still uses the recorded result but is counted as a mismatch.  A call
+// without record (recording too short or diverging replay) fails with an
+// internal error and is counted as missing.
+//
+// JSON configuration:
+//   "replay": {
+//       "file": "session.eposrec",    // required
+//       "speed": 1.0                  // time scale, 0 to replay as fast as possible
+//   }
+class CISST_EXPORT mtsMaxonEPOSDriverReplay : public mtsMaxonEPOSDriver
+{
+public:
+
+    // Error code returned when no record is left for a call
+    enum { ERROR_NO_RECORD = 0x10000001 };
+
+    mtsMaxonEPOSDriverReplay();
+    ~mtsMaxonEPOSDriverReplay();
+
+    std::string GetBackendName(void) const override { return "replay"; }
+    bool Configure(const Json::Value & jsonConfig) override;
+
+    bool Open(const std::string & fileName, double speed, std::string & error);
+
+    unsigned long long NumberOfMismatches(void) const { return mNumberOfMismatches; }
+    unsigned long long NumberOfMissing(void) const { return mNumberOfMissing; }
+
+    void * OpenDevice(const std::string & deviceName, const std::string & protocolStackName,
+                      const std::string & interfaceName, const std::string & portName,
+                      unsigned int & errorCode) override;
+    void * OpenSubDevice(void * deviceHandle, const std::string & deviceName,
+                         const std::string & protocolStackName, unsigned int & errorCode) override;
+    bool CloseSubDevice(void * handle, unsigned int & errorCode) override;
+    bool CloseDevice(void * handle, unsigned int & errorCode) override;
+    bool GetProtocolStackSettings(void * handle, unsigned int & baudrate, unsigned int & timeout,
+                                  unsigned int & errorCode) override;
+    bool SetProtocolStackSettings(void * handle, unsigned int baudrate, unsigned int timeout,
+                                  unsigned int & errorCode) override;
+    bool SendNMTService(void * handle, unsigned short nodeId, unsigned short commandSpecifier,
+                        unsigned int & errorCode) override;
+
+    bool ClearFault(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool GetFaultState(void * handle, unsigned short nodeId, bool & isFault, unsigned int & errorCode) override;
+    bool GetEnableState(void * handle, unsigned short nodeId, bool & isEnabled, unsigned int & errorCode) override;
+    bool SetEnableState(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool SetDisableState(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool GetState(void * handle, unsigned short nodeId, unsigned short & state, unsigned int & errorCode) override;
+
+    bool GetPositionIs(void * handle, unsigned short nodeId, int & position, unsigned int & errorCode) override;
+    bool GetCurrentIs(void * handle, unsigned short nodeId, short & current, unsigned int & errorCode) override;
+
+    bool ActivateProfilePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivatePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivateVelocityMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivateCurrentMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivateInterpolatedPositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+
+    bool SetPositionProfile(void * handle, unsigned short nodeId, unsigned int profileVelocity,
+                            unsigned int profileAcceleration, unsigned int profileDeceleration,
+                            unsigned int & errorCode) override;
+    bool MoveToPosition(void * handle, unsigned short nodeId, int targetPosition,
+                        bool absolute, bool immediately, unsigned int & errorCode) override;
+    bool HaltPositionMovement(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool HaltVelocityMovement(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+
+    bool SetPositionMust(void * handle, unsigned short nodeId, int position, unsigned int & errorCode) override;
+    bool SetVelocityMust(void * handle, unsigned short nodeId, int velocity, unsigned int & errorCode) override;
+    bool SetCurrentMust(void * handle, unsigned short nodeId, short current, unsigned int & errorCode) override;
+
+    bool SetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short underflowWarningLimit,
+                               unsigned short overflowWarningLimit, unsigned int & errorCode) override;
+    bool GetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short & underflowWarningLimit,
+                               unsigned short & overflowWarningLimit, unsigned int & maxBufferSize,
+                               unsigned int & errorCode) override;
+    bool ClearIpmBuffer(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool GetFreeIpmBufferSize(void * handle, unsigned short nodeId, unsigned int & bufferSize,
+                              unsigned int & errorCode) override;
+    bool AddPvtValueToIpmBuffer(void * handle, unsigned short nodeId, int position, int velocity,
+                                unsigned char time, unsigned int & errorCode) override;
+    bool StartIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool StopIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool GetIpmStatus(void * handle, unsigned short nodeId, IpmStatus & status, unsigned int & errorCode) override;
+
+    bool GetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                   void * data, unsigned int numberOfBytesToRead, unsigned int & numberOfBytesRead,
+                   unsigned int & errorCode) override;
+    bool SetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                   const void * data, unsigned int numberOfBytesToWrite, unsigned int & numberOfBytesWritten,
+                   unsigned int & errorCode) override;
+
+    bool SetRecorderParameter(void * handle, unsigned short nodeId, unsigned short samplingPeriod,
+                              unsigned short numberOfPrecedingSamples, unsigned int & errorCode) override;
+    bool EnableTrigger(void * handle, unsigned short nodeId, unsigned char triggerType, unsigned int & errorCode) override;
+    bool DisableAllTriggers(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivateChannel(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                         unsigned short objectIndex, unsigned char objectSubIndex, unsigned char objectSize,
+                         unsigned int & errorCode) override;
+    bool DeactivateAllChannels(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool StartRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool StopRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ForceTrigger(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool IsRecorderRunning(void * handle, unsigned short nodeId, bool & isRunning, unsigned int & errorCode) override;
+    bool ReadChannelVectorSize(void * handle, unsigned short nodeId, unsigned int & vectorSize,
+                               unsigned int & errorCode) override;
+    bool ReadChannelDataVector(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                               void * data, unsigned int bufferSize, unsigned int & errorCode) override;
+
+    bool ReadCANFrame(void * handle, unsigned short cobId, unsigned short length, void * data,
+                      unsigned int timeout, unsigned int & errorCode) override;
+    bool SendCANFrame(void * handle, unsigned short cobId, unsigned short length, const void * data,
+                      unsigned int & errorCode) override;
+
+
+protected:
+
+    struct RecordData {
+        double time;
+        float duration;
+        uint32_t errorCode;
+        uint16_t address;
+        uint16_t bus;
+        uint8_t call;
+        uint8_t result;
+        std::vector<uint8_t> inputs;
+        std::vector<uint8_t> outputs;
+    };
+
+    // Inputs are collected like in the recorder, the record is looked up
+    // on the first output or result
+    class Replay {
+    public:
+        Replay(mtsMaxonEPOSDriverReplay & driver, Call call, void * handle, unsigned short address);
+        ~Replay();
+
+        template <typename _elementType>
+        void Input(const _elementType & value) {
+            Append(&value, sizeof(value));
+        }
+        void Input(bool value) {
+            const uint8_t byte = value ? 1 : 0;
+            Append(&byte, sizeof(byte));
+        }
+        void Input(const std::string & value) {
+            InputBuffer(value.data(), value.size());
+        }
+        void InputBuffer(const void * data, size_t size);
+
+        template <typename _elementType>
+        void Output(_elementType & value) {
+            Extract(&value, sizeof(value));
+        }
+        void Output(bool & value) {
+            uint8_t byte = 0;
+            Extract(&byte, sizeof(byte));
+            value = (byte != 0);
+        }
+        // Copies at most size bytes, returns the recorded size
+        size_t OutputBuffer(void * data, size_t size);
+
+        // Bus of the record, for calls opening a device
+        uint16_t Bus(void);
+
+        bool Result(unsigned int & errorCode);
+
+    private:
+        void Append(const void * data, size_t size);
+        void Extract(void * data, size_t size);
+        void Execute(void);
+
+        mtsMaxonEPOSDriverReplay & mDriver;
+        Call mCall;
+        unsigned short mAddress;
+        uint16_t mBus;
+        bool mExecuted;
+        bool mFound;
+        RecordData mRecord;
+        std::vector<uint8_t> mInputs;
+        size_t mOutputPosition;
+    };
+
+    struct Handle {
+        uint16_t bus;
+    };
+
+    static uint64_t Key(uint8_t call, uint16_t bus, uint16_t address);
+    bool ReadRecord(RecordData & record);
+    // Next record for the key, for CALL_OPEN_DEVICE the first one with the same inputs
+    bool Next(Call call, uint16_t bus, unsigned short address, const std::vector<uint8_t> & inputs,
+              RecordData & record);
+    void Wait(double recordTime);
+    void * NewHandle(uint16_t bus);
+    static uint16_t Bus(void * handle);
+
+    std::FILE * mFile;
+    std::mutex mMutex;                  // file, pending records and handles
+    std::map<uint64_t, std::deque<RecordData> > mPending;
+    std::vector<std::unique_ptr<Handle> > mHandles;
+    double mSpeed;
+    bool mStarted;
+    double mFirstRecordTime;
+    std::chrono::steady_clock::time_point mStart;
+    std::atomic<unsigned long long> mNumberOfMismatches;
+    std::atomic<unsigned long long> mNumberOfMissing;
+};
+
+#endif
@@ -0,0 +1,310 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+
+  (C) Copyright 2025 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsMaxonEPOSDriverSimulated_h
+#define _mtsMaxonEPOSDriverSimulated_h
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <sawMaxonEPOS/mtsMaxonEPOSDriver.h>
+
+// Always include last
+#include <sawMaxonEPOS/sawMaxonEPOSExport.h>
+
+// Driver backend that simulates the EPOS nodes in-process, so that the
+// component can be exercised (and profiled) without hardware.
+//
+// Each gateway opened with OpenDevice is a separate bus with its own set of
+// nodes (node ids 1 to 127); sub-devices share the bus of their gateway.
+// Calls on the same bus are serialized and each one takes the configured
+// latency, like SDO transfers on a real CANopen bus.
+//
+// Motor dynamics (per node):
+//   position mode          first order tracking of the position setpoint
+//   velocity mode          first order tracking of the velocity setpoint
+//   current mode           ideal current loop, the motor accelerates
+//                          following the current model below
+//   profile position mode  trapezoidal profile using the position profile
+//   interpolated position  cubic interpolation of the PVT points (64 points
+//                          buffer), first order tracking of the result
+// The current is estimated from the acceleration and velocity.
+//
+// The object dictionary is simulated for the dynamic objects (statusword,
+// position, velocity and current actual values, position profile); other
+// objects are stored as written.  TxPDOs (1 to 4) are built from the
+// mapping objects (0x1A00-0x1A03) and can be read with ReadCANFrame once
+// the node is operational (NMT start).
+//
+// The data recorder samples up to 4 channels (objects read as with
+// GetObject) every sampling period (multiples of 0.1 ms), with the
+// movement start, movement end and error triggers.  Once triggered it
+// stops when 1024 samples, including the preceding ones, are recorded.
+//
+// JSON configuration, all fields optional:
+//   "simulated": {
+//       "latency": 0.0005,            // seconds per call
+//       "counts_per_turn": 2048,      // quadcounts per motor turn, for rpm units
+//       "bandwidth": 50.0,            // position/velocity loop bandwidth (Hz)
+//       "max_velocity": 10000.0,      // rpm
+//       "max_following_error": 0,     // quadcounts, 0 to disable
+//       "current_per_acceleration": 0.001,  // mA per (rpm/s)
+//       "current_per_velocity": 0.01, // mA per rpm
+//       "boot_time": 0.0              // seconds a node doesn't answer after an NMT reset
+//   }
+class CISST_EXPORT mtsMaxonEPOSDriverSimulated : public mtsMaxonEPOSDriver
+{
+public:
+
+    // Fault injection hook, called before each simulated call with the call
+    // name (VCS_ function name without prefix) and node id.  Returning a
+    // non-zero error code makes the call fail with that code.  The hook
+    // should be set before the component is started.
+    typedef std::function<unsigned int (const char * call, unsigned short nodeId)> FaultHook;
+
+    // Simulated error codes (same values as EposCmdLib)
+    enum {
+        ERROR_HANDLE_NOT_VALID = 0x10000003,
+        ERROR_COMMAND_FAILED   = 0x1000000A,
+        ERROR_BAD_PARAMETER    = 0x1000000C,
+        ERROR_NOT_SUPPORTED    = 0x10000010,
+        ERROR_TIMEOUT          = 0x1000000B,
+        ERROR_READ_ONLY        = 0x06010002,   // SDO abort: attempt to write a read only object
+        ERROR_OBJECT_NOT_FOUND = 0x06020000,   // SDO abort: object does not exist
+        ERROR_FOLLOWING        = 0x00008611   // device error: position following error
+    };
+
+    mtsMaxonEPOSDriverSimulated();
+    ~mtsMaxonEPOSDriverSimulated();
+
+    std::string GetBackendName(void) const override { return "simulated"; }
+    bool Configure(const Json::Value & jsonConfig) override;
+
+    void SetCallLatency(double latency) { mLatency = latency; }
+    double GetCallLatency(void) const { return mLatency; }
+    void SetFaultHook(const FaultHook & hook);
+    // Put a node of the bus of handle in fault state
+    void InjectFault(void * handle, unsigned short nodeId, unsigned int deviceErrorCode = ERROR_FOLLOWING);
+
+    void * OpenDevice(const std::string & deviceName, const std::string & protocolStackName,
+                      const std::string & interfaceName, const std::string & portName,
+                      unsigned int & errorCode) override;
+    void * OpenSubDevice(void * deviceHandle, const std::string & deviceName,
+                         const std::string & protocolStackName, unsigned int & errorCode) override;
+    bool CloseSubDevice(void * handle, unsigned int & errorCode) override;
+    bool CloseDevice(void * handle, unsigned int & errorCode) override;
+    bool GetProtocolStackSettings(void * handle, unsigned int & baudrate, unsigned int & timeout,
+                                  unsigned int & errorCode) override;
+    bool SetProtocolStackSettings(void * handle, unsigned int baudrate, unsigned int timeout,
+                                  unsigned int & errorCode) override;
+    bool SendNMTService(void * handle, unsigned short nodeId, unsigned short commandSpecifier,
+                        unsigned int & errorCode) override;
+
+    bool ClearFault(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool GetFaultState(void * handle, unsigned short nodeId, bool & isFault, unsigned int & errorCode) override;
+    bool GetEnableState(void * handle, unsigned short nodeId, bool & isEnabled, unsigned int & errorCode) override;
+    bool SetEnableState(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool SetDisableState(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool GetState(void * handle, unsigned short nodeId, unsigned short & state, unsigned int & errorCode) override;
+
+    bool GetPositionIs(void * handle, unsigned short nodeId, int & position, unsigned int & errorCode) override;
+    bool GetCurrentIs(void * handle, unsigned short nodeId, short & current, unsigned int & errorCode) override;
+
+    bool ActivateProfilePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivatePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivateVelocityMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivateCurrentMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivateInterpolatedPositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+
+    bool SetPositionProfile(void * handle, unsigned short nodeId, unsigned int profileVelocity,
+                            unsigned int profileAcceleration, unsigned int profileDeceleration,
+                            unsigned int & errorCode) override;
+    bool MoveToPosition(void * handle, unsigned short nodeId, int targetPosition,
+                        bool absolute, bool immediately, unsigned int & errorCode) override;
+    bool HaltPositionMovement(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool HaltVelocityMovement(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+
+    bool SetPositionMust(void * handle, unsigned short nodeId, int position, unsigned int & errorCode) override;
+    bool SetVelocityMust(void * handle, unsigned short nodeId, int velocity, unsigned int & errorCode) override;
+    bool SetCurrentMust(void * handle, unsigned short nodeId, short current, unsigned int & errorCode) override;
+
+    bool SetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short underflowWarningLimit,
+                               unsigned short overflowWarningLimit, unsigned int & errorCode) override;
+    bool GetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short & underflowWarningLimit,
+                               unsigned short & overflowWarningLimit, unsigned int & maxBufferSize,
+                               unsigned int & errorCode) override;
+    bool ClearIpmBuffer(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool GetFreeIpmBufferSize(void * handle, unsigned short nodeId, unsigned int & bufferSize,
+                              unsigned int & errorCode) override;
+    bool AddPvtValueToIpmBuffer(void * handle, unsigned short nodeId, int position, int velocity,
+                                unsigned char time, unsigned int & errorCode) override;
+    bool StartIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool StopIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool GetIpmStatus(void * handle, unsigned short nodeId, IpmStatus & status, unsigned int & errorCode) override;
+
+    bool GetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                   void * data, unsigned int numberOfBytesToRead, unsigned int & numberOfBytesRead,
+                   unsigned int & errorCode) override;
+    bool SetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                   const void * data, unsigned int numberOfBytesToWrite, unsigned int & numberOfBytesWritten,
+                   unsigned int & errorCode) override;
+
+    bool SetRecorderParameter(void * handle, unsigned short nodeId, unsigned short samplingPeriod,
+                              unsigned short numberOfPrecedingSamples, unsigned int & errorCode) override;
+    bool EnableTrigger(void * handle, unsigned short nodeId, unsigned char triggerType, unsigned int & errorCode) override;
+    bool DisableAllTriggers(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivateChannel(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                         unsigned short objectIndex, unsigned char objectSubIndex, unsigned char objectSize,
+                         unsigned int & errorCode) override;
+    bool DeactivateAllChannels(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool StartRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool StopRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ForceTrigger(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool IsRecorderRunning(void * handle, unsigned short nodeId, bool & isRunning, unsigned int & errorCode) override;
+    bool ReadChannelVectorSize(void * handle, unsigned short nodeId, unsigned int & vectorSize,
+                               unsigned int & errorCode) override;
+    bool ReadChannelDataVector(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                               void * data, unsigned int bufferSize, unsigned int & errorCode) override;
+
+    bool ReadCANFrame(void * handle, unsigned short cobId, unsigned short length, void * data,
+                      unsigned int timeout, unsigned int & errorCode) override;
+    bool SendCANFrame(void * handle, unsigned short cobId, unsigned short length, const void * data,
+                      unsigned int & errorCode) override;
+
+protected:
+
+    enum { MAX_NODES = 128, IPM_BUFFER_SIZE = 64, RECORDER_CHANNELS = 4, RECORDER_SAMPLES = 1024 };
+    enum NodeState { NODE_DISABLED = 0, NODE_ENABLED = 1, NODE_QUICKSTOP = 2, NODE_FAULT = 3 };
+    enum NodeMode { MODE_PROFILE_POSITION, MODE_POSITION, MODE_VELOCITY, MODE_CURRENT, MODE_INTERPOLATED_POSITION };
+
+    struct PvtPoint {
+        double position;               // quadcounts
+        double velocity;               // quadcounts/s
+        double time;                   // seconds to next point, 0 for last point
+    };
+
+    struct RecorderChannel {
+        unsigned short index;
+        unsigned char  subIndex;
+        unsigned char  size;           // bytes, 0 if the channel is not active
+    };
+
+    struct Node {
+        NodeState    state;
+        NodeMode     mode;
+        double       position;         // quadcounts
+        double       velocity;         // quadcounts/s
+        double       acceleration;     // quadcounts/s^2
+        double       current;          // mA
+        double       targetPosition;   // quadcounts
+        double       targetVelocity;   // quadcounts/s
+        double       targetCurrent;    // mA
+        bool         moving;           // profile position move in progress
+        unsigned int profileVelocity;  // rpm
+        unsigned int profileAcceleration;
+        unsigned int profileDeceleration;
+        unsigned int deviceError;
+        double       lastUpdate;       // seconds
+        bool         operational;      // NMT state
+        double       bootEnd;          // seconds, node calls time out before (NMT reset)
+        // Interpolated position mode
+        std::deque<PvtPoint> ipmBuffer;
+        PvtPoint     ipmSegment;       // start of segment being executed
+        double       ipmTime;          // time since start of segment
+        bool         ipmRunning;
+        bool         ipmUnderflowError;
+        bool         ipmOverflowError;
+        unsigned short ipmUnderflowWarningLimit;
+        unsigned short ipmOverflowWarningLimit;
+        // Static objects, key is index << 8 | subindex, value and size in bytes
+        std::map<unsigned int, std::pair<unsigned int, unsigned int> > objects;
+        // Synchronous RxPDO received, applied at the next SYNC
+        int          rxPDOPending;     // RxPDO index (0 to 3), -1 if none
+        unsigned char rxPDOData[8];
+        // Data recorder, RECORDER_CHANNELS values per sample
+        RecorderChannel recorderChannels[RECORDER_CHANNELS];
+        unsigned short recorderPeriod;  // multiples of the recorder time base
+        unsigned short recorderPreceding;
+        unsigned char recorderTriggers; // mask of TRIGGER_*
+        bool         recorderRunning;
+        bool         recorderTriggered;
+        bool         recorderMoving;   // moving at the last sample, for the movement triggers
+        double       recorderTime;     // since the last sample
+        std::deque<unsigned int> recorderSamples;
+    };
+
+    struct Bus {
+        std::mutex mutex;              // serializes calls, as on a real bus
+        std::vector<Node> nodes;
+        unsigned int baudrate;
+        unsigned int timeout;
+    };
+
+    struct Handle {
+        unsigned int magic;
+        std::shared_ptr<Bus> bus;
+        bool isGateway;
+        bool isOpen;
+    };
+
+    // Validate the handle, take the bus and apply latency and fault hook;
+    // returns nullptr on error, with errorCode set.  BeginNodeCall also
+    // validates the node id and updates the node dynamics.
+    Bus * BeginCall(const char * call, void * handle, unsigned short nodeId,
+                    std::unique_lock<std::mutex> & lock, unsigned int & errorCode);
+    Node * BeginNodeCall(const char * call, void * handle, unsigned short nodeId,
+                         std::unique_lock<std::mutex> & lock, unsigned int & errorCode);
+    void Update(Node & node, double now) const;
+    void ResetNode(Node & node, double now) const;
+    void ClearIpm(Node & node) const;
+    void ClearRecorder(Node & node) const;
+    // Advance the data recorder by dt, called with the node state at the start of dt
+    void SampleRecorder(Node & node, double dt) const;
+    // Next IPM position setpoint, advancing through the segments
+    double InterpolateIpm(Node & node, double dt) const;
+    void Wait(double duration) const;
+    void ApplyNMT(Bus & bus, unsigned short nodeId, unsigned short commandSpecifier) const;
+    bool ReadObject(const Node & node, unsigned short nodeId, unsigned short index, unsigned char subIndex,
+                    unsigned int & value, unsigned int & size, unsigned int & errorCode) const;
+    bool WriteObject(Node & node, unsigned short index, unsigned char subIndex,
+                     unsigned int value, unsigned int size, unsigned int & errorCode) const;
+    // Write the objects mapped in RxPDO pdo (0 to 3) from the frame data
+    void ApplyRxPDO(Node & node, unsigned short nodeId, unsigned short pdo, const unsigned char * data) const;
+    static unsigned short Statusword(const Node & node);
+    static short CurrentValue(const Node & node);
+    static double Now(void);
+    double RpmToCounts(double rpm) const { return rpm * mCountsPerTurn / 60.0; }
+
+    double mLatency;
+    double mCountsPerTurn;
+    double mBandwidth;
+    double mMaxVelocity;
+    double mMaxFollowingError;
+    double mCurrentPerAcceleration;
+    double mCurrentPerVelocity;
+    double mBootTime;
+
+    FaultHook mFaultHook;
+    std::mutex mHandlesMutex;
+    std::vector<std::unique_ptr<Handle> > mHandles;
+};
+
+#endif
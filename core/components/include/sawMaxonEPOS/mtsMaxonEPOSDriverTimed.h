@@ -0,0 +1,175 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+
+  (C) Copyright 2025 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsMaxonEPOSDriverTimed_h
+#define _mtsMaxonEPOSDriverTimed_h
+
+#include <chrono>
+#include <vector>
+
+#include <sawMaxonEPOS/mtsMaxonEPOSDriver.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSLatencyHistogram.h>
+
+// Always include last
+#include <sawMaxonEPOS/sawMaxonEPOSExport.h>
+
+// Driver decorator recording the latency of every call of the wrapped
+// driver, in a histogram per call type and axis.  Axes are identified by
+// handle and node id (see SetAxis); calls not addressed to a known axis
+// (gateway, NMT, SYNC...) are recorded in the last column ("bus").
+class CISST_EXPORT mtsMaxonEPOSDriverTimed : public mtsMaxonEPOSDriver
+{
+public:
+
+    // Takes ownership of driver
+    mtsMaxonEPOSDriverTimed(mtsMaxonEPOSDriver * driver, size_t numberOfAxes);
+    ~mtsMaxonEPOSDriverTimed();
+
+    std::string GetBackendName(void) const override { return mDriver->GetBackendName(); }
+    bool Configure(const Json::Value & jsonConfig) override { return mDriver->Configure(jsonConfig); }
+
+    // Register the handle and node id used for an axis, should be called
+    // before the polling threads are started
+    void SetAxis(size_t axis, void * handle, unsigned short nodeId);
+
+    mtsMaxonEPOSLatencyHistogram & Histogram(void) { return mHistogram; }
+
+    // Wrapped driver
+    mtsMaxonEPOSDriver * Driver(void) { return mDriver; }
+    const mtsMaxonEPOSLatencyHistogram & Histogram(void) const { return mHistogram; }
+
+    void * OpenDevice(const std::string & deviceName, const std::string & protocolStackName,
+                      const std::string & interfaceName, const std::string & portName,
+                      unsigned int & errorCode) override;
+    void * OpenSubDevice(void * deviceHandle, const std::string & deviceName,
+                         const std::string & protocolStackName, unsigned int & errorCode) override;
+    bool CloseSubDevice(void * handle, unsigned int & errorCode) override;
+    bool CloseDevice(void * handle, unsigned int & errorCode) override;
+    bool GetProtocolStackSettings(void * handle, unsigned int & baudrate, unsigned int & timeout,
+                                  unsigned int & errorCode) override;
+    bool SetProtocolStackSettings(void * handle, unsigned int baudrate, unsigned int timeout,
+                                  unsigned int & errorCode) override;
+    bool SendNMTService(void * handle, unsigned short nodeId, unsigned short commandSpecifier,
+                        unsigned int & errorCode) override;
+
+    bool ClearFault(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool GetFaultState(void * handle, unsigned short nodeId, bool & isFault, unsigned int & errorCode) override;
+    bool GetEnableState(void * handle, unsigned short nodeId, bool & isEnabled, unsigned int & errorCode) override;
+    bool SetEnableState(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool SetDisableState(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool GetState(void * handle, unsigned short nodeId, unsigned short & state, unsigned int & errorCode) override;
+
+    bool GetPositionIs(void * handle, unsigned short nodeId, int & position, unsigned int & errorCode) override;
+    bool GetCurrentIs(void * handle, unsigned short nodeId, short & current, unsigned int & errorCode) override;
+
+    bool ActivateProfilePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivatePositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivateVelocityMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivateCurrentMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivateInterpolatedPositionMode(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+
+    bool SetPositionProfile(void * handle, unsigned short nodeId, unsigned int profileVelocity,
+                            unsigned int profileAcceleration, unsigned int profileDeceleration,
+                            unsigned int & errorCode) override;
+    bool MoveToPosition(void * handle, unsigned short nodeId, int targetPosition,
+                        bool absolute, bool immediately, unsigned int & errorCode) override;
+    bool HaltPositionMovement(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool HaltVelocityMovement(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+
+    bool SetPositionMust(void * handle, unsigned short nodeId, int position, unsigned int & errorCode) override;
+    bool SetVelocityMust(void * handle, unsigned short nodeId, int velocity, unsigned int & errorCode) override;
+    bool SetCurrentMust(void * handle, unsigned short nodeId, short current, unsigned int & errorCode) override;
+
+    bool SetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short underflowWarningLimit,
+                               unsigned short overflowWarningLimit, unsigned int & errorCode) override;
+    bool GetIpmBufferParameter(void * handle, unsigned short nodeId, unsigned short & underflowWarningLimit,
+                               unsigned short & overflowWarningLimit, unsigned int & maxBufferSize,
+                               unsigned int & errorCode) override;
+    bool ClearIpmBuffer(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool GetFreeIpmBufferSize(void * handle, unsigned short nodeId, unsigned int & bufferSize,
+                              unsigned int & errorCode) override;
+    bool AddPvtValueToIpmBuffer(void * handle, unsigned short nodeId, int position, int velocity,
+                                unsigned char time, unsigned int & errorCode) override;
+    bool StartIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool StopIpmTrajectory(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool GetIpmStatus(void * handle, unsigned short nodeId, IpmStatus & status, unsigned int & errorCode) override;
+
+    bool GetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                   void * data, unsigned int numberOfBytesToRead, unsigned int & numberOfBytesRead,
+                   unsigned int & errorCode) override;
+    bool SetObject(void * handle, unsigned short nodeId, unsigned short objectIndex, unsigned char objectSubIndex,
+                   const void * data, unsigned int numberOfBytesToWrite, unsigned int & numberOfBytesWritten,
+                   unsigned int & errorCode) override;
+
+    bool SetRecorderParameter(void * handle, unsigned short nodeId, unsigned short samplingPeriod,
+                              unsigned short numberOfPrecedingSamples, unsigned int & errorCode) override;
+    bool EnableTrigger(void * handle, unsigned short nodeId, unsigned char triggerType, unsigned int & errorCode) override;
+    bool DisableAllTriggers(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ActivateChannel(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                         unsigned short objectIndex, unsigned char objectSubIndex, unsigned char objectSize,
+                         unsigned int & errorCode) override;
+    bool DeactivateAllChannels(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool StartRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool StopRecorder(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool ForceTrigger(void * handle, unsigned short nodeId, unsigned int & errorCode) override;
+    bool IsRecorderRunning(void * handle, unsigned short nodeId, bool & isRunning, unsigned int & errorCode) override;
+    bool ReadChannelVectorSize(void * handle, unsigned short nodeId, unsigned int & vectorSize,
+                               unsigned int & errorCode) override;
+    bool ReadChannelDataVector(void * handle, unsigned short nodeId, unsigned char channelNumber,
+                               void * data, unsigned int bufferSize, unsigned int & errorCode) override;
+
+    bool ReadCANFrame(void * handle, unsigned short cobId, unsigned short length, void * data,
+                      unsigned int timeout, unsigned int & errorCode) override;
+    bool SendCANFrame(void * handle, unsigned short cobId, unsigned short length, const void * data,
+                      unsigned int & errorCode) override;
+
+protected:
+
+    // Records the duration of its scope
+    class Timer {
+    public:
+        Timer(mtsMaxonEPOSDriverTimed & driver, Call call, void * handle, unsigned short nodeId) :
+            mDriver(driver),
+            mCall(call),
+            mAxis(driver.Axis(handle, nodeId)),
+            mStart(std::chrono::steady_clock::now())
+        {}
+        ~Timer() {
+            mDriver.mHistogram.Record(mCall, mAxis,
+                                      std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count());
+        }
+    private:
+        mtsMaxonEPOSDriverTimed & mDriver;
+        Call mCall;
+        size_t mAxis;
+        std::chrono::steady_clock::time_point mStart;
+    };
+
+    // Column of the histogram for handle and node id
+    size_t Axis(void * handle, unsigned short nodeId) const;
+
+    struct AxisKey {
+        void * handle;
+        unsigned short nodeId;
+    };
+
+    mtsMaxonEPOSDriver * mDriver;
+    std::vector<AxisKey> mAxes;
+    mtsMaxonEPOSLatencyHistogram mHistogram;
+};
+
+#endif
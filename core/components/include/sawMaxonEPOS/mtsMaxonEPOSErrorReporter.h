@@ -0,0 +1,73 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+
+  (C) Copyright 2025 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsMaxonEPOSErrorReporter_h
+#define _mtsMaxonEPOSErrorReporter_h
+
+#include <string>
+#include <vector>
+
+#include <cisstVector/vctDynamicVectorTypes.h>
+#include <sawMaxonEPOS/mtsMaxonEPOSDriver.h>
+
+// Always include last
+#include <sawMaxonEPOS/sawMaxonEPOSExport.h>
+
+// Error counters for the cyclic EPOS calls, one per call type and axis
+// (the last "axis" is for calls addressed to the bus).  Record only
+// increments preallocated counters, so a failing call costs about the
+// same as a successful one.  Errors are reported at most once per period
+// as a single summary message, with the EPOS error descriptions.
+class CISST_EXPORT mtsMaxonEPOSErrorReporter
+{
+public:
+
+    mtsMaxonEPOSErrorReporter();
+
+    void Configure(size_t numberOfAxes, double summaryPeriod);
+
+    // Count a failed call, doesn't allocate
+    void Record(mtsMaxonEPOSDriver::Call call, size_t axis, unsigned int errorCode);
+
+    // If errors were recorded and the last summary is older than the
+    // period, build a summary of the errors since then and return true
+    bool Summary(double now, std::string & message);
+
+    // Total errors, call type major then axis, bus last (same order as
+    // the latency statistics)
+    void GetCounters(vctDoubleVec & counters) const;
+    void Reset(void);
+
+    // Number of errors recorded since the last reset, to detect changes
+    unsigned int Total(void) const { return mTotal; }
+
+protected:
+    struct Cell {
+        unsigned int total;
+        unsigned int pending;           // since last summary
+        unsigned int lastErrorCode;
+    };
+
+    size_t mNumberOfColumns;
+    double mSummaryPeriod;
+    double mLastSummary;
+    unsigned int mPending;
+    unsigned int mTotal;
+    std::vector<Cell> mCells;
+};
+
+#endif
@@ -0,0 +1,106 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+
+  (C) Copyright 2025 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsMaxonEPOSFlightRecorder_h
+#define _mtsMaxonEPOSFlightRecorder_h
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Always include last
+#include <sawMaxonEPOS/sawMaxonEPOSExport.h>
+
+// Ring buffer of the last samples recorded in Run, dumped to a binary file
+// (e.g. on fault) by a background thread.  Memory is allocated by
+// Configure, Record and Dump only copy data.  On Dump, the ring is swapped
+// with the write buffer so recording resumes immediately (with an empty
+// history); another dump can't start before the file is written.
+//
+// File format (little endian):
+//   char[8]   "EPOSFR01"
+//   uint32    number of axes
+//   uint32    number of samples
+//   double    wall clock time of the dump (seconds since epoch)
+//   samples, oldest first: SampleHeader followed by one AxisSample per axis
+class CISST_EXPORT mtsMaxonEPOSFlightRecorder
+{
+public:
+
+    struct SampleHeader {
+        double   time;                  // seconds, steady clock
+        uint32_t cycle;
+        uint32_t operatingState;        // prmOperatingState::StateType
+    };
+
+    struct AxisSample {
+        int32_t  position;              // quadcounts, raw
+        float    setpoint;              // quadcounts, mA in current mode
+        int16_t  current;               // mA
+        uint8_t  mode;                  // operation mode used by the component
+        uint8_t  state;                 // 0 disabled, 1 enabled, 2 quickstop, 3 fault
+        uint32_t errorCode;
+    };
+
+    mtsMaxonEPOSFlightRecorder();
+    ~mtsMaxonEPOSFlightRecorder();
+
+    // Allocate buffers for capacity samples; Dump saves the samples
+    // recorded during the last duration seconds
+    void Configure(size_t numberOfAxes, size_t capacity, double duration);
+    bool IsEnabled(void) const { return mCapacity > 0; }
+
+    // Writer thread
+    void Start(void);
+    void Stop(void);
+
+    void Record(const SampleHeader & header, const AxisSample * axes);
+
+    // Request a dump to fileName, returns false if a dump is still in progress
+    bool Dump(const std::string & fileName);
+
+protected:
+    void Writer(void);
+    void Write(void);
+
+    size_t mNumberOfAxes;
+    size_t mCapacity;
+    size_t mSampleSize;                 // bytes
+    double mDuration;
+
+    // Ring buffer
+    std::vector<unsigned char> mBuffer;
+    size_t mHead;                       // next sample
+    size_t mCount;
+
+    // Dump, protected by mMutex
+    std::vector<unsigned char> mDumpBuffer;
+    size_t mDumpHead;
+    size_t mDumpCount;
+    std::string mDumpFileName;
+    bool mDumpRequested;
+    bool mDumpInProgress;
+    bool mStopRequested;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::thread mThread;
+};
+
+#endif
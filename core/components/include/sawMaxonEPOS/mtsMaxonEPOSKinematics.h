@@ -0,0 +1,137 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+
+  (C) Copyright 2025 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsMaxonEPOSKinematics_h
+#define _mtsMaxonEPOSKinematics_h
+
+#include <string>
+
+#include <json/json.h>
+
+#include <cisstVector/vctDynamicVectorTypes.h>
+#include <cisstVector/vctTransformationTypes.h>
+
+// Always include last
+#include <sawMaxonEPOS/sawMaxonEPOSExport.h>
+
+// Forward kinematics of the I2RIS eye snake: a roll about the insertion
+// axis followed by a continuum snake bending in two directions (pitch and
+// yaw), modeled as a single constant curvature segment, and a straight
+// tool.  Base frame z is the insertion axis, the tip frame z is the tool
+// direction.
+//
+// Joint values are computed from the motor positions (quadcounts relative
+// to home) with a linear scale per joint.  With pitch and yaw bending
+// angles, the total bending angle is theta = sqrt(pitch^2 + yaw^2) in the
+// plane at phi = atan2(yaw, pitch) from x:
+//   R_snake = Rz(phi) Ry(theta) Rz(-phi)
+//   p_snake = L / theta [(1 - cos(theta)) cos(phi), (1 - cos(theta)) sin(phi), sin(theta)]
+//   tip     = Rz(roll) [R_snake, p_snake + R_snake [0, 0, tool]]
+//
+// The trigonometric terms of the snake and of the roll are cached and
+// only recomputed when their joints move more than the tolerance, so the
+// pose costs a few comparisons when the robot doesn't move.
+//
+// Inverse kinematics use damped least squares on the position error and
+// the orientation error (scaled by orientation_weight, m/rad), with the
+// Jacobian computed by finite differences.  With 3 joints, most poses are
+// not reachable exactly; the solver then stops at the closest pose
+// (STALLED).  Each solve is bounded by a number of iterations and a time
+// budget so it can run in the servo loop.
+//
+// JSON configuration ("kinematics" in the robot configuration):
+//   "type": "I2RIS",
+//   "roll":  {"axis": 0, "scale": 1e-4},   // rad per quadcount, axis -1 if not actuated
+//   "pitch": {"axis": 1, "scale": 1e-5},
+//   "yaw":   {"axis": 2, "scale": 1e-5},
+//   "snake_length": 0.003,                 // m
+//   "tool_length": 0.0,                    // m, past the snake
+//   "tolerance": 1e-6,                     // rad
+//   "base_frame": "I2RIS_base", "tip_frame": "I2RIS_tip",
+//   "ik": {"budget": 0.0005, "max_iterations": 20, "tolerance": 1e-6,   // s, -, m
+//          "damping": 1e-4, "orientation_weight": 0.001}              // m, m/rad
+class CISST_EXPORT mtsMaxonEPOSKinematics
+{
+public:
+
+    enum { ROLL = 0, PITCH, YAW, NUMBER_OF_JOINTS };
+
+    enum Status {
+        CONVERGED,                          // error below tolerance
+        STALLED,                            // steps below tolerance, closest reachable pose
+        ITERATIONS,                         // maximum number of iterations reached
+        BUDGET                              // time budget spent
+    };
+
+    mtsMaxonEPOSKinematics();
+
+    bool Configure(const Json::Value & jsonConfig, size_t numberOfAxes, const std::string & robotName,
+                   std::string & error);
+    bool IsEnabled(void) const { return mEnabled; }
+
+    const std::string & BaseFrame(void) const { return mBaseFrame; }
+    const std::string & TipFrame(void) const { return mTipFrame; }
+
+    // Joint values (rad) from the motor positions (quadcounts)
+    void JointsFromMotors(const vctDoubleVec & motors, double joints[NUMBER_OF_JOINTS]) const;
+
+    // Tip pose for the motor positions, pose is only modified if a joint
+    // moved more than the tolerance since the last update (returns true)
+    bool Update(const vctDoubleVec & motors, vctFrm3 & pose);
+
+    // Motor positions (quadcounts) for joint values, axes not used by the
+    // kinematics are not modified
+    void MotorsFromJoints(const double joints[NUMBER_OF_JOINTS], vctDoubleVec & motors) const;
+
+    // Tip pose for joint values, without cache
+    void ForwardKinematics(const double joints[NUMBER_OF_JOINTS], double rotation[3][3], double position[3]) const;
+
+    // Joint values for the goal, starting from joints (warm start) and
+    // updated in place.  budget (s) overrides the configured budget if
+    // positive, 0 to only use the maximum number of iterations.
+    Status InverseKinematics(const vctFrm3 & goal, double joints[NUMBER_OF_JOINTS],
+                             unsigned int & iterations, double & residual, double budget = -1.0) const;
+
+protected:
+    // Snake rotation and tip position (tool included) in the roll frame
+    void Snake(double pitch, double yaw, double rotation[3][3], double position[3]) const;
+
+    bool mEnabled;
+    std::string mBaseFrame;
+    std::string mTipFrame;
+    int mAxis[NUMBER_OF_JOINTS];            // -1 if not actuated
+    double mScale[NUMBER_OF_JOINTS];
+    double mSnakeLength;
+    double mToolLength;
+    double mTolerance;
+
+    // Inverse kinematics
+    double mIKBudget;
+    unsigned int mIKMaxIterations;
+    double mIKTolerance;
+    double mIKDamping;
+    double mIKOrientationWeight;
+
+    // Cache
+    bool mValid;
+    double mJoints[NUMBER_OF_JOINTS];       // Joints of the cached terms
+    double mSnakeRotation[3][3];
+    double mSnakePosition[3];
+    double mRollCos, mRollSin;
+};
+
+#endif
@@ -0,0 +1,69 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+
+  (C) Copyright 2025 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsMaxonEPOSLatencyHistogram_h
+#define _mtsMaxonEPOSLatencyHistogram_h
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Always include last
+#include <sawMaxonEPOS/sawMaxonEPOSExport.h>
+
+// Latency histograms, one per (key, column) cell, e.g. call type and axis.
+//
+// Buckets are logarithmic, 4 per power of 2 starting at 1 us (so the
+// relative error is below 25%); bucket 0 is below 1 us and the last bucket
+// everything above ~8 s.
+// Record is lock free and doesn't allocate, so it can be called from the
+// polling threads while another thread reads the statistics.  Percentiles
+// are reported as the upper bound of the bucket (capped by the maximum).
+class CISST_EXPORT mtsMaxonEPOSLatencyHistogram
+{
+public:
+
+    enum { SUB_BUCKETS = 4, NUMBER_OF_BUCKETS = 1 + 23 * SUB_BUCKETS };
+
+    mtsMaxonEPOSLatencyHistogram();
+
+    // Allocate and reset all cells
+    void SetSize(size_t numberOfKeys, size_t numberOfColumns);
+    size_t NumberOfKeys(void) const { return mNumberOfKeys; }
+    size_t NumberOfColumns(void) const { return mNumberOfColumns; }
+
+    void Record(size_t key, size_t column, double seconds);
+    void Reset(void);
+
+    // Statistics for one cell, times in seconds
+    void GetStatistics(size_t key, size_t column, unsigned long long & count,
+                       double & p50, double & p99, double & max) const;
+
+protected:
+    struct Cell {
+        std::atomic<unsigned int> buckets[NUMBER_OF_BUCKETS];
+        std::atomic<unsigned long long> maxNanoseconds;
+    };
+
+    static double BucketUpperBound(size_t bucket);
+
+    size_t mNumberOfKeys;
+    size_t mNumberOfColumns;
+    std::unique_ptr<Cell[]> mCells;
+};
+
+#endif
@@ -0,0 +1,135 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+
+  (C) Copyright 2025 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsMaxonEPOSObjectDictionary_h
+#define _mtsMaxonEPOSObjectDictionary_h
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+
+#include <sawMaxonEPOS/mtsMaxonEPOSDriver.h>
+
+// Always include last
+#include <sawMaxonEPOS/sawMaxonEPOSExport.h>
+
+// Object dictionary access (SDO) with a per node cache, for parameters
+// that don't change while the component runs (encoder resolution, gear
+// ratio, motor data...) or that are only changed by the component.
+//
+// Values are numeric objects of 1 to 4 bytes.  Read only uses the bus if
+// the value isn't cached.  Set only updates the cache and marks the entry
+// dirty if the value differs from the node's value, Flush writes the dirty
+// entries; Write does both for one object.  Batched versions take a list
+// of objects.
+//
+// Static objects can also be kept in a file, keyed by the node serial
+// number (0x1018:04), so the next startup only reads the serial number of
+// nodes already known.  The file has to be removed if the drives are
+// reconfigured by another program (e.g. EPOS Studio).
+//
+// Not thread safe, meant to be used from the component's thread.
+class CISST_EXPORT mtsMaxonEPOSObjectDictionary
+{
+public:
+
+    struct Object {
+        std::string    name;
+        unsigned short index;
+        unsigned char  subIndex;
+        unsigned char  size;            // bytes, 1 to 4
+    };
+
+    // {"name": "max_following_error", "index": "0x6065", "subindex": 0, "size": 4},
+    // index and subindex can be numbers or strings (e.g. hexadecimal)
+    static bool ObjectFromJSON(const Json::Value & jsonObject, Object & object, std::string & error);
+    // "6065.00" style, used as key in the cache file
+    static std::string ObjectKey(const Object & object);
+
+    mtsMaxonEPOSObjectDictionary();
+
+    void Configure(mtsMaxonEPOSDriver * driver, size_t numberOfNodes);
+    void SetNode(size_t node, void * handle, unsigned short nodeId);
+
+    // Cached read, value is zero extended
+    bool Read(size_t node, const Object & object, unsigned int & value, unsigned int & errorCode);
+    // Read all the objects, stops at the first error
+    bool Read(size_t node, const std::vector<Object> & objects, std::vector<unsigned int> & values,
+              unsigned int & errorCode);
+
+    // Change the cached value, written by Flush if different from the node's value
+    void Set(size_t node, const Object & object, unsigned int value);
+    bool Flush(size_t node, unsigned int & errorCode);
+    bool IsDirty(size_t node) const;
+
+    // Set and write if needed (other dirty entries are not written)
+    bool Write(size_t node, const Object & object, unsigned int value, unsigned int & errorCode);
+    bool Write(size_t node, const std::vector<Object> & objects, const std::vector<unsigned int> & values,
+               unsigned int & errorCode);
+
+    // Forget the values read or written, e.g. after a node reset (dirty
+    // entries are kept)
+    void Invalidate(size_t node);
+
+    // File cache of the static objects.  LoadCache reads the file,
+    // Identify reads the node serial number and fills the node cache with
+    // the values found in the file for it.  UpdateCache copies the cached
+    // values of the static objects of each identified node and SaveCache
+    // writes the file if anything changed.
+    bool LoadCache(const std::string & fileName, std::string & error);
+    bool Identify(size_t node, unsigned int & errorCode);
+    void UpdateCache(const std::vector<Object> & staticObjects);
+    bool SaveCache(const std::string & fileName, std::string & error);
+
+    // Statistics
+    unsigned long long NumberOfReads(void) const { return mNumberOfReads; }
+    unsigned long long NumberOfWrites(void) const { return mNumberOfWrites; }
+    unsigned long long NumberOfHits(void) const { return mNumberOfHits; }
+
+protected:
+    struct Entry {
+        unsigned int value;
+        unsigned char size;             // bytes
+        bool valid;                     // value is the node's value
+        bool dirty;                     // value must be written
+    };
+
+    struct Node {
+        void * handle;
+        unsigned short nodeId;
+        bool identified;
+        unsigned int serialNumber;
+        std::map<unsigned int, Entry> entries;  // index << 8 | subindex
+    };
+
+    static unsigned int EntryKey(const Object & object) {
+        return (static_cast<unsigned int>(object.index) << 8) | object.subIndex;
+    }
+    bool WriteEntry(Node & node, unsigned int key, Entry & entry, unsigned int & errorCode);
+
+    mtsMaxonEPOSDriver * mDriver;
+    std::vector<Node> mNodes;
+    Json::Value mCache;                 // serial number -> object key -> value
+    bool mCacheModified;
+    unsigned long long mNumberOfReads;
+    unsigned long long mNumberOfWrites;
+    unsigned long long mNumberOfHits;
+};
+
+#endif
@@ -0,0 +1,71 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+
+  (C) Copyright 2025 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsMaxonEPOSPoller_h
+#define _mtsMaxonEPOSPoller_h
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Always include last
+#include <sawMaxonEPOS/sawMaxonEPOSExport.h>
+
+// Executes groups of jobs concurrently, one persistent worker thread per
+// group.  The calling thread executes the first group itself and then
+// waits for the other groups, so Execute returns once all jobs are done.
+// Jobs within a group are executed sequentially, in order.
+class CISST_EXPORT mtsMaxonEPOSPoller
+{
+public:
+
+    typedef std::function<void (size_t job)> JobFunction;
+
+    mtsMaxonEPOSPoller();
+    ~mtsMaxonEPOSPoller();
+
+    // Set the groups of jobs and the function executing a job; stops the
+    // current workers if any.  Workers are started with Start.
+    void Configure(const std::vector<std::vector<size_t> > & groups, const JobFunction & function);
+    void Start(void);
+    void Stop(void);
+
+    size_t NumberOfGroups(void) const { return mGroups.size(); }
+
+    // Execute all jobs, returns the time (in seconds) spent waiting for
+    // the worker threads after the calling thread completed its own group
+    double Execute(void);
+
+protected:
+    void Worker(size_t group, unsigned long long generation);
+    void ExecuteGroup(size_t group);
+
+    std::vector<std::vector<size_t> > mGroups;
+    JobFunction mFunction;
+    std::vector<std::thread> mThreads;
+
+    std::mutex mMutex;
+    std::condition_variable mStartCondition;
+    std::condition_variable mDoneCondition;
+    unsigned long long mGeneration;   // incremented for each Execute
+    size_t mPending;                  // worker groups not completed yet
+    bool mStopRequested;
+};
+
+#endif
@@ -0,0 +1,87 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+
+  (C) Copyright 2025 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsMaxonEPOSRealTime_h
+#define _mtsMaxonEPOSRealTime_h
+
+#include <cstdint>
+#include <string>
+
+#include <cisstCommon/cmnPortability.h>
+#include <cisstVector/vctDynamicVectorTypes.h>
+
+// Always include last
+#include <sawMaxonEPOS/sawMaxonEPOSExport.h>
+
+// Periodic execution of a continuous task: WaitForNextPeriod sleeps until
+// an absolute deadline (clock_nanosleep on CLOCK_MONOTONIC on Linux), so
+// the period doesn't drift with the time spent in each cycle.  The wake up
+// jitter (time after the deadline) is recorded in a histogram with linear
+// buckets, the last bucket holds everything above.  When a cycle takes
+// longer than the period, it counts as an overrun and the missed deadlines
+// are skipped instead of running the next cycles back to back.
+//
+// SetupThread optionally sets the SCHED_FIFO priority, CPU affinity and
+// locks the process memory (mlockall); these are only available on Linux.
+class CISST_EXPORT mtsMaxonEPOSRealTime
+{
+public:
+
+    mtsMaxonEPOSRealTime();
+
+    // period (s), 0 to run continuously; priority: SCHED_FIFO priority
+    // (1 to 99), 0 to keep the default scheduler; cpu: core to pin the
+    // thread to, -1 for all
+    void Configure(double period, int priority, int cpu, bool lockMemory,
+                   double bucketWidth, size_t numberOfBuckets);
+    bool IsPeriodic(void) const { return mPeriodNanoseconds > 0; }
+    double Period(void) const { return static_cast<double>(mPeriodNanoseconds) * 1.0e-9; }
+
+    // Apply priority, affinity and memory locking to the calling thread,
+    // returns false with a description of what failed
+    bool SetupThread(std::string & error) const;
+
+    // First deadline is one period from now
+    void Start(void);
+    // Sleep until the next deadline, then record the jitter
+    void WaitForNextPeriod(void);
+
+    // Published in the state table, reset with Reset
+    vctUIntVec & JitterHistogram(void) { return mHistogram; }
+    double & Jitter(void) { return mJitter; }                   // last wake up jitter (s)
+    double & MaxJitter(void) { return mMaxJitter; }
+    unsigned int & Overruns(void) { return mOverruns; }
+    void Reset(void);
+
+protected:
+    static int64_t Now(void);           // monotonic clock, ns
+    static void SleepUntil(int64_t deadline);
+
+    int64_t mPeriodNanoseconds;
+    int mPriority;
+    int mCPU;
+    bool mLockMemory;
+    double mBucketWidth;                // s
+    int64_t mDeadline;                  // ns
+
+    vctUIntVec mHistogram;
+    double mJitter;
+    double mMaxJitter;
+    unsigned int mOverruns;
+};
+
+#endif
@@ -0,0 +1,89 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+
+  (C) Copyright 2025 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsMaxonEPOSTrajectoryFile_h
+#define _mtsMaxonEPOSTrajectoryFile_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <cisstCommon/cmnPortability.h>
+
+// Always include last
+#include <sawMaxonEPOS/sawMaxonEPOSExport.h>
+
+// Read only, memory mapped joint trajectory.  The file is never loaded in
+// memory, pages are read on demand; Prefetch asks the OS to read ahead of
+// the current point and to release the pages already played so long
+// trajectories (GB) can be streamed with a constant memory footprint.
+//
+// File format (little endian):
+//   char[8]   "EPOSTJ01"
+//   uint32    number of axes
+//   uint32    reserved, 0
+//   uint64    number of points
+//   points:   double time (s, increasing), double position per axis
+class CISST_EXPORT mtsMaxonEPOSTrajectoryFile
+{
+public:
+
+    mtsMaxonEPOSTrajectoryFile();
+    ~mtsMaxonEPOSTrajectoryFile();
+
+    // Map fileName, returns false and sets error if the file can't be
+    // used.  A previously opened file is closed first.
+    bool Open(const std::string & fileName, std::string & error);
+    void Close(void);
+    bool IsOpen(void) const { return mData != nullptr; }
+
+    size_t NumberOfAxes(void) const { return mNumberOfAxes; }
+    size_t NumberOfPoints(void) const { return mNumberOfPoints; }
+
+    double Time(size_t point) const { return Point(point)[0]; }
+    const double * Positions(size_t point) const { return Point(point) + 1; }
+    double StartTime(void) const { return Time(0); }
+    double EndTime(void) const { return Time(mNumberOfPoints - 1); }
+
+    // Last point with Time(point) <= time (0 if time is before the first
+    // point), binary search
+    size_t Find(double time) const;
+
+    // Read ahead of point and release pages before it, only issues system
+    // calls when point crosses a chunk boundary
+    void Prefetch(size_t point);
+
+protected:
+    const double * Point(size_t point) const {
+        return reinterpret_cast<const double *>(mData + HEADER_SIZE + point * mPointSize);
+    }
+
+    enum { HEADER_SIZE = 24 };
+
+    const unsigned char * mData;
+    size_t mSize;                       // bytes mapped
+    size_t mNumberOfAxes;
+    size_t mNumberOfPoints;
+    size_t mPointSize;                  // bytes
+    size_t mPrefetchChunk;              // last chunk prefetched
+#if (CISST_OS == CISST_WINDOWS)
+    void * mFile;
+    void * mMapping;
+#endif
+};
+
+#endif
@@ -0,0 +1,78 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+
+  (C) Copyright 2025 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsMaxonEPOSTrajectoryGenerator_h
+#define _mtsMaxonEPOSTrajectoryGenerator_h
+
+#include <cstddef>
+#include <vector>
+
+// Always include last
+#include <sawMaxonEPOS/sawMaxonEPOSExport.h>
+
+// Online jerk limited trajectory generator, one independent profile per
+// axis.  Each Update plans from the current position, velocity and
+// acceleration, so the goal can change at any time (e.g. sparse goals
+// sent by a client) and the setpoints stay smooth.  The velocity target
+// is the largest one that can still stop at the goal with the
+// acceleration and jerk limits, and the acceleration is shaped so it
+// reaches 0 when the velocity reaches its target.  Being discrete, the
+// profile can overshoot the goal by a fraction of the distance covered in
+// one cycle at full deceleration.
+class CISST_EXPORT mtsMaxonEPOSTrajectoryGenerator
+{
+public:
+
+    mtsMaxonEPOSTrajectoryGenerator();
+
+    void Configure(size_t numberOfAxes);
+
+    // Limits in units/s, units/s^2 and units/s^3, must be positive
+    void SetLimits(size_t axis, double velocity, double acceleration, double jerk);
+
+    // Restart from position, at rest
+    void Reset(size_t axis, double position);
+    void SetGoal(size_t axis, double goal);
+
+    // Advance all axes by dt (s), returns true if all axes are at rest on their goal
+    bool Update(double dt);
+
+    double Position(size_t axis) const { return mAxes[axis].position; }
+    double Velocity(size_t axis) const { return mAxes[axis].velocity; }
+    double Acceleration(size_t axis) const { return mAxes[axis].acceleration; }
+    double Goal(size_t axis) const { return mAxes[axis].goal; }
+
+protected:
+    struct AxisState {
+        double goal;
+        double position;
+        double velocity;
+        double acceleration;
+        double maxVelocity;
+        double maxAcceleration;
+        double maxJerk;
+    };
+
+    // Largest speed that can stop (at zero acceleration) within distance
+    static double BrakingVelocity(const AxisState & state, double distance);
+    // Returns true if at rest on the goal
+    static bool Step(AxisState & state, double dt);
+
+    std::vector<AxisState> mAxes;
+};
+
+#endif
@@ -0,0 +1,75 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s): Haochen Wei, Peter Kazanzides, Anton Deguet
+
+  (C) Copyright 2025 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsMaxonEPOSVelocityEstimator_h
+#define _mtsMaxonEPOSVelocityEstimator_h
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Always include last
+#include <sawMaxonEPOS/sawMaxonEPOSExport.h>
+
+// Joint velocity estimated on the host from the position samples and
+// their timestamps, so no extra read is needed on the bus.  Two
+// estimators are available:
+//   FILTER: finite difference followed by a first order low pass filter
+//   KALMAN: constant velocity Kalman filter (state position and velocity)
+// Samples don't need to be evenly spaced (e.g. with read rates or
+// polling jitter), each update uses the actual time between samples.
+class CISST_EXPORT mtsMaxonEPOSVelocityEstimator
+{
+public:
+
+    enum Type { FILTER, KALMAN };
+
+    mtsMaxonEPOSVelocityEstimator();
+
+    // cutoff: low pass filter cutoff frequency (Hz), for FILTER
+    // processNoise: acceleration noise spectral density ((units/s^2)^2/Hz), for KALMAN
+    // measurementNoise: position measurement variance (units^2), for KALMAN
+    void Configure(size_t numberOfAxes, Type type, double cutoff,
+                   double processNoise, double measurementNoise);
+
+    // Restart from the next sample, e.g. after a gap in the samples
+    void Reset(size_t axis);
+
+    // New position sample at time (s), returns the velocity estimate
+    double Update(size_t axis, double position, double time);
+    double Velocity(size_t axis) const { return mAxes[axis].velocity; }
+
+    // Name used in configuration files, "filter" or "kalman"
+    static bool TypeFromString(const std::string & name, Type & type);
+
+protected:
+    struct AxisState {
+        bool   initialized;
+        double time;
+        double position;                // last sample (FILTER) or estimate (KALMAN)
+        double velocity;
+        double covariance[2][2];        // KALMAN only
+    };
+
+    Type mType;
+    double mCutoff;
+    double mProcessNoise;
+    double mMeasurementNoise;
+    std::vector<AxisState> mAxes;
+};
+
+#endif
@@ -36,13 +36,14 @@ private:
     std::ofstream file; 
 
     size_t NumAxes;
-    vctDoubleVec jtpgoal, jtvgoal;
+    vctDoubleVec jtpgoal, jtvgoal, jtfgoal;
     vctDoubleVec jtpos, jtvel;
 
     prmStateJoint m_measured_js;
     prmStateJoint m_setpoint_js;
     prmPositionJointSet jtposSet;
     prmVelocityJointSet jtvelSet;
+    prmForceTorqueJointSet jtfSet;
     prmOperatingState m_op_state;
     prmActuatorState m_ActuatorState;
 
@@ -52,8 +53,12 @@ private:
     mtsFunctionRead GetActuatorState;
     mtsFunctionWrite servo_jp;
     mtsFunctionWrite move_jp;
+    mtsFunctionWrite interpolate_jp;
     mtsFunctionWrite servo_jv;
+    mtsFunctionWrite servo_jf;
     mtsFunctionWrite state_command;
+    mtsFunctionWrite playback_load;
+    mtsFunctionVoid playback_play;
 
     mtsFunctionRead period_statistics;
     mtsIntervalStatistics period_stats;
@@ -80,8 +85,12 @@ public:
             req->AddFunction("GetActuatorState", GetActuatorState);
             req->AddFunction("servo_jp", servo_jp);
             req->AddFunction("move_jp", move_jp);
+            req->AddFunction("interpolate_jp", interpolate_jp);
             req->AddFunction("servo_jv", servo_jv);
+            req->AddFunction("servo_jf", servo_jf);
             req->AddFunction("state_command", state_command);
+            req->AddFunction("playback_load", playback_load);
+            req->AddFunction("playback_play", playback_play);
             req->AddFunction("period_statistics", period_statistics);
         }
     }
@@ -101,7 +110,9 @@ public:
                   << "  m: position move joints (servo_jp)" << std::endl
                   << "  p: profile move joints (move_jr)" << std::endl
                   << "  v: velocity move joints (servo_jv)" << std::endl
-                  << "  c: script move" << std::endl
+                  << "  f: motor currents (servo_jf)" << std::endl
+                  << "  c: script move (interpolate_jp)" << std::endl
+                  << "  t: trajectory playback (binary trajectory file)" << std::endl
                   << "  s: stop move (hold)" << std::endl
                   << "  h: display help information" << std::endl
                   << "  e: enable motor power" << std::endl
@@ -124,9 +135,11 @@ public:
 
         jtpgoal.SetSize(NumAxes);
         jtvgoal.SetSize(NumAxes);
+        jtfgoal.SetSize(NumAxes);
         
         jtposSet.Goal().SetSize(NumAxes);
         jtvelSet.SetSize(NumAxes);
+        jtfSet.SetSize(NumAxes);
         PrintHelp();
     }
 
@@ -172,6 +185,14 @@ public:
                 jtvelSet.SetGoal(jtvgoal);
                 servo_jv(jtvelSet);
                 break;
+
+            case 'f':   // current mode
+                std::cout << std::endl << "Enter motor currents (mA): ";
+                for (i = 0; i < NumAxes; i++)
+                    std::cin >> jtfgoal[i];
+                jtfSet.SetForceTorque(jtfgoal);
+                servo_jf(jtfSet);
+                break;
             
             case 'c':   // velocity move joint
                 std::cout << std::endl << "Move with input script";
@@ -203,7 +224,7 @@ public:
                     printf("POS: [");
                     for (i = 0; i < jtpos.size(); i++)
                         printf(" %7.2lf ", jtpos[i]);
-                    printf("] CURRENT: [");
+                    printf("] VELOCITY: [");
                     for (i = 0; i < jtvel.size(); i++)
                         printf(" %7.2lf ", jtvel[i]);
                     printf("]\r");
@@ -228,13 +249,24 @@ public:
 
                     std::cout << "Moving to " << jtpgoal << std::endl;
                     jtposSet.SetGoal(jtpgoal);
-                    servo_jp(jtposSet);
+                    // sparse goals, smoothed by the server
+                    interpolate_jp(jtposSet);
                     
                 }
                 file.close();
                 std::cout << "Script finished" << std::endl;
                 break;
             
+            case 't':   // trajectory playback, setpoints sent by the server
+                {
+                    std::string trajectoryFile;
+                    std::cout << std::endl << "Enter trajectory file: ";
+                    std::cin >> trajectoryFile;
+                    playback_load(trajectoryFile);
+                    playback_play();
+                }
+                break;
+
             case 's':   // stop move (hold)
                 state_command(std::string("pause"));
                 std::cout << " System pause" << std::endl;